@@ -111,6 +111,7 @@ void RestoreCrashHandlers()
 
 // TODO: Remove and allow auto-init post-load
 namespace NWNXLib::POS { void InitializeHooks(); }
+namespace NWNXLib::TwoDA { void InitializeHooks(); }
 namespace NWNXLib::Tasks {
     void StartAsyncWorkers();
     void StopAsyncWorkers();
@@ -212,6 +213,7 @@ void NWNXCore::InitialSetupHooks()
     m_mainLoopInternalHook = Hooks::HookFunction(&CServerExoAppInternal::MainLoop, &MainLoopInternalHandler, Hooks::Order::Final);
 
     POS::InitializeHooks();
+    TwoDA::InitializeHooks();
 
     static Hooks::Hook loadModuleInProgressHook = Hooks::HookFunction(&CNWSModule::LoadModuleInProgress,
             +[](CNWSModule *pModule, int32_t nAreasLoaded, int32_t nAreasToLoad) -> uint32_t
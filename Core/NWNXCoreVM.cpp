@@ -15,7 +15,10 @@
 #include "API/CNWSObject.hpp"
 
 #include <cstring>
+#include <memory>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
@@ -33,40 +36,96 @@ struct Command
 
 static const int  NWNX_ABI_VERSION = 2;
 
-std::optional<Command> ProcessNWNX(const CExoString& str)
+// NWNX calls come in as the same few hundred constant strings over and over, so each
+// distinct one is parsed once and remembered here. Keys view into the owned copy.
+struct Symbol
 {
-    auto startsWith = [](const CExoString& str, const char *prefix) -> bool
-    {
-        auto len = std::strlen(prefix);
-        return str.m_sString && str.m_nBufferLength >= len && std::strncmp(prefix, str.m_sString, len) == 0;
-    };
+    std::string name;
+    std::optional<Command> cmd;
+};
+static std::unordered_map<std::string_view, std::unique_ptr<Symbol>> s_symbols;
+// Anything past this is almost certainly generated at runtime; parse it but don't keep it.
+static constexpr size_t MaxSymbols = 4096;
+
+// What ProcessNWNX() found. Cached symbols are borrowed, uncached ones are owned by the caller's
+// frame so a nested NWNX call can't pull them out from under it.
+class ParsedCall
+{
+public:
+    ParsedCall() = default;
+    explicit ParsedCall(const Command *cmd) : m_cmd(cmd) {}
+    explicit ParsedCall(Command&& cmd) : m_owned(std::move(cmd)) {}
+
+    explicit operator bool() const { return m_cmd || m_owned; }
+    const Command* operator->() const { return m_owned ? &*m_owned : m_cmd; }
+
+private:
+    const Command *m_cmd = nullptr;
+    std::optional<Command> m_owned;
+};
+
+static std::optional<Command> ParseNWNX(const CExoString& str)
+{
+    int abi;
+    char plugin[256];
+    char event[256];
+    char operation[256];
+
+    int scanned = std::sscanf(str.m_sString,
+                        "NWNXEE!ABIv%d!%255[A-Za-z0-9_]!%255[A-Za-z0-9_]!%255[A-Za-z0-9_]",
+                        &abi, plugin, event, operation);
+
+    if (scanned < 4 || abi != NWNX_ABI_VERSION)
+        return std::optional<Command>();
+
+    Command cmd;
+    cmd.plugin    = plugin;
+    cmd.event     = event;
+    cmd.operation = operation;
+    return std::make_optional<>(cmd);
+}
+
+// Returns nothing for everything that isn't a valid NWNX call. This runs for every
+// local variable access, so plain variable names must get out on the first byte.
+ParsedCall ProcessNWNX(const CExoString& str)
+{
+    if (!str.m_sString || str.m_sString[0] != 'N')
+        return {};
 
-    if (startsWith(str, "NWNXEE!"))
+    const std::string_view name(str.m_sString);
+    if (name.compare(0, 7, "NWNXEE!") == 0)
     {
-        int abi;
-        char plugin[256];
-        char event[256];
-        char operation[256];
+        auto it = s_symbols.find(name);
+        const Symbol *symbol = it != s_symbols.end() ? it->second.get() : nullptr;
+        std::optional<Command> uncached;
 
-        int scanned = std::sscanf(str.m_sString,
-                            "NWNXEE!ABIv%d!%255[A-Za-z0-9_]!%255[A-Za-z0-9_]!%255[A-Za-z0-9_]",
-                            &abi, plugin, event, operation);
+        if (!symbol)
+        {
+            auto owned = std::make_unique<Symbol>();
+            owned->name = name;
+            owned->cmd = ParseNWNX(str);
 
-        if (scanned < 4 || abi != NWNX_ABI_VERSION)
+            if (s_symbols.size() < MaxSymbols)
+            {
+                symbol = owned.get();
+                s_symbols.emplace(std::string_view(owned->name), std::move(owned));
+            }
+            else
+            {
+                uncached = std::move(owned->cmd);
+            }
+        }
+
+        if (symbol ? !symbol->cmd : !uncached)
         {
             LOG_WARNING("Bad NWNX ABI call detected: \"%s\" from %s.nss - ignored", str, Utils::GetCurrentScript());
             LOG_WARNING("NWNX ABI has changed. Please update your \"nwnx.nss\" file and recompile all scripts.");
+            return {};
         }
-        else
-        {
-            Command cmd;
-            cmd.plugin    = plugin;
-            cmd.event     = event;
-            cmd.operation = operation;
-            return std::make_optional<>(cmd);
-        }
+
+        return symbol ? ParsedCall(&*symbol->cmd) : ParsedCall(std::move(*uncached));
     }
-    else if (startsWith(str, "NWNX!"))
+    else if (name.compare(0, 5, "NWNX!") == 0)
     {
         LOG_NOTICE("Legacy NWNX call detected: \"%s\" from %s.nss - ignored", str, Utils::GetCurrentScript());
         const char *cmd = str.m_sString + 5;
@@ -82,7 +141,7 @@ std::optional<Command> ProcessNWNX(const CExoString& str)
         }
     }
 
-    return std::optional<Command>();
+    return {};
 }
 
 }
@@ -0,0 +1,160 @@
+#include "nwnx.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string.h>
+
+namespace NWNXLib::Compression {
+
+// A greedy LZ4 block compressor. It trades some ratio for speed, which is what we
+// want for serialized objects: GFF is very repetitive and finds matches easily.
+static constexpr size_t MinMatch = 4;
+// The format requires the last 5 bytes to be literals and the last match to start
+// at least 12 bytes before the end of the input.
+static constexpr size_t LastLiterals = 5;
+static constexpr size_t MatchLimit = 12;
+static constexpr size_t MaxOffset = 65535;
+static constexpr uint32_t HashBits = 12;
+
+static uint32_t Read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t Hash(uint32_t seq)
+{
+    return (seq * 2654435761u) >> (32 - HashBits);
+}
+
+static void WriteLength(std::vector<uint8_t>& out, size_t len)
+{
+    for (len -= 15; len >= 255; len -= 255)
+        out.push_back(255);
+    out.push_back(static_cast<uint8_t>(len));
+}
+
+static void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLen, size_t offset, size_t matchLen)
+{
+    const size_t matchCode = matchLen ? matchLen - MinMatch : 0;
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(literalLen, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLen >= 15)
+        WriteLength(out, literalLen);
+    if (literalLen)
+        out.insert(out.end(), literals, literals + literalLen);
+
+    // The last sequence is literals only.
+    if (!matchLen)
+        return;
+
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15)
+        WriteLength(out, matchCode);
+}
+
+void CompressLZ4(const uint8_t* in, size_t len, std::vector<uint8_t>& out)
+{
+    out.reserve(out.size() + len + len / 255 + 16);
+
+    size_t anchor = 0;
+    if (len > MatchLimit)
+    {
+        std::array<uint32_t, 1 << HashBits> table{};
+        const size_t matchStartLimit = len - MatchLimit;
+        const size_t matchEndLimit = len - LastLiterals;
+
+        size_t ip = 0;
+        while (ip < matchStartLimit)
+        {
+            const uint32_t seq = Read32(in + ip);
+            auto& slot = table[Hash(seq)];
+            size_t ref = slot;
+            slot = static_cast<uint32_t>(ip);
+
+            if (ref >= ip || ip - ref > MaxOffset || Read32(in + ref) != seq)
+            {
+                // Skip ahead faster the longer we go without finding anything.
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            size_t end = ip + MinMatch;
+            while (end < matchEndLimit && in[end] == in[ref + end - ip])
+                end++;
+            while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+            {
+                ip--;
+                ref--;
+            }
+
+            WriteSequence(out, in + anchor, ip - anchor, ip - ref, end - ip);
+            ip = anchor = end;
+        }
+    }
+
+    WriteSequence(out, in + anchor, len - anchor, 0, 0);
+}
+
+static bool ReadLength(const uint8_t* in, size_t len, size_t& ip, size_t& value)
+{
+    uint8_t b;
+    do
+    {
+        if (ip >= len)
+            return false;
+        b = in[ip++];
+        value += b;
+    } while (b == 255);
+    return true;
+}
+
+bool DecompressLZ4(const uint8_t* in, size_t len, uint8_t* out, size_t outLen)
+{
+    size_t ip = 0, op = 0;
+    while (ip < len)
+    {
+        const uint8_t token = in[ip++];
+
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !ReadLength(in, len, ip, literalLen))
+            return false;
+        if (literalLen > len - ip || literalLen > outLen - op)
+            return false;
+        if (literalLen)
+            memcpy(out + op, in + ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        if (ip == len)
+            break;
+
+        if (len - ip < 2)
+            return false;
+        const size_t offset = in[ip] | (in[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+            return false;
+
+        size_t matchLen = token & 0xF;
+        if (matchLen == 15 && !ReadLength(in, len, ip, matchLen))
+            return false;
+        matchLen += MinMatch;
+        if (matchLen > outLen - op)
+            return false;
+
+        // Matches may overlap the bytes they produce, so copy forwards one at a time.
+        const uint8_t* ref = out + op - offset;
+        if (offset >= matchLen)
+            memcpy(out + op, ref, matchLen);
+        else
+            for (size_t i = 0; i < matchLen; i++)
+                out[op + i] = ref[i];
+        op += matchLen;
+    }
+
+    return op == outLen;
+}
+
+}
@@ -1,5 +1,6 @@
 #include "nwnx.hpp"
 
+#include <array>
 #include <string>
 #include <string.h>
 #include <algorithm>
@@ -220,64 +221,94 @@ std::string FromUTF8(const std::string& str, Locale locale)
 }
 
 static const char base64_key[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-std::string ToBase64(const std::vector<uint8_t>& in)
-{
-    std::string out;
-    out.reserve(4*in.size()/3 + 4);
 
-    int val = 0, valb = -6;
-    for (uint8_t c : in)
+// Every 12 bit value mapped to its two output characters, so each 3 byte group
+// takes two lookups instead of four shifts and masks per character.
+static const std::array<char[2], 4096> s_base64Pairs = []
+{
+    std::array<char[2], 4096> pairs{};
+    for (size_t i = 0; i < pairs.size(); i++)
     {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0)
-        {
-            out.push_back(base64_key[(val>>valb)&0x3F]);
-            valb-=6;
-        }
+        pairs[i][0] = base64_key[i >> 6];
+        pairs[i][1] = base64_key[i & 0x3F];
     }
+    return pairs;
+}();
+
+// Maps characters back to their 6 bit value, -1 for anything else.
+static const std::array<int8_t, 256> s_base64Values = []
+{
+    std::array<int8_t, 256> values{};
+    values.fill(-1);
+    for (int8_t i = 0; i < 64; i++)
+        values[static_cast<uint8_t>(base64_key[i])] = i;
+    return values;
+}();
+
+void ToBase64(const uint8_t* in, size_t len, std::string& out)
+{
+    out.resize(4 * ((len + 2) / 3));
+    char* o = out.data();
 
-    if (valb > -6)
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3)
     {
-        out.push_back(base64_key[((val<<8)>>(valb+8))&0x3F]);
+        const uint32_t v = (uint32_t(in[i]) << 16) | (uint32_t(in[i+1]) << 8) | in[i+2];
+        memcpy(o, s_base64Pairs[v >> 12], 2);
+        memcpy(o + 2, s_base64Pairs[v & 0xFFF], 2);
+        o += 4;
     }
-    while (out.size()%4)
+
+    if (const size_t rest = len - i)
     {
-        out.push_back('=');
+        const uint32_t v = (uint32_t(in[i]) << 16) | (rest == 2 ? uint32_t(in[i+1]) << 8 : 0);
+        o[0] = base64_key[v >> 18];
+        o[1] = base64_key[(v >> 12) & 0x3F];
+        o[2] = rest == 2 ? base64_key[(v >> 6) & 0x3F] : '=';
+        o[3] = '=';
     }
-    return out;
 }
 
-std::vector<uint8_t> FromBase64(const std::string &in)
+std::string ToBase64(const std::vector<uint8_t>& in)
 {
-    std::vector<uint8_t> out;
-    out.reserve(3*in.length()/4 + 4);
+    std::string out;
+    ToBase64(in.data(), in.size(), out);
+    return out;
+}
 
-    static int Table[256];
-    if (Table['+'] == 0)
-    {
-        memset(Table, 0xFF, sizeof(Table));
-        for (int i = 0; i < 64; i++)
-            Table[(uint8_t)(base64_key[i])] = i;
-    }
+void FromBase64(const char* in, size_t len, std::vector<uint8_t>& out)
+{
+    out.resize(3 * (len / 4) + 3);
+    uint8_t* o = out.data();
 
-    int val = 0, valb = -8;
-    for (char c : in)
+    uint32_t val = 0;
+    int valb = -8;
+    for (size_t i = 0; i < len; i++)
     {
+        const char c = in[i];
         // Ignoring whitespace is conveniently in-spec: Sometimes,
         // base64 is broken up in 78-column chunks.
         if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
             continue;
-        if (Table[(uint8_t)c] == -1)
+        const int8_t v = s_base64Values[static_cast<uint8_t>(c)];
+        if (v == -1)
             break;
-        val = (val<<6) + Table[(uint8_t)c];
+        val = (val << 6) | uint32_t(v);
         valb += 6;
-        if (valb>=0)
+        if (valb >= 0)
         {
-            out.push_back(uint8_t((val>>valb)&0xFF));
+            *o++ = uint8_t((val >> valb) & 0xFF);
             valb -= 8;
         }
     }
+
+    out.resize(static_cast<size_t>(o - out.data()));
+}
+
+std::vector<uint8_t> FromBase64(const std::string &in)
+{
+    std::vector<uint8_t> out;
+    FromBase64(in.data(), in.size(), out);
     return out;
 }
 
@@ -20,6 +20,12 @@ namespace NWNXLib::POS
 {
 static char GffFieldName[] = "NWNX_POS";
 
+static std::vector<CleanupFunc>& GetExtensionCleanups()
+{
+    static std::vector<CleanupFunc> s_cleanups;
+    return s_cleanups;
+}
+
 class ObjectStorage
 {
     // TODO maybe pack it up into a a single map?
@@ -57,6 +63,7 @@ public:
     ObjectStorage(ObjectID owner) : m_oidOwner(owner), m_bCloned(false) {}
     ~ObjectStorage()
     {
+        DropExtensions();
         if (m_PointerMap && !m_bCloned)
         {
             for (auto it: *m_PointerMap)
@@ -68,11 +75,24 @@ public:
         }
     }
 
+    void DropExtensions()
+    {
+        auto& cleanups = GetExtensionCleanups();
+        for (size_t i = 0; i < m_Extensions.size(); i++)
+        {
+            if (m_Extensions[i] && cleanups[i])
+                cleanups[i](m_Extensions[i]);
+        }
+        m_Extensions.clear();
+    }
+
     void CloneFrom(ObjectStorage *other)
     {
         if (!other)
             return;
 
+        DropExtensions();
+
         other->m_bCloned = true;
 
         if (other->m_IntMap)
@@ -161,6 +181,7 @@ public:
     }
     void Deserialize(const char *serialized, bool persist = true)
     {
+        DropExtensions();
         if (m_IntMap)     m_IntMap->clear();
         if (m_FloatMap)   m_FloatMap->clear();
         if (m_StringMap)  m_IntMap->clear();
@@ -234,6 +255,8 @@ public:
     std::unique_ptr<FloatMap>   m_FloatMap;
     std::unique_ptr<StringMap>  m_StringMap;
     std::unique_ptr<PointerMap> m_PointerMap;
+    // Indexed by ExtensionId.
+    std::vector<void*>          m_Extensions;
 };
 
 static ObjectStorage* GetObjectStorage(CGameObject *pGameObject)
@@ -287,7 +310,7 @@ template <> std::optional<int> Get<int>(CGameObject *pGameObject, const std::str
     if (auto *pOS = GetObjectStorage(pGameObject))
     {
         auto fullkey = prefix + "!" + key;
-        auto map = pOS->GetIntMap();
+        auto& map = pOS->GetIntMap();
         auto it = map.find(fullkey);
         if (it != map.end())
             return std::make_optional<int>(it->second.first);
@@ -300,7 +323,7 @@ template <> std::optional<float> Get<float>(CGameObject *pGameObject, const std:
     if (auto *pOS = GetObjectStorage(pGameObject))
     {
         auto fullkey = prefix + "!" + key;
-        auto map = pOS->GetFloatMap();
+        auto& map = pOS->GetFloatMap();
         auto it = map.find(fullkey);
         if (it != map.end())
             return std::make_optional<float>(it->second.first);
@@ -313,7 +336,7 @@ template <> std::optional<std::string> Get<std::string>(CGameObject *pGameObject
     if (auto *pOS = GetObjectStorage(pGameObject))
     {
         auto fullkey = prefix + "!" + key;
-        auto map = pOS->GetStringMap();
+        auto& map = pOS->GetStringMap();
         auto it = map.find(fullkey);
         if (it != map.end())
             return std::make_optional<std::string>(it->second.first);
@@ -326,7 +349,7 @@ template <> std::optional<void*> Get<void*>(CGameObject *pGameObject, const std:
     if (auto *pOS = GetObjectStorage(pGameObject))
     {
         auto fullkey = prefix + "!" + key;
-        auto map = pOS->GetPointerMap();
+        auto& map = pOS->GetPointerMap();
         auto it = map.find(fullkey);
         if (it != map.end())
             return std::make_optional<void*>(it->second.first);
@@ -380,6 +403,39 @@ void RemoveRegex(CGameObject *pGameObject, const std::string& prefix, const std:
             Remove(pOS->m_FloatMap);
         if (pOS->m_PointerMap)
             Remove(pOS->m_PointerMap);
+
+        pOS->DropExtensions();
+    }
+}
+
+ExtensionId RegisterExtension(CleanupFunc cleanup)
+{
+    auto& cleanups = GetExtensionCleanups();
+    cleanups.push_back(std::move(cleanup));
+    return static_cast<ExtensionId>(cleanups.size() - 1);
+}
+
+void* GetExtension(CGameObject *pGameObject, ExtensionId id)
+{
+    // A lookup doesn't give the object storage, only SetExtension() does.
+    if (!pGameObject || !pGameObject->m_pNwnxData)
+        return nullptr;
+
+    auto *pOS = static_cast<ObjectStorage*>(pGameObject->m_pNwnxData);
+    return id < pOS->m_Extensions.size() ? pOS->m_Extensions[id] : nullptr;
+}
+
+void SetExtension(CGameObject *pGameObject, ExtensionId id, void *pExtension)
+{
+    if (auto *pOS = GetObjectStorage(pGameObject))
+    {
+        if (id >= pOS->m_Extensions.size())
+            pOS->m_Extensions.resize(id + 1);
+
+        auto& cleanup = GetExtensionCleanups()[id];
+        if (pOS->m_Extensions[id] && cleanup)
+            cleanup(pOS->m_Extensions[id]);
+        pOS->m_Extensions[id] = pExtension;
     }
 }
 
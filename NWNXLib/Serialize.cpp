@@ -12,15 +12,23 @@
 #include "API/CResGFF.hpp"
 #include "API/CResStruct.hpp"
 
+#include <string.h>
+
 namespace NWNXLib::Utils {
 
-std::vector<uint8_t> SerializeGameObject(CGameObject *pObject, bool bStripPCFlags)
+// Compressed objects are stored as the magic, the uncompressed size (uint32, little endian)
+// and then the LZ4 block. A GFF file always starts with its file type, so the two can't be confused.
+static constexpr char CompressedMagic[4] = { 'N', 'X', 'Z', '1' };
+static constexpr size_t CompressedHeaderSize = sizeof(CompressedMagic) + sizeof(uint32_t);
+
+// pData is allocated by the GFF writer and needs to be freed with delete[].
+static void WriteGFF(CGameObject *pObject, bool bStripPCFlags, uint8_t *&pData, int32_t& dataLength)
 {
-    uint8_t *pData = nullptr;
-    int32_t dataLength = 0;
+    pData = nullptr;
+    dataLength = 0;
 
     if (!pObject)
-        return std::vector<uint8_t>();
+        return;
 
     CResGFF    resGff;
     CResStruct resStruct;
@@ -76,25 +84,107 @@ std::vector<uint8_t> SerializeGameObject(CGameObject *pObject, bool bStripPCFlag
             ASSERT_FAIL_MSG("Invalid object type for SerializeGameObject");
             break;
     }
+}
+
+static void Compress(const uint8_t *pData, size_t dataLength, std::vector<uint8_t>& out)
+{
+    out.resize(CompressedHeaderSize);
+    memcpy(out.data(), CompressedMagic, sizeof(CompressedMagic));
+    const uint32_t size = static_cast<uint32_t>(dataLength);
+    for (size_t i = 0; i < sizeof(size); i++)
+        out[sizeof(CompressedMagic) + i] = static_cast<uint8_t>(size >> (8 * i));
 
-    std::vector<uint8_t> serialized(pData, pData+dataLength);
-    delete[] pData;
+    Compression::CompressLZ4(pData, dataLength, out);
+}
+
+bool SerializeGameObject(CGameObject *pObject, std::vector<uint8_t>& out, bool bStripPCFlags, bool bCompress)
+{
+    uint8_t *pData;
+    int32_t dataLength;
+    WriteGFF(pObject, bStripPCFlags, pData, dataLength);
+    SCOPEGUARD(delete[] pData);
+
+    out.clear();
+    if (!pData || dataLength <= 0)
+        return false;
+
+    if (bCompress)
+        Compress(pData, dataLength, out);
+    else
+        out.assign(pData, pData + dataLength);
 
+    return true;
+}
+
+std::vector<uint8_t> SerializeGameObject(CGameObject *pObject, bool bStripPCFlags)
+{
+    std::vector<uint8_t> serialized;
+    SerializeGameObject(pObject, serialized, bStripPCFlags);
     return serialized;
 }
 
-CGameObject *DeserializeGameObject(const std::vector<uint8_t>& serialized)
+bool SerializeGameObjectB64(CGameObject *pObject, std::string& out, bool bStripPCFlags, bool bCompress)
 {
-    if (serialized.size() == 0)
+    uint8_t *pData;
+    int32_t dataLength;
+    WriteGFF(pObject, bStripPCFlags, pData, dataLength);
+    SCOPEGUARD(delete[] pData);
+
+    out.clear();
+    if (!pData || dataLength <= 0)
+        return false;
+
+    if (bCompress)
+    {
+        std::vector<uint8_t> compressed;
+        Compress(pData, dataLength, compressed);
+        String::ToBase64(compressed.data(), compressed.size(), out);
+    }
+    else
+    {
+        // Straight from the GFF writer's buffer, no intermediate copy.
+        String::ToBase64(pData, dataLength, out);
+    }
+
+    return true;
+}
+
+CGameObject *DeserializeGameObject(const uint8_t *serialized, size_t length)
+{
+    if (!serialized || length == 0)
         return nullptr;
 
+    if (length >= CompressedHeaderSize && memcmp(serialized, CompressedMagic, sizeof(CompressedMagic)) == 0)
+    {
+        uint32_t size = 0;
+        for (size_t i = 0; i < sizeof(size); i++)
+            size |= uint32_t(serialized[sizeof(CompressedMagic) + i]) << (8 * i);
+
+        // LZ4 can't do better than about 255:1, anything claiming more is garbage.
+        if (size / 255 > length)
+        {
+            LOG_WARNING("DeserializeGameObject: Corrupt compressed object data.");
+            return nullptr;
+        }
+
+        std::vector<uint8_t> decompressed(size);
+        if (!Compression::DecompressLZ4(serialized + CompressedHeaderSize, length - CompressedHeaderSize,
+                                        decompressed.data(), decompressed.size()))
+        {
+            LOG_WARNING("DeserializeGameObject: Corrupt compressed object data.");
+            return nullptr;
+        }
+
+        return DeserializeGameObject(decompressed.data(), decompressed.size());
+    }
+
     CResGFF    resGff;
     CResStruct resStruct;
 
-    if (serialized.size() < 14*4) // GFF header size
+    if (length < 14*4) // GFF header size
         return nullptr;
 
-    if (!resGff.GetDataFromPointer((void*)serialized.data(), (int32_t)serialized.size(), false))
+    if (!resGff.GetDataFromPointer((void*)serialized, (int32_t)length, false))
         return nullptr;
 
     resGff.InitializeForWriting();
@@ -153,14 +243,23 @@ CGameObject *DeserializeGameObject(const std::vector<uint8_t>& serialized)
     return nullptr;
 }
 
+CGameObject *DeserializeGameObject(const std::vector<uint8_t>& serialized)
+{
+    return DeserializeGameObject(serialized.data(), serialized.size());
+}
+
 std::string SerializeGameObjectB64(CGameObject *pObject, bool bStripPCFlags)
 {
-    return String::ToBase64(SerializeGameObject(pObject, bStripPCFlags));
+    std::string serialized;
+    SerializeGameObjectB64(pObject, serialized, bStripPCFlags);
+    return serialized;
 }
 
 CGameObject *DeserializeGameObjectB64(const std::string& serializedB64)
 {
-    return DeserializeGameObject(String::FromBase64(serializedB64));
+    std::vector<uint8_t> serialized;
+    String::FromBase64(serializedB64.data(), serializedB64.size(), serialized);
+    return DeserializeGameObject(serialized.data(), serialized.size());
 }
 
 } // NWNXLib
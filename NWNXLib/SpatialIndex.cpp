@@ -0,0 +1,241 @@
+#include "nwnx.hpp"
+#include "API/CNWSArea.hpp"
+#include "API/CNWSObject.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+extern "C" void _ZN8CNWSAreaD1Ev(CNWSArea*);
+
+using namespace NWNXLib;
+using namespace NWNXLib::API;
+
+namespace NWNXLib::SpatialIndex
+{
+
+static constexpr float CELL_SIZE = 10.0f;
+
+namespace {
+
+struct CellEntry
+{
+    ObjectID m_oid;
+    int32_t m_nTypeMask;
+    Vector m_vPosition;
+};
+
+struct Grid
+{
+    int32_t m_nWidth;
+    int32_t m_nHeight;
+    std::vector<std::vector<CellEntry>> m_cells;
+
+    int32_t GetCell(const Vector& v) const
+    {
+        const int32_t x = std::clamp(static_cast<int32_t>(v.x / CELL_SIZE), 0, m_nWidth - 1);
+        const int32_t y = std::clamp(static_cast<int32_t>(v.y / CELL_SIZE), 0, m_nHeight - 1);
+        return x + y * m_nWidth;
+    }
+};
+
+struct Location
+{
+    ObjectID m_oidArea;
+    int32_t m_nCell;
+};
+
+}
+
+// Only areas that have been queried have a grid, objects in other areas aren't tracked.
+static std::unordered_map<ObjectID, Grid> s_grids;
+static std::unordered_map<ObjectID, Location> s_locations;
+
+static int32_t GetTypeMask(uint8_t nObjectType)
+{
+    switch (nObjectType)
+    {
+        case Constants::ObjectType::Creature:     return 1;
+        case Constants::ObjectType::Item:         return 2;
+        case Constants::ObjectType::Trigger:      return 4;
+        case Constants::ObjectType::Door:         return 8;
+        case Constants::ObjectType::AreaOfEffect: return 16;
+        case Constants::ObjectType::Waypoint:     return 32;
+        case Constants::ObjectType::Placeable:    return 64;
+        case Constants::ObjectType::Store:        return 128;
+        case Constants::ObjectType::Encounter:    return 256;
+        default:                                  return 32768;
+    }
+}
+
+static void Insert(Grid& grid, ObjectID oidArea, CNWSObject *pObject)
+{
+    const auto nCell = grid.GetCell(pObject->m_vPosition);
+    grid.m_cells[nCell].push_back({pObject->m_idSelf, GetTypeMask(pObject->m_nObjectType), pObject->m_vPosition});
+    s_locations[pObject->m_idSelf] = {oidArea, nCell};
+}
+
+static void EraseFromCell(std::vector<CellEntry>& cell, ObjectID oid)
+{
+    for (auto& entry : cell)
+    {
+        if (entry.m_oid == oid)
+        {
+            entry = cell.back();
+            cell.pop_back();
+            return;
+        }
+    }
+}
+
+static void Remove(ObjectID oid)
+{
+    auto it = s_locations.find(oid);
+    if (it == s_locations.end())
+        return;
+
+    auto grid = s_grids.find(it->second.m_oidArea);
+    if (grid != s_grids.end())
+        EraseFromCell(grid->second.m_cells[it->second.m_nCell], oid);
+    s_locations.erase(it);
+}
+
+static void InitializeHooks()
+{
+    static Hooks::Hook s_AddObjectToAreaHook = Hooks::HookFunction(&CNWSArea::AddObjectToArea,
+        +[](CNWSArea *pThis, ObjectID oid, BOOL bRunScripts) -> BOOL
+        {
+            auto retVal = s_AddObjectToAreaHook->CallOriginal<BOOL>(pThis, oid, bRunScripts);
+
+            auto grid = s_grids.find(pThis->m_idSelf);
+            if (retVal && grid != s_grids.end())
+            {
+                Remove(oid);
+                if (auto *pObject = Utils::AsNWSObject(Utils::GetGameObject(oid)))
+                    Insert(grid->second, pThis->m_idSelf, pObject);
+            }
+            return retVal;
+        }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_RemoveObjectFromAreaHook = Hooks::HookFunction(&CNWSArea::RemoveObjectFromArea,
+        +[](CNWSArea *pThis, ObjectID oid) -> BOOL
+        {
+            Remove(oid);
+            return s_RemoveObjectFromAreaHook->CallOriginal<BOOL>(pThis, oid);
+        }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_SetPositionHook = Hooks::HookFunction(&CNWSObject::SetPosition,
+        +[](CNWSObject *pThis, Vector vPosition, BOOL bDoingCharacterCopy) -> void
+        {
+            s_SetPositionHook->CallOriginal<void>(pThis, vPosition, bDoingCharacterCopy);
+
+            auto it = s_locations.find(pThis->m_idSelf);
+            if (it == s_locations.end())
+                return;
+
+            auto& location = it->second;
+            auto& grid = s_grids.at(location.m_oidArea);
+            auto& cell = grid.m_cells[location.m_nCell];
+            const auto nCell = grid.GetCell(pThis->m_vPosition);
+            if (nCell == location.m_nCell)
+            {
+                for (auto& entry : cell)
+                {
+                    if (entry.m_oid == pThis->m_idSelf)
+                    {
+                        entry.m_vPosition = pThis->m_vPosition;
+                        break;
+                    }
+                }
+                return;
+            }
+
+            EraseFromCell(cell, pThis->m_idSelf);
+            grid.m_cells[nCell].push_back({pThis->m_idSelf, GetTypeMask(pThis->m_nObjectType), pThis->m_vPosition});
+            location.m_nCell = nCell;
+        }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_AreaDtorHook = Hooks::HookFunction(&_ZN8CNWSAreaD1Ev,
+        +[](CNWSArea *pThis) -> void
+        {
+            auto grid = s_grids.find(pThis->m_idSelf);
+            if (grid != s_grids.end())
+            {
+                for (auto& cell : grid->second.m_cells)
+                {
+                    for (auto& entry : cell)
+                        s_locations.erase(entry.m_oid);
+                }
+                s_grids.erase(grid);
+            }
+            s_AreaDtorHook->CallOriginal<void>(pThis);
+        }, Hooks::Order::VeryEarly);
+}
+
+static Grid& GetGrid(CNWSArea *pArea)
+{
+    auto it = s_grids.find(pArea->m_idSelf);
+    if (it != s_grids.end())
+        return it->second;
+
+    static bool s_bHooked;
+    if (!s_bHooked)
+    {
+        InitializeHooks();
+        s_bHooked = true;
+    }
+
+    auto& grid = s_grids[pArea->m_idSelf];
+    grid.m_nWidth = std::max(pArea->m_nWidth, 1);
+    grid.m_nHeight = std::max(pArea->m_nHeight, 1);
+    grid.m_cells.resize(grid.m_nWidth * grid.m_nHeight);
+
+    for (int32_t i = 0; i < pArea->m_aGameObjects.num; i++)
+    {
+        if (auto *pObject = Utils::AsNWSObject(Utils::GetGameObject(pArea->m_aGameObjects[i])))
+            Insert(grid, pArea->m_idSelf, pObject);
+    }
+
+    return grid;
+}
+
+void GetObjectsInRadius(CNWSArea *pArea, const Vector& vCenter, float fRadius, std::vector<ObjectID>& out, int32_t nObjectTypeMask)
+{
+    if (!pArea || fRadius < 0.0f)
+        return;
+
+    auto& grid = GetGrid(pArea);
+
+    const int32_t minX = std::clamp(static_cast<int32_t>(std::floor((vCenter.x - fRadius) / CELL_SIZE)), 0, grid.m_nWidth - 1);
+    const int32_t maxX = std::clamp(static_cast<int32_t>(std::floor((vCenter.x + fRadius) / CELL_SIZE)), 0, grid.m_nWidth - 1);
+    const int32_t minY = std::clamp(static_cast<int32_t>(std::floor((vCenter.y - fRadius) / CELL_SIZE)), 0, grid.m_nHeight - 1);
+    const int32_t maxY = std::clamp(static_cast<int32_t>(std::floor((vCenter.y + fRadius) / CELL_SIZE)), 0, grid.m_nHeight - 1);
+    const float fRadiusSq = fRadius * fRadius;
+
+    std::vector<std::pair<float, ObjectID>> found;
+    for (int32_t y = minY; y <= maxY; y++)
+    {
+        for (int32_t x = minX; x <= maxX; x++)
+        {
+            for (auto& entry : grid.m_cells[x + y * grid.m_nWidth])
+            {
+                if (!(entry.m_nTypeMask & nObjectTypeMask))
+                    continue;
+
+                const float dx = entry.m_vPosition.x - vCenter.x;
+                const float dy = entry.m_vPosition.y - vCenter.y;
+                const float dz = entry.m_vPosition.z - vCenter.z;
+                const float fDistSq = dx * dx + dy * dy + dz * dz;
+                if (fDistSq <= fRadiusSq)
+                    found.emplace_back(fDistSq, entry.m_oid);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    out.reserve(out.size() + found.size());
+    for (auto& it : found)
+        out.push_back(it.second);
+}
+
+}
@@ -0,0 +1,205 @@
+#include "nwnx.hpp"
+#include "API/C2DA.hpp"
+#include "API/CNWRules.hpp"
+#include "API/CTwoDimArrays.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <unordered_map>
+
+using namespace NWNXLib;
+using namespace NWNXLib::API;
+
+namespace NWNXLib::TwoDA
+{
+
+struct ColumnData
+{
+    int32_t m_rows;
+    std::vector<int32_t> m_ints;
+    std::vector<float> m_floats;
+    // Indices into Table::m_strings.
+    std::vector<uint32_t> m_stringIds;
+    std::vector<uint64_t> m_blank;
+    const std::vector<std::string> *m_pStrings;
+
+    bool IsSet(int32_t row) const
+    {
+        return row >= 0 && row < m_rows && !(m_blank[row >> 6] & (1ull << (row & 63)));
+    }
+};
+
+struct Table
+{
+    // Every distinct cell value, shared by all columns.
+    std::vector<std::string> m_strings;
+    // Keyed by the lowercased column label.
+    std::unordered_map<std::string, ColumnData> m_columns;
+};
+
+// Keyed by the lowercased 2DA name. Missing 2DAs are cached as nullptr.
+static std::unordered_map<std::string, std::unique_ptr<Table>> s_tables;
+// Bumped whenever a cached 2DA is dropped, so handles know to look their column up again.
+static uint32_t s_generation = 1;
+
+static std::string ToLower(std::string str)
+{
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    return str;
+}
+
+static std::unique_ptr<Table> BuildTable(const std::string& name)
+{
+    auto *p2DA = Globals::Rules()->m_p2DArrays->GetCached2DA(name.c_str(), true);
+    if (!p2DA)
+        return nullptr;
+    if (!p2DA->m_bLoaded)
+        p2DA->Load2DArray();
+    if (!p2DA->m_bLoaded)
+        return nullptr;
+
+    auto table = std::make_unique<Table>();
+    std::unordered_map<std::string, uint32_t> stringIds;
+    const int32_t rows = p2DA->m_nNumRows;
+
+    for (int32_t col = 0; col < p2DA->m_nNumColumns; col++)
+    {
+        ColumnData column;
+        column.m_rows = rows;
+        column.m_ints.resize(rows);
+        column.m_floats.resize(rows);
+        column.m_stringIds.resize(rows);
+        column.m_blank.resize((rows + 63) / 64);
+        column.m_pStrings = &table->m_strings;
+
+        for (int32_t row = 0; row < rows; row++)
+        {
+            CExoString sValue;
+            if (!p2DA->GetCExoStringEntry(row, col, &sValue) || sValue.IsEmpty() || sValue == "****")
+            {
+                column.m_blank[row >> 6] |= 1ull << (row & 63);
+                continue;
+            }
+
+            const char *pValue = sValue.CStr();
+            // Same rules as C2DA::GetINTEntry(): hex with a 0x prefix, decimal otherwise.
+            if (pValue[0] == '0' && (pValue[1] == 'x' || pValue[1] == 'X'))
+                column.m_ints[row] = static_cast<int32_t>(std::strtoul(pValue + 2, nullptr, 16));
+            else
+                column.m_ints[row] = static_cast<int32_t>(std::strtol(pValue, nullptr, 10));
+            column.m_floats[row] = std::strtof(pValue, nullptr);
+
+            auto id = stringIds.emplace(pValue, static_cast<uint32_t>(table->m_strings.size()));
+            if (id.second)
+                table->m_strings.emplace_back(pValue);
+            column.m_stringIds[row] = id.first->second;
+        }
+
+        table->m_columns.emplace(ToLower(p2DA->m_pColumnLabel[col].CStr()), std::move(column));
+    }
+
+    return table;
+}
+
+Column::Column(std::string twoDA, std::string column)
+    : m_twoDA(ToLower(std::move(twoDA))), m_column(ToLower(std::move(column)))
+{
+}
+
+const ColumnData* Column::Resolve()
+{
+    if (m_generation == s_generation)
+        return m_pData;
+
+    m_pData = nullptr;
+
+    auto it = s_tables.find(m_twoDA);
+    if (it == s_tables.end())
+    {
+        auto table = BuildTable(m_twoDA);
+        it = s_tables.emplace(m_twoDA, std::move(table)).first;
+    }
+
+    if (it->second)
+    {
+        auto column = it->second->m_columns.find(m_column);
+        if (column != it->second->m_columns.end())
+            m_pData = &column->second;
+    }
+
+    // Loading the 2DA may have bumped the generation, so take it last.
+    m_generation = s_generation;
+    return m_pData;
+}
+
+bool Column::IsValid()
+{
+    return Resolve() != nullptr;
+}
+
+int32_t Column::GetRowCount()
+{
+    auto *pData = Resolve();
+    return pData ? pData->m_rows : 0;
+}
+
+std::optional<int32_t> Column::GetInt(int32_t row)
+{
+    auto *pData = Resolve();
+    if (!pData || !pData->IsSet(row))
+        return std::nullopt;
+    return pData->m_ints[row];
+}
+
+std::optional<float> Column::GetFloat(int32_t row)
+{
+    auto *pData = Resolve();
+    if (!pData || !pData->IsSet(row))
+        return std::nullopt;
+    return pData->m_floats[row];
+}
+
+std::optional<std::string> Column::GetString(int32_t row)
+{
+    auto *pData = Resolve();
+    if (!pData || !pData->IsSet(row))
+        return std::nullopt;
+    return (*pData->m_pStrings)[pData->m_stringIds[row]];
+}
+
+void Invalidate(const std::string& twoDA)
+{
+    if (twoDA.empty())
+    {
+        if (s_tables.empty())
+            return;
+        s_tables.clear();
+    }
+    else if (!s_tables.erase(ToLower(twoDA)))
+    {
+        return;
+    }
+
+    s_generation++;
+}
+
+void InitializeHooks()
+{
+    // Rules reloads, e.g. when a module with different haks is loaded.
+    static Hooks::Hook s_Load2DArraysHook = Hooks::HookFunction(&CTwoDimArrays::Load2DArrays,
+        +[](CTwoDimArrays *pThis) -> BOOL
+        {
+            Invalidate();
+            return s_Load2DArraysHook->CallOriginal<BOOL>(pThis);
+        }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_Load2DArrayHook = Hooks::HookFunction(&C2DA::Load2DArray,
+        +[](C2DA *pThis) -> BOOL
+        {
+            Invalidate(pThis->m_cResRef.GetResRefStr());
+            return s_Load2DArrayHook->CallOriginal<BOOL>(pThis);
+        }, Hooks::Order::VeryEarly);
+}
+
+}
@@ -156,6 +156,9 @@ namespace String
 
     std::string ToBase64(const std::vector<uint8_t>& in);
     std::vector<uint8_t> FromBase64(const std::string &in);
+    // These write into out, reusing whatever storage it already has.
+    void ToBase64(const uint8_t* in, size_t len, std::string& out);
+    void FromBase64(const char* in, size_t len, std::vector<uint8_t>& out);
 
     template <typename T>
     std::optional<T> FromString(const std::string& str);
@@ -172,6 +175,14 @@ namespace String
     bool EndsWith(const std::string& str, const std::string& suffix);
 }
 
+namespace Compression
+{
+    // LZ4 block format, without the frame. The compressor appends to out.
+    void CompressLZ4(const uint8_t* in, size_t len, std::vector<uint8_t>& out);
+    // outLen must be the exact uncompressed size. Returns false on malformed input.
+    bool DecompressLZ4(const uint8_t* in, size_t len, uint8_t* out, size_t outLen);
+}
+
 namespace Utils
 {
     std::string ObjectIDToString(const ObjectID id);
@@ -233,11 +244,17 @@ namespace Utils
     // so that when deserialized as a new CGameObject, it becomes destroyable.
     std::vector<uint8_t> SerializeGameObject(CGameObject *pObject, bool bStripPCFlags = true);
     std::string SerializeGameObjectB64(CGameObject *pObject, bool bStripPCFlags = true);
+    // As above, but write into out so callers can reuse their buffers. Returns false on failure.
+    // bCompress - LZ4 compress the GFF. Deserialization detects this on its own, but the
+    // result is no longer a plain GFF file.
+    bool SerializeGameObject(CGameObject *pObject, std::vector<uint8_t>& out, bool bStripPCFlags = true, bool bCompress = false);
+    bool SerializeGameObjectB64(CGameObject *pObject, std::string& out, bool bStripPCFlags = true, bool bCompress = false);
 
     // A deserialized object is added to the world at its location when it was serialized
     // The location may not be valid, so it is best to explictly move the object immediately
     // afterwards. The new object has a unique ObjectID
     CGameObject* DeserializeGameObject(const std::vector<uint8_t>& serialized);
+    CGameObject* DeserializeGameObject(const uint8_t *serialized, size_t length);
     CGameObject* DeserializeGameObjectB64(const std::string& serializedB64);
 
     CGameObject*   PopGameObject(ArgumentStack& args, bool throwOnFail=false);
@@ -273,6 +290,59 @@ namespace POS
     // Removes without cleanup
     void Remove(CGameObject *pGameObject, const std::string& prefix, const std::string& key);
     void RemoveRegex(CGameObject *pGameObject, const std::string& prefix, const std::string& regex);
+
+    // A plugin record attached to the object's storage, for values read too often to look up by key.
+    // Only ever a cache of stored values: it's cleaned up with the object and whenever the stored
+    // values are replaced as a whole (loading, TURDs, RemoveRegex), and rebuilt by the plugin on next use.
+    using ExtensionId = uint32_t;
+    ExtensionId RegisterExtension(CleanupFunc cleanup);
+    void* GetExtension(CGameObject *pGameObject, ExtensionId id);
+    void SetExtension(CGameObject *pGameObject, ExtensionId id, void *pExtension);
+}
+
+namespace TwoDA
+{
+    struct ColumnData;
+
+    // A 2DA column resolved once by name, after which reads are array lookups with no
+    // string work. Handles survive 2DA reloads, the column is looked up again on the
+    // first read after one.
+    class Column
+    {
+    public:
+        Column() = default;
+        Column(std::string twoDA, std::string column);
+
+        // False if the 2DA or the column doesn't exist.
+        bool IsValid();
+        int32_t GetRowCount();
+
+        // These return nullopt for blank cells and rows out of range.
+        std::optional<int32_t> GetInt(int32_t row);
+        std::optional<float> GetFloat(int32_t row);
+        std::optional<std::string> GetString(int32_t row);
+
+    private:
+        const ColumnData* Resolve();
+
+        std::string m_twoDA;
+        std::string m_column;
+        uint32_t m_generation = 0;
+        const ColumnData *m_pData = nullptr;
+    };
+
+    // Drops the cached copy of a 2DA, or of all of them. Needed after changing a 2DA with C2DA::Set*Entry().
+    void Invalidate(const std::string& twoDA = "");
+}
+
+namespace SpatialIndex
+{
+    // Per-area uniform grids, one cell per tile, kept up to date as objects move. An area
+    // is indexed the first time it's queried.
+    //
+    // Appends the objects within fRadius of vCenter to out, nearest first.
+    // nObjectTypeMask takes the NWScript OBJECT_TYPE_* bits.
+    void GetObjectsInRadius(CNWSArea *pArea, const Vector& vCenter, float fRadius, std::vector<ObjectID>& out, int32_t nObjectTypeMask = 32767);
 }
 
 namespace Tasks
@@ -27,8 +27,15 @@
 #include "API/CNWTileSurfaceMesh.hpp"
 #include "API/CGameObjectArray.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <deque>
+#include <numeric>
 #include <set>
+#include <unordered_set>
+
+extern "C" void _ZN8CNWSAreaD1Ev(CNWSArea*);
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
@@ -40,7 +47,9 @@ static constexpr float TILE_SIZE = 10.0f;
 static constexpr float EPSILON  = 0.0001f;
 static constexpr float MAX_TILE_EPSILON = TILE_SIZE - EPSILON;
 static constexpr float MIN_TILE_EPSILON = EPSILON;
-static std::vector<int32_t> s_pPathDepthTable;
+static std::vector<ObjectID> s_ObjectsInRadius;
+
+static void ForgetPathIndex(ObjectID oidArea);
 
 NWNX_EXPORT ArgumentStack GetNumberOfPlayersInArea(ArgumentStack&& args)
 {
@@ -1008,6 +1017,7 @@ NWNX_EXPORT ArgumentStack RotateArea(ArgumentStack&& args)
 
         delete[] pArea->m_pTile;
         pArea->m_pTile = pNewTiles;
+        ForgetPathIndex(pArea->m_idSelf);
 
         auto GetNewPosition = [&](Vector vPosition) -> Vector
         {
@@ -1193,45 +1203,77 @@ NWNX_EXPORT ArgumentStack GetTileInfoByTileIndex(ArgumentStack&& args)
     return {id, height, orientation, x, y};
 }
 
-static bool InterTilePathDFS(CNWSArea *pArea, int32_t nDepth, uint8_t nStartX, uint8_t nStartY, uint8_t nStartRegion, uint8_t nEndX, uint8_t nEndY, uint8_t nEndRegion)
+// Which (tile, region) nodes of an area lead into which, built from the tile path nodes on first use.
+// Never changed once built, so async path requests can hold on to it.
+struct PathGraph
 {
-    auto GetTile = [pArea](int32_t nX, int32_t nY) -> CNWSTile*
+    struct Edge
     {
-        if (!pArea->m_pTile || nX < 0 || nY < 0 || nX >= pArea->m_nWidth || nY >= pArea->m_nHeight)
-            return nullptr;
-        return &pArea->m_pTile[nY * pArea->m_nWidth + nX];
+        uint32_t m_nTo;
+        // Where the edge leaves its tile, in area coordinates.
+        float m_fX;
+        float m_fY;
     };
 
-    if (nStartX == nEndX && nStartY == nEndY && nStartRegion == nEndRegion)
-            return true;
+    // Edges of node n are m_edges[m_edgeStart[n]] .. m_edges[m_edgeStart[n + 1] - 1].
+    std::vector<uint32_t> m_edgeStart;
+    std::vector<Edge> m_edges;
+    // Nodes in different components never reach each other.
+    std::vector<uint32_t> m_component;
+};
 
-    int32_t nIndex = (nStartX + pArea->m_nWidth * nStartY) * MAX_REGIONS_PER_TILE + nStartRegion;
-    if (nIndex < 0 || nIndex >= (int32_t)s_pPathDepthTable.size() || s_pPathDepthTable[nIndex] >= nDepth)
-        return false;
+struct PathIndex
+{
+    std::shared_ptr<const PathGraph> m_pGraph;
+    // Steps from a start node to every node, UINT16_MAX if unreachable. Keyed by start node.
+    std::unordered_map<uint32_t, std::vector<uint16_t>> m_distances;
+};
 
-    s_pPathDepthTable[nIndex] = nDepth;
+static constexpr size_t MAX_CACHED_PATH_DISTANCES = 64;
+static std::unordered_map<ObjectID, PathIndex> s_PathIndexes;
+static std::unordered_set<ObjectID> s_AsyncPathingDisabledAreas;
 
-    if (nDepth == 1)
-        return false;
+static uint32_t GetPathNode(CNWSArea *pArea, int32_t nX, int32_t nY, int32_t nRegion)
+{
+    return (nX + pArea->m_nWidth * nY) * MAX_REGIONS_PER_TILE + nRegion;
+}
 
-    if (auto *pTile = GetTile(nStartX, nStartY))
+static std::shared_ptr<const PathGraph> BuildPathGraph(CNWSArea *pArea)
+{
+    auto GetTile = [pArea](int32_t nX, int32_t nY) -> CNWSTile*
     {
-        auto *pTileSurfaceMesh = pTile->m_pTileData->m_pSurfaceMesh;
-        auto *pTilePathNode = Globals::AppManager()->m_pNWTileSetManager->GetTilePathNode(
-                pTileSurfaceMesh->GetPathNode(), pTileSurfaceMesh->GetPathNodeOrientation());
-        float fExitX, fExitY, fNewEntranceX, fNewEntranceY;
-        uint8_t nNewX, nNewY, nNewRegion, nExitRegion;
+        if (!pArea->m_pTile || nX < 0 || nY < 0 || nX >= pArea->m_nWidth || nY >= pArea->m_nHeight)
+            return nullptr;
+        return &pArea->m_pTile[nY * pArea->m_nWidth + nX];
+    };
 
-        for (int32_t nExit = 0; nExit < pTilePathNode->m_nTileExits; nExit++)
+    const uint32_t nNodes = pArea->m_nWidth * pArea->m_nHeight * MAX_REGIONS_PER_TILE;
+    std::vector<std::pair<uint32_t, PathGraph::Edge>> edges;
+
+    for (int32_t nY = 0; nY < pArea->m_nHeight; nY++)
+    {
+        for (int32_t nX = 0; nX < pArea->m_nWidth; nX++)
         {
-            fExitX = pTilePathNode->m_pfTileExits[nExit * 2];
-            fExitY = pTilePathNode->m_pfTileExits[nExit * 2 + 1];
-            pTile->RotateCanonicalToReal(fExitX, fExitY, &fExitX, &fExitY);
-            nExitRegion = pTilePathNode->m_pnTileExitRegion[nExit];
+            auto *pTile = GetTile(nX, nY);
+            if (!pTile)
+                continue;
 
-            if (nExitRegion == nStartRegion)
+            auto *pTileSurfaceMesh = pTile->m_pTileData->m_pSurfaceMesh;
+            auto *pTilePathNode = Globals::AppManager()->m_pNWTileSetManager->GetTilePathNode(
+                    pTileSurfaceMesh->GetPathNode(), pTileSurfaceMesh->GetPathNodeOrientation());
+            float fExitX, fExitY, fNewEntranceX, fNewEntranceY;
+            int32_t nNewX, nNewY, nNewRegion, nExitRegion;
+
+            for (int32_t nExit = 0; nExit < pTilePathNode->m_nTileExits; nExit++)
             {
-                nNewX = nStartX;
+                fExitX = pTilePathNode->m_pfTileExits[nExit * 2];
+                fExitY = pTilePathNode->m_pfTileExits[nExit * 2 + 1];
+                pTile->RotateCanonicalToReal(fExitX, fExitY, &fExitX, &fExitY);
+                nExitRegion = pTilePathNode->m_pnTileExitRegion[nExit];
+                if (nExitRegion < 0 || nExitRegion >= MAX_REGIONS_PER_TILE)
+                    continue;
+
+                nNewX = nX;
                 fNewEntranceX = fExitX;
                 if (fExitX > MAX_TILE_EPSILON)
                 {
@@ -1244,7 +1286,7 @@ static bool InterTilePathDFS(CNWSArea *pArea, int32_t nDepth, uint8_t nStartX, u
                     fNewEntranceX = TILE_SIZE;
                 }
 
-                nNewY = nStartY;
+                nNewY = nY;
                 fNewEntranceY = fExitY;
                 if (fExitY > MAX_TILE_EPSILON)
                 {
@@ -1261,15 +1303,121 @@ static bool InterTilePathDFS(CNWSArea *pArea, int32_t nDepth, uint8_t nStartX, u
                 {
                     pNextTile->RotateRealToCanonical(fNewEntranceX, fNewEntranceY, &fNewEntranceX, &fNewEntranceY);
                     nNewRegion = pNextTile->m_pTileData->m_pSurfaceMesh->GetRegionEntrance(fNewEntranceX, fNewEntranceY);
+                    if (nNewRegion < 0 || nNewRegion >= MAX_REGIONS_PER_TILE)
+                        continue;
 
-                    if (InterTilePathDFS(pArea, nDepth - 1, nNewX, nNewY, nNewRegion, nEndX, nEndY, nEndRegion))
-                        return true;
+                    edges.push_back({GetPathNode(pArea, nX, nY, nExitRegion),
+                                     {GetPathNode(pArea, nNewX, nNewY, nNewRegion), nX * TILE_SIZE + fExitX, nY * TILE_SIZE + fExitY}});
                 }
             }
         }
     }
 
-    return false;
+    // Several exits can connect the same two nodes, one is enough.
+    std::stable_sort(edges.begin(), edges.end(), [](auto& a, auto& b)
+        { return a.first != b.first ? a.first < b.first : a.second.m_nTo < b.second.m_nTo; });
+    edges.erase(std::unique(edges.begin(), edges.end(), [](auto& a, auto& b)
+        { return a.first == b.first && a.second.m_nTo == b.second.m_nTo; }), edges.end());
+
+    auto pGraph = std::make_shared<PathGraph>();
+    pGraph->m_edgeStart.assign(nNodes + 1, 0);
+    pGraph->m_edges.reserve(edges.size());
+    for (auto& edge : edges)
+    {
+        pGraph->m_edgeStart[edge.first + 1]++;
+        pGraph->m_edges.push_back(edge.second);
+    }
+    std::partial_sum(pGraph->m_edgeStart.begin(), pGraph->m_edgeStart.end(), pGraph->m_edgeStart.begin());
+
+    // Union-find over the edges, ignoring their direction.
+    auto& component = pGraph->m_component;
+    component.resize(nNodes);
+    std::iota(component.begin(), component.end(), 0);
+    auto Find = [&](uint32_t n)
+    {
+        while (component[n] != n)
+            n = component[n] = component[component[n]];
+        return n;
+    };
+    for (auto& edge : edges)
+        component[Find(edge.first)] = Find(edge.second.m_nTo);
+    for (uint32_t n = 0; n < nNodes; n++)
+        component[n] = Find(n);
+
+    return pGraph;
+}
+
+static void InitializePathHooks()
+{
+    static Hooks::Hook s_AreaDtorHook = Hooks::HookFunction(&_ZN8CNWSAreaD1Ev,
+    +[](CNWSArea *pThis) -> void
+    {
+        s_PathIndexes.erase(pThis->m_idSelf);
+        s_AsyncPathingDisabledAreas.erase(pThis->m_idSelf);
+        s_AreaDtorHook->CallOriginal<void>(pThis);
+    }, Hooks::Order::Early);
+
+    static Hooks::Hook s_LoadTileSetInfoHook = Hooks::HookFunction(&CNWSArea::LoadTileSetInfo,
+    +[](CNWSArea *pThis, CResStruct *pStruct) -> BOOL
+    {
+        ForgetPathIndex(pThis->m_idSelf);
+        return s_LoadTileSetInfoHook->CallOriginal<BOOL>(pThis, pStruct);
+    }, Hooks::Order::Early);
+}
+
+// Anything that replaces an area's tiles has to call this, the graph is only rebuilt on the next query.
+static void ForgetPathIndex(ObjectID oidArea)
+{
+    s_PathIndexes.erase(oidArea);
+}
+
+static PathIndex& GetPathIndex(CNWSArea *pArea)
+{
+    InitializePathHooks();
+
+    auto it = s_PathIndexes.find(pArea->m_idSelf);
+    if (it != s_PathIndexes.end())
+        return it->second;
+
+    auto& index = s_PathIndexes[pArea->m_idSelf];
+    index.m_pGraph = BuildPathGraph(pArea);
+    return index;
+}
+
+static const std::vector<uint16_t>& GetPathDistances(PathIndex& index, uint32_t nStart)
+{
+    auto it = index.m_distances.find(nStart);
+    if (it != index.m_distances.end())
+        return it->second;
+
+    if (index.m_distances.size() >= MAX_CACHED_PATH_DISTANCES)
+        index.m_distances.clear();
+
+    auto& graph = *index.m_pGraph;
+    auto& distances = index.m_distances[nStart];
+    distances.assign(graph.m_component.size(), UINT16_MAX);
+    distances[nStart] = 0;
+
+    std::deque<uint32_t> queue{nStart};
+    while (!queue.empty())
+    {
+        const auto n = queue.front();
+        queue.pop_front();
+        if (distances[n] == UINT16_MAX - 1)
+            continue;
+
+        for (uint32_t e = graph.m_edgeStart[n]; e < graph.m_edgeStart[n + 1]; e++)
+        {
+            const auto next = graph.m_edges[e].m_nTo;
+            if (distances[next] == UINT16_MAX)
+            {
+                distances[next] = distances[n] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    return distances;
 }
 
 NWNX_EXPORT ArgumentStack GetPathExists(ArgumentStack&& args)
@@ -1312,15 +1460,259 @@ NWNX_EXPORT ArgumentStack GetPathExists(ArgumentStack&& args)
         if (nStartX == nEndX && nStartY == nEndY && nStartRegion == nEndRegion)
             return true;
 
-        s_pPathDepthTable.resize(pArea->m_nWidth * pArea->m_nHeight * MAX_REGIONS_PER_TILE);
-        std::fill(s_pPathDepthTable.begin(), s_pPathDepthTable.end(), 0);
+        if (nStartRegion >= MAX_REGIONS_PER_TILE || nEndRegion >= MAX_REGIONS_PER_TILE)
+            return false;
 
-        return InterTilePathDFS(pArea, maxDepth + 1, nStartX, nStartY, nStartRegion, nEndX, nEndY, nEndRegion);
+        auto& index = GetPathIndex(pArea);
+        const auto nStart = GetPathNode(pArea, nStartX, nStartY, nStartRegion);
+        const auto nEnd = GetPathNode(pArea, nEndX, nEndY, nEndRegion);
+        if (index.m_pGraph->m_component[nStart] != index.m_pGraph->m_component[nEnd])
+            return false;
+
+        const auto nDistance = GetPathDistances(index, nStart)[nEnd];
+        return nDistance != UINT16_MAX && nDistance <= maxDepth;
     }
 
     return false;
 }
 
+namespace {
+
+struct PathRequest
+{
+    int32_t m_nId;
+    std::string m_sScript;
+    ObjectID m_oidOwner;
+    std::shared_ptr<const PathGraph> m_pGraph;
+    uint32_t m_nStart;
+    uint32_t m_nEnd;
+    Vector m_vEnd;
+    std::chrono::steady_clock::time_point m_queued;
+};
+
+struct PathResult
+{
+    int32_t m_nId = 0;
+    bool m_bFound = false;
+    std::vector<Vector> m_waypoints;
+};
+
+struct PathingStats
+{
+    uint64_t m_requests = 0;
+    uint64_t m_completed = 0;
+    uint64_t m_queueTime = 0;
+    uint64_t m_maxQueueTime = 0;
+    uint64_t m_totalTime = 0;
+};
+
+}
+
+static int32_t s_NextPathRequestId;
+// The result the script run by a finished path request can read.
+static PathResult s_PathResult;
+static PathingStats s_PathingStats;
+static std::chrono::steady_clock::time_point s_LastPathingMetricsReport;
+
+static std::optional<uint32_t> FindPathNode(CNWSArea *pArea, const Vector& vPosition)
+{
+    CNWSTile *pTile = pArea->GetTile(vPosition);
+    if (!pTile)
+        return std::nullopt;
+
+    int32_t nX, nY;
+    pTile->GetLocation(&nX, &nY);
+
+    float fX, fY;
+    pTile->RotateRealToCanonicalTile(vPosition.x, vPosition.y, &fX, &fY);
+    const int32_t nRegion = pTile->m_pTileData->m_pSurfaceMesh->FindClosestRegion(pTile, fX, fY);
+    if (nRegion < 0 || nRegion >= MAX_REGIONS_PER_TILE)
+        return std::nullopt;
+
+    return GetPathNode(pArea, nX, nY, nRegion);
+}
+
+// Runs on the async worker thread, only touches the request and its immutable graph.
+static PathResult PlanPath(const PathRequest& request)
+{
+    PathResult result;
+    result.m_nId = request.m_nId;
+
+    const auto& graph = *request.m_pGraph;
+    if (graph.m_component[request.m_nStart] != graph.m_component[request.m_nEnd])
+        return result;
+
+    // The edge each node was first reached through.
+    std::vector<uint32_t> reachedBy(graph.m_component.size(), UINT32_MAX);
+    std::deque<uint32_t> queue{request.m_nStart};
+    bool bFound = request.m_nStart == request.m_nEnd;
+    while (!bFound && !queue.empty())
+    {
+        const auto n = queue.front();
+        queue.pop_front();
+
+        for (uint32_t e = graph.m_edgeStart[n]; e < graph.m_edgeStart[n + 1]; e++)
+        {
+            const auto next = graph.m_edges[e].m_nTo;
+            if (next == request.m_nStart || reachedBy[next] != UINT32_MAX)
+                continue;
+
+            reachedBy[next] = e;
+            if (next == request.m_nEnd)
+            {
+                bFound = true;
+                break;
+            }
+            queue.push_back(next);
+        }
+    }
+
+    if (!bFound)
+        return result;
+
+    result.m_bFound = true;
+    for (auto n = request.m_nEnd; n != request.m_nStart;)
+    {
+        const auto e = reachedBy[n];
+        result.m_waypoints.push_back({graph.m_edges[e].m_fX, graph.m_edges[e].m_fY, 0.0f});
+        n = static_cast<uint32_t>(std::upper_bound(graph.m_edgeStart.begin(), graph.m_edgeStart.end(), e) - graph.m_edgeStart.begin() - 1);
+    }
+    std::reverse(result.m_waypoints.begin(), result.m_waypoints.end());
+    result.m_waypoints.push_back(request.m_vEnd);
+    return result;
+}
+
+static void ReportPathingMetrics()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - s_LastPathingMetricsReport < std::chrono::seconds(1))
+        return;
+    s_LastPathingMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Area");
+    if (!pPlugin)
+        return;
+
+    const auto completed = std::max<uint64_t>(s_PathingStats.m_completed, 1);
+    pPlugin->GetServices()->m_metrics->Push(
+        "AsyncPathing",
+        {
+            { "requests", std::to_string(s_PathingStats.m_requests) },
+            { "completed", std::to_string(s_PathingStats.m_completed) },
+            { "avg_queue_us", std::to_string(s_PathingStats.m_queueTime / completed) },
+            { "max_queue_us", std::to_string(s_PathingStats.m_maxQueueTime) },
+            { "avg_total_us", std::to_string(s_PathingStats.m_totalTime / completed) },
+        });
+    s_PathingStats = PathingStats();
+}
+
+static void DeliverPathResult(PathResult&& result, const std::string& script, ObjectID oidOwner,
+                              std::chrono::steady_clock::time_point queued)
+{
+    // Only ever run scripts when a module is running.
+    if (Globals::AppManager()->m_pServerExoApp->GetServerMode() != 2)
+        return;
+
+    s_PathingStats.m_completed++;
+    s_PathingStats.m_totalTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued).count();
+    ReportPathingMetrics();
+
+    std::swap(s_PathResult, result);
+    Utils::ExecuteScript(script, oidOwner);
+    std::swap(s_PathResult, result);
+}
+
+NWNX_EXPORT ArgumentStack RequestPath(ArgumentStack&& args)
+{
+    static const bool s_bAsyncPathing = Config::Get<bool>("ASYNC_PATHING", false);
+
+    auto *pArea = Utils::PopArea(args);
+    const auto startX = args.extract<float>();
+    const auto startY = args.extract<float>();
+    const auto startZ = args.extract<float>();
+    const auto endX = args.extract<float>();
+    const auto endY = args.extract<float>();
+    const auto endZ = args.extract<float>();
+    const auto script = args.extract<std::string>();
+      ASSERT_OR_THROW(!script.empty());
+    const auto oidOwner = args.extract<ObjectID>();
+
+    if (!s_bAsyncPathing || !pArea || s_AsyncPathingDisabledAreas.count(pArea->m_idSelf))
+        return 0;
+
+    const Vector vEnd{endX, endY, endZ};
+    const auto nStart = FindPathNode(pArea, {startX, startY, startZ});
+    const auto nEnd = FindPathNode(pArea, vEnd);
+    if (!nStart || !nEnd)
+        return 0;
+
+    const auto id = ++s_NextPathRequestId;
+
+    PathRequest request;
+    request.m_nId = id;
+    request.m_sScript = script;
+    request.m_oidOwner = oidOwner;
+    request.m_pGraph = GetPathIndex(pArea).m_pGraph;
+    request.m_nStart = *nStart;
+    request.m_nEnd = *nEnd;
+    request.m_vEnd = vEnd;
+    request.m_queued = std::chrono::steady_clock::now();
+
+    s_PathingStats.m_requests++;
+
+    Tasks::QueueOnAsyncThread([request = std::move(request)]()
+    {
+        const auto queueTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - request.m_queued).count();
+        auto result = PlanPath(request);
+
+        Tasks::QueueOnMainThread([result = std::move(result), request, queueTime]() mutable
+        {
+            s_PathingStats.m_queueTime += queueTime;
+            s_PathingStats.m_maxQueueTime = std::max<uint64_t>(s_PathingStats.m_maxQueueTime, queueTime);
+            DeliverPathResult(std::move(result), request.m_sScript, request.m_oidOwner, request.m_queued);
+        });
+    });
+
+    return id;
+}
+
+NWNX_EXPORT ArgumentStack GetPathRequestId(ArgumentStack&&)
+{
+    return s_PathResult.m_nId;
+}
+
+NWNX_EXPORT ArgumentStack GetPathWaypointCount(ArgumentStack&&)
+{
+    return s_PathResult.m_bFound ? static_cast<int32_t>(s_PathResult.m_waypoints.size()) : -1;
+}
+
+NWNX_EXPORT ArgumentStack GetPathWaypoint(ArgumentStack&& args)
+{
+    const auto index = args.extract<int32_t>();
+
+    if (index < 0 || index >= static_cast<int32_t>(s_PathResult.m_waypoints.size()))
+        return {0.0f, 0.0f, 0.0f};
+
+    const auto& v = s_PathResult.m_waypoints[index];
+    return {v.z, v.y, v.x};
+}
+
+NWNX_EXPORT ArgumentStack SetAsyncPathingEnabled(ArgumentStack&& args)
+{
+    if (auto *pArea = Utils::PopArea(args))
+    {
+        const auto bEnabled = !!args.extract<int32_t>();
+
+        InitializePathHooks();
+        if (bEnabled)
+            s_AsyncPathingDisabledAreas.erase(pArea->m_idSelf);
+        else
+            s_AsyncPathingDisabledAreas.insert(pArea->m_idSelf);
+    }
+
+    return {};
+}
+
 NWNX_EXPORT ArgumentStack GetAreaFlags(ArgumentStack&& args)
 {
     if (auto *pArea = Utils::PopArea(args))
@@ -1466,3 +1858,32 @@ NWNX_EXPORT ArgumentStack SetDefaultObjectUiDiscoveryMask(ArgumentStack&& args)
 
     return {};
 }
+
+NWNX_EXPORT ArgumentStack GetObjectsInRadius(ArgumentStack&& args)
+{
+    s_ObjectsInRadius.clear();
+
+    if (auto *pArea = Utils::PopArea(args))
+    {
+        const auto x = args.extract<float>();
+        const auto y = args.extract<float>();
+        const auto z = args.extract<float>();
+        const auto radius = args.extract<float>();
+          ASSERT_OR_THROW(radius >= 0.0f);
+        const auto objectFilter = args.extract<int32_t>();
+
+        SpatialIndex::GetObjectsInRadius(pArea, {x, y, z}, radius, s_ObjectsInRadius, objectFilter);
+    }
+
+    return static_cast<int32_t>(s_ObjectsInRadius.size());
+}
+
+NWNX_EXPORT ArgumentStack GetObjectInRadius(ArgumentStack&& args)
+{
+    const auto index = args.extract<int32_t>();
+
+    if (index < 0 || index >= static_cast<int32_t>(s_ObjectsInRadius.size()))
+        return Constants::OBJECT_INVALID;
+
+    return s_ObjectsInRadius[index];
+}
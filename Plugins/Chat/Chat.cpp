@@ -11,8 +11,32 @@
 #include "API/CScriptEvent.hpp"
 #include "API/CServerAIMaster.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 using namespace NWNXLib;
 using namespace NWNXLib::API;
+using namespace std::chrono;
+
+namespace {
+
+struct RateLimit
+{
+    float m_tokens;
+    steady_clock::time_point m_lastRefill;
+};
+
+struct Stats
+{
+    uint64_t m_messages = 0;
+    // Only the recipients NWNX delivers talk and whisper messages to itself, with custom hearing distances.
+    // Messages the engine delivers aren't broken down by recipient.
+    uint64_t m_recipients = 0;
+    uint64_t m_rateLimited = 0;
+};
+
+}
 
 static uint8_t s_ActiveChannel;
 static std::string s_ActiveMessage;
@@ -27,6 +51,129 @@ static std::unordered_map<uint8_t, float> s_HearingDistances{{Constants::ChatCha
                                                              {Constants::ChatChannel::PlayerTalk, 20.0f},
                                                              {Constants::ChatChannel::DmWhisper, 3.0f},
                                                              {Constants::ChatChannel::PlayerWhisper, 3.0f}};
+// The largest per player hearing distance set for each channel, the radius listeners are searched in has to cover it.
+static std::unordered_map<uint8_t, float> s_MaxPlayerHearingDistances;
+
+static float s_RateLimit = Config::Get<float>("RATE_LIMIT", 0.0f);
+static float s_RateLimitBurst = std::max(1, Config::Get<int32_t>("RATE_LIMIT_BURST", 5));
+// The player whose chat message the engine is handling, until that message has been checked against the rate limit.
+// Messages sent by scripts, including the module's OnPlayerChat script, aren't rate limited.
+static CNWSPlayer *s_pChattingPlayer;
+static std::unordered_map<PlayerID, std::array<RateLimit, Constants::ChatChannel::MAX + 1>> s_RateLimits;
+
+static Stats s_Stats;
+static steady_clock::time_point s_LastMetricsReport;
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_LastMetricsReport < seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Chat");
+    if (!pPlugin)
+        return;
+
+    pPlugin->GetServices()->m_metrics->Push(
+        "Chat",
+        {
+            { "messages", std::to_string(s_Stats.m_messages) },
+            { "recipients", std::to_string(s_Stats.m_recipients) },
+            { "rate_limited", std::to_string(s_Stats.m_rateLimited) },
+        });
+    s_Stats = Stats();
+}
+
+static const std::string& GetHearingDistanceKey(int32_t nChatMessageType)
+{
+    static std::array<std::string, Constants::ChatChannel::MAX + 1> s_keys = []()
+    {
+        std::array<std::string, Constants::ChatChannel::MAX + 1> keys;
+        for (size_t i = 0; i < keys.size(); i++)
+            keys[i] = "HEARING_DISTANCE:" + std::to_string(i);
+        return keys;
+    }();
+    if (nChatMessageType >= 0 && nChatMessageType <= Constants::ChatChannel::MAX)
+        return s_keys[nChatMessageType];
+
+    static std::string s_key;
+    s_key = "HEARING_DISTANCE:" + std::to_string(nChatMessageType);
+    return s_key;
+}
+
+static void RaiseMaxPlayerHearingDistance(uint8_t nChatMessageType, float distance)
+{
+    auto& maxDistance = s_MaxPlayerHearingDistances[nChatMessageType];
+    maxDistance = std::max(maxDistance, distance);
+}
+
+// Token bucket per player and channel, refilled at NWNX_CHAT_RATE_LIMIT messages per second.
+static bool IsRateLimited(CNWSPlayer *pPlayer, uint8_t nChatMessageType)
+{
+    if (s_RateLimit <= 0.0f || !pPlayer || nChatMessageType > Constants::ChatChannel::MAX)
+        return false;
+
+    const auto now = steady_clock::now();
+    auto it = s_RateLimits.find(pPlayer->m_nPlayerID);
+    if (it == s_RateLimits.end())
+    {
+        it = s_RateLimits.emplace(pPlayer->m_nPlayerID, std::array<RateLimit, Constants::ChatChannel::MAX + 1>()).first;
+        it->second.fill({s_RateLimitBurst, now});
+    }
+
+    auto& rateLimit = it->second[nChatMessageType];
+    rateLimit.m_tokens = std::min(s_RateLimitBurst,
+                                  rateLimit.m_tokens + duration<float>(now - rateLimit.m_lastRefill).count() * s_RateLimit);
+    rateLimit.m_lastRefill = now;
+
+    if (rateLimit.m_tokens < 1.0f)
+        return true;
+
+    rateLimit.m_tokens -= 1.0f;
+    return false;
+}
+
+static Hooks::Hook s_HandlePlayerToServerChatMessageHook = Hooks::HookFunction(
+        &CNWSMessage::HandlePlayerToServerChatMessage,
+        +[](CNWSMessage *thisPtr, CNWSPlayer *pPlayer, uint8_t nMinor) -> int32_t
+        {
+            s_pChattingPlayer = pPlayer;
+            auto retVal = s_HandlePlayerToServerChatMessageHook->CallOriginal<int32_t>(thisPtr, pPlayer, nMinor);
+            s_pChattingPlayer = nullptr;
+            return retVal;
+        }, Hooks::Order::Early);
+
+// Personal hearing distances are persisted, the search radius has to cover the ones a character comes back with.
+static Hooks::Hook s_LoadCharacterFinishHook = Hooks::HookFunction(
+        &CServerExoAppInternal::LoadCharacterFinish,
+        +[](CServerExoAppInternal *pServerExoAppInternal, CNWSPlayer *pPlayer, int32_t bUseSaveGameCharacter, int32_t bUseStateDataInSaveGame) -> int32_t
+        {
+            auto retVal = s_LoadCharacterFinishHook->CallOriginal<int32_t>(pServerExoAppInternal, pPlayer, bUseSaveGameCharacter, bUseStateDataInSaveGame);
+
+            if (auto *pCreature = Utils::AsNWSCreature(Utils::GetGameObject(pPlayer->m_oidNWSObject)))
+            {
+                for (uint8_t nChatMessageType : {Constants::ChatChannel::PlayerTalk, Constants::ChatChannel::PlayerWhisper,
+                                                 Constants::ChatChannel::DmTalk, Constants::ChatChannel::DmWhisper})
+                {
+                    if (auto customHearingDistance = pCreature->nwnxGet<float>(GetHearingDistanceKey(nChatMessageType)))
+                        RaiseMaxPlayerHearingDistance(nChatMessageType, *customHearingDistance);
+                }
+            }
+
+            return retVal;
+        }, Hooks::Order::Late);
+
+// A player's rate limits are dropped when they leave, the player id can be handed to the next player who connects.
+static Hooks::Hook s_RemovePCFromWorldHook = Hooks::HookFunction(
+        &CServerExoAppInternal::RemovePCFromWorld,
+        +[](CServerExoAppInternal *pServerExoAppInternal, CNWSPlayer *pPlayer) -> void
+        {
+            s_RemovePCFromWorldHook->CallOriginal<void>(pServerExoAppInternal, pPlayer);
+
+            if (pPlayer)
+                s_RateLimits.erase(pPlayer->m_nPlayerID);
+        }, Hooks::Order::Late);
 
 static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
         &CNWSMessage::SendServerToPlayerChatMessage,
@@ -35,6 +182,20 @@ static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
         {
             int32_t retVal = false;
 
+            if (s_Depth == 0 && s_pChattingPlayer && oidSpeaker == s_pChattingPlayer->m_oidNWSObject)
+            {
+                auto *pPlayer = s_pChattingPlayer;
+                s_pChattingPlayer = nullptr;
+
+                if (IsRateLimited(pPlayer, nChatMessageType))
+                {
+                    LOG_DEBUG("Rate limited chat message. Channel: '%i', Sender (ObjID): '0x%08x'", nChatMessageType, oidSpeaker);
+                    s_Stats.m_rateLimited++;
+                    ReportMetrics();
+                    return retVal;
+                }
+            }
+
             if (s_Depth == 0 && !s_ChatScript.empty())
             {
                 s_ActiveChannel = nChatMessageType;
@@ -62,6 +223,8 @@ static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
 
             if (s_Depth > 0 || !s_SkipMessage)
             {
+                s_Stats.m_messages++;
+
                 if (s_CustomHearingDistances)
                 {
                     auto *pServer = Globals::AppManager()->m_pServerExoApp;
@@ -79,7 +242,7 @@ static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
                             nChatMessageType == Constants::ChatChannel::DmTalk ||
                             nChatMessageType == Constants::ChatChannel::DmWhisper)
                         {
-                            auto distance = s_HearingDistances[nChatMessageType];
+                            const auto channelDistance = s_HearingDistances[nChatMessageType];
                             auto speakerPos = Vector{0.0f, 0.0f, 0.0f};
                             CNWSArea *pSpeakerArea = nullptr;
 
@@ -87,24 +250,38 @@ static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
                             {
                                 pSpeakerArea = pSpeaker->GetArea();
                                 speakerPos = pSpeaker->m_vPosition;
-                                pSpeaker->BroadcastDialog(sSpeakerMessage, distance);
+                                pSpeaker->BroadcastDialog(sSpeakerMessage, channelDistance);
                             }
 
-                            for (auto *head = pPlayerList->pHead; head; head = head->pNext)
+                            // Only the creatures near the speaker can hear it, the rest of the players are skipped
+                            // without looking at their creature.
+                            std::vector<ObjectID> nearbyCreatures;
+                            SpatialIndex::GetObjectsInRadius(pSpeakerArea, speakerPos,
+                                                             std::max(channelDistance, s_MaxPlayerHearingDistances[nChatMessageType]),
+                                                             nearbyCreatures, 1 /* OBJECT_TYPE_CREATURE */);
+                            std::sort(nearbyCreatures.begin(), nearbyCreatures.end());
+
+                            for (auto *head = pPlayerList->pHead; head && !nearbyCreatures.empty(); head = head->pNext)
                             {
                                 auto *pPlayer = static_cast<CNWSPlayer*>(static_cast<CNWSClient*>(head->pObject));
+                                if (!std::binary_search(nearbyCreatures.begin(), nearbyCreatures.end(), pPlayer->m_oidNWSObject))
+                                    continue;
+
                                 auto *pListenerCreature = Utils::AsNWSCreature(Utils::GetGameObject(pPlayer->m_oidNWSObject));
 
                                 if (!pListenerCreature)// No valid creature, player likely on character selection, so skip them
                                     continue;
 
-                                if (auto customHearingDistance = pListenerCreature->nwnxGet<float>("HEARING_DISTANCE:" + std::to_string(nChatMessageType)))
+                                auto distance = channelDistance;
+                                if (auto customHearingDistance = pListenerCreature->nwnxGet<float>(GetHearingDistanceKey(nChatMessageType)))
                                     distance = *customHearingDistance;
 
                                 float vSquared = Vector::MagnitudeSquared(pListenerCreature->m_vPosition - speakerPos);
 
-                                if (pSpeakerArea == pListenerCreature->GetArea() && vSquared <= distance * distance)
+                                if (vSquared <= distance * distance)
                                 {
+                                    s_Stats.m_recipients++;
+
                                     switch (nChatMessageType)
                                     {
                                         case Constants::ChatChannel::PlayerTalk:
@@ -144,6 +321,7 @@ static Hooks::Hook s_SendServerToPlayerChatMessageHook = Hooks::HookFunction(
             if (s_Depth == 0)
             {
                 s_SkipMessage = false;
+                ReportMetrics();
             }
 
             return retVal;
@@ -296,7 +474,8 @@ NWNX_EXPORT ArgumentStack SetChatHearingDistance(ArgumentStack &&args)
             if (auto *pCreature = Utils::AsNWSCreature(Utils::GetGameObject(pPlayer->m_oidNWSObject)))
             {
                 s_CustomHearingDistances = true;
-                pCreature->nwnxSet("HEARING_DISTANCE:" + std::to_string(channel), distance, true);
+                pCreature->nwnxSet(GetHearingDistanceKey(channel), distance, true);
+                RaiseMaxPlayerHearingDistance(channel, distance);
             }
         }
         else
@@ -320,7 +499,7 @@ NWNX_EXPORT ArgumentStack GetChatHearingDistance(ArgumentStack &&args)
         {
             if (auto *pCreature = Utils::AsNWSCreature(Utils::GetGameObject(pPlayer->m_oidNWSObject)))
             {
-                if (auto customHearingDistance = pCreature->nwnxGet<float>("HEARING_DISTANCE:" + std::to_string(channel)))
+                if (auto customHearingDistance = pCreature->nwnxGet<float>(GetHearingDistanceKey(channel)))
                 {
                     retVal = *customHearingDistance;
                 }
@@ -56,6 +56,80 @@ static Hooks::Hook s_GetClassLevelHook = nullptr;
 static std::unordered_map<uint8_t, std::unordered_map<ObjectID, int16_t>> s_RollModifier;
 static std::unordered_map<ObjectID, bool> s_ParryAllAttacks;
 
+namespace {
+
+// Values from the object storage that hooks read on every call, loaded on first use.
+template <typename T>
+struct CachedValue
+{
+    bool m_bLoaded = false;
+    std::optional<T> m_value;
+};
+
+struct CasterLevelSlot
+{
+    uint16_t m_nClass;
+    std::optional<int32_t> m_override;
+    std::optional<int32_t> m_modifier;
+};
+
+struct CreatureExtension
+{
+    // Only holds the classes that have been asked about, so a handful at most.
+    std::vector<CasterLevelSlot> m_casterLevels;
+    CachedValue<float> m_movementRateFactor;
+    CachedValue<float> m_movementRateFactorCap;
+    CachedValue<float> m_walkRateCap;
+};
+
+}
+
+static CreatureExtension& GetCreatureExtension(CNWSCreature *pCreature)
+{
+    static const auto s_extensionId = POS::RegisterExtension([](void *p) { delete static_cast<CreatureExtension*>(p); });
+
+    auto *pExtension = static_cast<CreatureExtension*>(POS::GetExtension(pCreature, s_extensionId));
+    if (!pExtension)
+    {
+        pExtension = new CreatureExtension();
+        POS::SetExtension(pCreature, s_extensionId, pExtension);
+    }
+    return *pExtension;
+}
+
+static CasterLevelSlot& GetCasterLevelSlot(CNWSCreature *pCreature, uint16_t nClass)
+{
+    auto& casterLevels = GetCreatureExtension(pCreature).m_casterLevels;
+    for (auto& slot : casterLevels)
+    {
+        if (slot.m_nClass == nClass)
+            return slot;
+    }
+
+    casterLevels.push_back({nClass,
+                            pCreature->nwnxGet<int>("CASTERLEVEL_OVERRIDE" + std::to_string(nClass)),
+                            pCreature->nwnxGet<int>("CASTERLEVEL_MODIFIER" + std::to_string(nClass))});
+    return casterLevels.back();
+}
+
+static std::optional<float> GetCachedFloat(CNWSCreature *pCreature, CachedValue<float> CreatureExtension::*pValue, const char *key)
+{
+    auto& value = GetCreatureExtension(pCreature).*pValue;
+    if (!value.m_bLoaded)
+    {
+        value.m_value = pCreature->nwnxGet<float>(key);
+        value.m_bLoaded = true;
+    }
+    return value.m_value;
+}
+
+static void SetCachedFloat(CNWSCreature *pCreature, CachedValue<float> CreatureExtension::*pValue, std::optional<float> value)
+{
+    auto& cached = GetCreatureExtension(pCreature).*pValue;
+    cached.m_value = value;
+    cached.m_bLoaded = true;
+}
+
 NWNX_EXPORT ArgumentStack AddFeat(ArgumentStack&& args)
 {
     if (auto *pCreature = Utils::PopCreature(args))
@@ -718,7 +792,7 @@ NWNX_EXPORT ArgumentStack GetMovementRateFactorCap(ArgumentStack&& args)
 {
     if (auto *pCreature = Utils::PopCreature(args))
     {
-        if(auto pCap = pCreature->nwnxGet<float>("MOVEMENT_RATE_FACTOR_CAP"))
+        if(auto pCap = GetCachedFloat(pCreature, &CreatureExtension::m_movementRateFactorCap, "MOVEMENT_RATE_FACTOR_CAP"))
             return *pCap;
     }
     return 0.0f;
@@ -730,7 +804,7 @@ NWNX_EXPORT ArgumentStack SetMovementRateFactorCap(ArgumentStack&& args)
         Hooks::HookFunction(&CNWSCreature::GetMovementRateFactor,
         +[](CNWSCreature *pThis) -> float
         {
-            auto pRate = pThis->nwnxGet<float>("MOVEMENT_RATE_FACTOR");
+            auto pRate = GetCachedFloat(pThis, &CreatureExtension::m_movementRateFactor, "MOVEMENT_RATE_FACTOR");
             return pRate.value_or(pGetMovementRateFactor_hook->CallOriginal<float>(pThis));
         }, Hooks::Order::Late);
 
@@ -741,11 +815,12 @@ NWNX_EXPORT ArgumentStack SetMovementRateFactorCap(ArgumentStack&& args)
             // Always set the default so it goes back to normal if cap is reset
             pSetMovementRateFactor_hook->CallOriginal<void>(pThis, fRate);
 
-            auto pCap = pThis->nwnxGet<float>("MOVEMENT_RATE_FACTOR_CAP");
+            auto pCap = GetCachedFloat(pThis, &CreatureExtension::m_movementRateFactorCap, "MOVEMENT_RATE_FACTOR_CAP");
             if (pCap)
             {
                 if (fRate > *pCap) { fRate = *pCap; }
                 pThis->nwnxSet("MOVEMENT_RATE_FACTOR", fRate);
+                SetCachedFloat(pThis, &CreatureExtension::m_movementRateFactor, fRate);
             }
         }, Hooks::Order::Late);
 
@@ -757,10 +832,13 @@ NWNX_EXPORT ArgumentStack SetMovementRateFactorCap(ArgumentStack&& args)
         {
             pCreature->nwnxRemove("MOVEMENT_RATE_FACTOR");
             pCreature->nwnxRemove("MOVEMENT_RATE_FACTOR_CAP");
+            SetCachedFloat(pCreature, &CreatureExtension::m_movementRateFactor, std::nullopt);
+            SetCachedFloat(pCreature, &CreatureExtension::m_movementRateFactorCap, std::nullopt);
         }
         else
         {
             pCreature->nwnxSet("MOVEMENT_RATE_FACTOR_CAP", fCap, true);
+            SetCachedFloat(pCreature, &CreatureExtension::m_movementRateFactorCap, fCap);
         }
     }
 
@@ -1128,7 +1206,7 @@ NWNX_EXPORT ArgumentStack SetWalkRateCap(ArgumentStack&& args)
         {
             float fWalkRate = pGetWalkRate_hook->CallOriginal<float>(pThis);
 
-            auto cap = pThis->nwnxGet<float>("WALK_RATE_CAP");
+            auto cap = GetCachedFloat(pThis, &CreatureExtension::m_walkRateCap, "WALK_RATE_CAP");
             return (cap && *cap < fWalkRate) ? *cap : fWalkRate;
 
         }, Hooks::Order::Late);
@@ -1140,10 +1218,12 @@ NWNX_EXPORT ArgumentStack SetWalkRateCap(ArgumentStack&& args)
         if (fWalkRateCap < 0.0) // remove the override
         {
             pCreature->nwnxRemove("WALK_RATE_CAP");
+            SetCachedFloat(pCreature, &CreatureExtension::m_walkRateCap, std::nullopt);
         }
         else
         {
             pCreature->nwnxSet("WALK_RATE_CAP", fWalkRateCap, true);
+            SetCachedFloat(pCreature, &CreatureExtension::m_walkRateCap, fWalkRateCap);
         }
     }
 
@@ -1699,14 +1779,11 @@ static uint8_t CNWSCreatureStats__GetClassLevel(CNWSCreatureStats* pThis, uint8_
 
         if (nClass != Constants::ClassType::Invalid)
         {
-            auto nLevelOverride = pThis->m_pBaseCreature->nwnxGet<int>("CASTERLEVEL_OVERRIDE" + std::to_string(nClass));
-            if (nLevelOverride)
-                return std::clamp(nLevelOverride.value(), 0, 255);
+            auto& casterLevel = GetCasterLevelSlot(pThis->m_pBaseCreature, nClass);
+            if (casterLevel.m_override)
+                return std::clamp(casterLevel.m_override.value(), 0, 255);
 
-            int32_t nModifier = 0;
-            auto nLevelModifier = pThis->m_pBaseCreature->nwnxGet<int>("CASTERLEVEL_MODIFIER" + std::to_string(nClass));
-            if (nLevelModifier)
-                nModifier = nLevelModifier.value();
+            int32_t nModifier = casterLevel.m_modifier.value_or(0);
 
             //Make sure m_nLevel doesn't over/underflow
             nModifier = std::min(nModifier, 255 - retVal);
@@ -1771,6 +1848,7 @@ NWNX_EXPORT ArgumentStack SetCasterLevelModifier(ArgumentStack&& args)
             pCreature->nwnxSet("CASTERLEVEL_MODIFIER" + std::to_string(nClass), nModifier, bPersist);
         else
             pCreature->nwnxRemove("CASTERLEVEL_MODIFIER" + std::to_string(nClass));
+        GetCasterLevelSlot(pCreature, nClass).m_modifier = nModifier ? std::optional<int32_t>(nModifier) : std::nullopt;
     }
     return {};
 }
@@ -1785,7 +1863,7 @@ NWNX_EXPORT ArgumentStack GetCasterLevelModifier(ArgumentStack&& args)
         const auto nClass = args.extract<int32_t>();
           ASSERT_OR_THROW(nClass >= 0);
           ASSERT_OR_THROW(nClass <= Constants::ClassType::MAX);
-        return pCreature->nwnxGet<int>("CASTERLEVEL_MODIFIER" + std::to_string(nClass)).value_or(0);
+        return GetCasterLevelSlot(pCreature, nClass).m_modifier.value_or(0);
     }
 
     return 0;
@@ -1808,6 +1886,7 @@ NWNX_EXPORT ArgumentStack SetCasterLevelOverride(ArgumentStack&& args)
             pCreature->nwnxSet("CASTERLEVEL_OVERRIDE" + std::to_string(nClass), nLevel, bPersist);
         else
             pCreature->nwnxRemove("CASTERLEVEL_OVERRIDE" + std::to_string(nClass));
+        GetCasterLevelSlot(pCreature, nClass).m_override = nLevel > 0 ? std::optional<int32_t>(nLevel) : std::nullopt;
     }
     return {};
 }
@@ -1822,7 +1901,7 @@ NWNX_EXPORT ArgumentStack GetCasterLevelOverride(ArgumentStack&& args)
         const auto nClass = args.extract<int32_t>();
           ASSERT_OR_THROW(nClass >= 0);
           ASSERT_OR_THROW(nClass <= Constants::ClassType::MAX);
-        return pCreature->nwnxGet<int>("CASTERLEVEL_OVERRIDE" + std::to_string(nClass)).value_or(-1);
+        return GetCasterLevelSlot(pCreature, nClass).m_override.value_or(-1);
     }
 
     return -1;
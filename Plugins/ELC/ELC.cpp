@@ -13,6 +13,7 @@
 #include "API/CNWRace.hpp"
 #include "API/CNWRules.hpp"
 #include "API/CNWClass.hpp"
+#include "API/CNWClass_Feat.hpp"
 #include "API/CNWDomain.hpp"
 #include "API/CNWSkill.hpp"
 #include "API/CNWFeat.hpp"
@@ -20,8 +21,13 @@
 #include "API/CNWSpellArray.hpp"
 #include "API/CTwoDimArrays.hpp"
 
+#include <algorithm>
+#include <future>
+#include <memory>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 
 using namespace NWNXLib;
@@ -152,1722 +158,1926 @@ static int32_t s_ELCLevel;
 static int32_t s_ELCSkillID;
 static int32_t s_ELCFeatID;
 static int32_t s_ELCSpellID;
+static bool s_useRulesSnapshot = Config::Get<bool>("RULES_SNAPSHOT", false);
+static bool s_asyncValidation = Config::Get<bool>("ASYNC_VALIDATION", false);
 
-static auto s_ValidateCharacter = Hooks::HookFunction(&CNWSPlayer::ValidateCharacter,
-        +[](CNWSPlayer *pPlayer, int32_t *bFailedServerRestriction) -> int32_t
-        {
-            // Reset Variables
-            s_ILRItemOID = Constants::OBJECT_INVALID;
-            s_ELCLevel = -1;
-            s_ELCSkillID = -1;
-            s_ELCFeatID = -1;
-            s_ELCSpellID = -1;
+namespace {
 
-            // *** Sanity Checks ****************************************************************************************************
-            if (!pPlayer)
-                return STRREF_CHARACTER_DOES_NOT_EXIST;
+enum SkillFlags : uint8_t
+{
+    Useable    = 1,
+    ClassSkill = 2
+};
 
-            CGameObject *pGameObject = Utils::GetGameObject(pPlayer->m_oidNWSObject);
-            if (!pGameObject)
-                return STRREF_CHARACTER_DOES_NOT_EXIST;
+struct ClassRules
+{
+    // Indexed by skill id.
+    std::vector<uint8_t> m_skillFlags;
+    // Feat id -> class level the feat is granted at.
+    std::unordered_map<uint16_t, uint8_t> m_grantedFeats;
+};
+
+// Flat copies of the class and race tables the per-level checks scan for every skill and feat of every level.
+// They're filled in through the engine's own lookups so the answers can't differ.
+struct RulesSnapshot
+{
+    std::vector<ClassRules> m_classes;
+    std::vector<std::unordered_set<uint16_t>> m_raceFirstLevelFeats;
+};
 
-            CNWSCreature *pCreature = Utils::AsNWSCreature(pGameObject);
-            if (!pCreature)
-                return STRREF_CHARACTER_DOES_NOT_EXIST;
+}
 
-            CNWSCreatureStats *pCreatureStats = pCreature->m_pStats;
-            if (!pCreatureStats)
-                return STRREF_CHARACTER_DOES_NOT_EXIST;
+static std::unique_ptr<RulesSnapshot> s_pRulesSnapshot;
 
-            CNWSInventory *pInventory = pCreature->m_pInventory;
-            if (!pInventory)
-                return STRREF_CHARACTER_DOES_NOT_EXIST;
-            // **********************************************************************************************************************
+static void InvalidateRulesSnapshot()
+{
+    s_pRulesSnapshot.reset();
+}
 
-            auto HandleValidationFailure = [&](ValidationFailureType::TYPE type, ValidationFailureSubType::TYPE subType,
-                                               int32_t strRef) -> int32_t
+static const RulesSnapshot* GetRulesSnapshot(bool bForce = false)
+{
+    // The worker thread can't scan the engine's tables while the main thread may be changing them.
+    if (!bForce && !s_useRulesSnapshot && !s_asyncValidation)
+        return nullptr;
+
+    if (s_pRulesSnapshot)
+        return s_pRulesSnapshot.get();
+
+    static bool s_bHooked;
+    if (!s_bHooked)
+    {
+        static Hooks::Hook s_LoadClassInfoHook = Hooks::HookFunction(&CNWRules::LoadClassInfo,
+            +[](CNWRules *pThis) -> void
             {
-                s_skipValidationFailure = false;
-                s_validationFailureType = type;
-                s_validationFailureSubType = subType;
-                s_validationFailureMessageStrRef = strRef;
+                InvalidateRulesSnapshot();
+                s_LoadClassInfoHook->CallOriginal<void>(pThis);
+            }, Hooks::Order::VeryEarly);
+        static Hooks::Hook s_LoadRaceInfoHook = Hooks::HookFunction(&CNWRules::LoadRaceInfo,
+            +[](CNWRules *pThis) -> void
+            {
+                InvalidateRulesSnapshot();
+                s_LoadRaceInfoHook->CallOriginal<void>(pThis);
+            }, Hooks::Order::VeryEarly);
+        static Hooks::Hook s_LoadSkillInfoHook = Hooks::HookFunction(&CNWRules::LoadSkillInfo,
+            +[](CNWRules *pThis) -> void
+            {
+                InvalidateRulesSnapshot();
+                s_LoadSkillInfoHook->CallOriginal<void>(pThis);
+            }, Hooks::Order::VeryEarly);
+        s_bHooked = true;
+    }
 
-                if (!s_elcScript.empty())
-                {
-                    LOG_DEBUG("Running ELC Script '%s' on object '%x' with Type '%i', subType '%i' and strRef '%i'",
-                              s_elcScript, pPlayer->m_oidNWSObject,
-                              s_validationFailureType, s_validationFailureSubType,
-                              s_validationFailureMessageStrRef);
+    auto *pRules = Globals::Rules();
+    auto pSnapshot = std::make_unique<RulesSnapshot>();
 
-                    ++s_elcDepth;
-                    Utils::ExecuteScript(s_elcScript, pPlayer->m_oidNWSObject);
-                    --s_elcDepth;
+    pSnapshot->m_classes.resize(pRules->m_nNumClasses);
+    for (int32_t nClass = 0; nClass < pRules->m_nNumClasses; nClass++)
+    {
+        auto *pClass = &pRules->m_lstClasses[nClass];
+        auto& classRules = pSnapshot->m_classes[nClass];
 
-                    if (s_skipValidationFailure)
-                    {
-                        LOG_DEBUG("Skipping ELC Validation Failure of object '%x' with Type '%i', subType '%i' and strRef '%i'",
-                                  pPlayer->m_oidNWSObject, s_validationFailureType,
-                                  s_validationFailureSubType,
-                                  s_validationFailureMessageStrRef);
+        classRules.m_skillFlags.resize(pRules->m_nNumSkills);
+        for (uint16_t nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+        {
+            if (pClass->IsSkillUseable(nSkill))
+                classRules.m_skillFlags[nSkill] = SkillFlags::Useable | (pClass->IsSkillClassSkill(nSkill) ? SkillFlags::ClassSkill : 0);
+        }
 
-                        s_validationFailureMessageStrRef = 0;
-                    }
-                }
+        // Only feats in the class feat table can be granted by it.
+        for (int32_t nFeatIndex = 0; nFeatIndex < pClass->m_nNumFeats; nFeatIndex++)
+        {
+            uint16_t nFeat = pClass->m_lstFeatTable[nFeatIndex].nFeat;
+            uint8_t nLevelGranted;
+            if (pClass->IsGrantedFeat(nFeat, nLevelGranted))
+                classRules.m_grantedFeats.emplace(nFeat, nLevelGranted);
+        }
+    }
+
+    pSnapshot->m_raceFirstLevelFeats.resize(pRules->m_nNumRaces);
+    for (int32_t nRace = 0; nRace < pRules->m_nNumRaces; nRace++)
+    {
+        auto *pRace = &pRules->m_lstRaces[nRace];
+        for (int32_t nFeatIndex = 0; nFeatIndex < pRace->m_nNumFeats; nFeatIndex++)
+        {
+            uint16_t nFeat = pRace->m_lstFeatTable[nFeatIndex];
+            if (pRace->IsFirstLevelGrantedFeat(nFeat))
+                pSnapshot->m_raceFirstLevelFeats[nRace].insert(nFeat);
+        }
+    }
+
+    s_pRulesSnapshot = std::move(pSnapshot);
+    return s_pRulesSnapshot.get();
+}
 
-                return s_validationFailureMessageStrRef;
-            };
+static uint8_t GetSkillFlags(const RulesSnapshot *pSnapshot, uint8_t nClass, uint16_t nSkill)
+{
+    if (pSnapshot && nClass < pSnapshot->m_classes.size() && nSkill < pSnapshot->m_classes[nClass].m_skillFlags.size())
+        return pSnapshot->m_classes[nClass].m_skillFlags[nSkill];
 
-            MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_ELC_VALIDATE_CHARACTER_BEFORE",
-                                                             Utils::ObjectIDToString(pPlayer->m_oidNWSObject)});
+    auto *pClass = &Globals::Rules()->m_lstClasses[nClass];
+    if (!pClass->IsSkillUseable(nSkill))
+        return 0;
+    return SkillFlags::Useable | (pClass->IsSkillClassSkill(nSkill) ? SkillFlags::ClassSkill : 0);
+}
 
-            // *** Server Restrictions **********************************************************************************************
-            CServerInfo *pServerInfo = Globals::AppManager()->m_pServerExoApp->GetServerInfo();
+static bool IsGrantedFeat(const RulesSnapshot *pSnapshot, uint8_t nClass, uint16_t nFeat, uint8_t& nLevelGranted)
+{
+    if (pSnapshot && nClass < pSnapshot->m_classes.size())
+    {
+        auto& grantedFeats = pSnapshot->m_classes[nClass].m_grantedFeats;
+        auto it = grantedFeats.find(nFeat);
+        if (it == grantedFeats.end())
+            return false;
+        nLevelGranted = it->second;
+        return true;
+    }
+
+    return Globals::Rules()->m_lstClasses[nClass].IsGrantedFeat(nFeat, nLevelGranted);
+}
 
-            *bFailedServerRestriction = false;
-            uint8_t nCharacterLevel = pCreatureStats->GetLevel(false);
+static bool IsFirstLevelGrantedFeat(const RulesSnapshot *pSnapshot, CNWRace *pRace, uint16_t nRace, uint16_t nFeat)
+{
+    if (pSnapshot && nRace < pSnapshot->m_raceFirstLevelFeats.size())
+        return pSnapshot->m_raceFirstLevelFeats[nRace].count(nFeat);
 
-            // *** Level Restriction Check ******************************************************************************************
-            if (nCharacterLevel < pServerInfo->m_JoiningRestrictions.nMinLevel ||
-                nCharacterLevel > pServerInfo->m_JoiningRestrictions.nMaxLevel)
+    return pRace->IsFirstLevelGrantedFeat(nFeat);
+}
+
+namespace {
+
+struct ValidationFailure
+{
+    ValidationFailureType::TYPE m_type;
+    ValidationFailureSubType::TYPE m_subType;
+    int32_t m_nStrRef;
+    int32_t m_nLevel;
+    int32_t m_nSkillID;
+    int32_t m_nFeatID;
+    int32_t m_nSpellID;
+
+    bool operator==(const ValidationFailure& other) const
+    {
+        return m_type == other.m_type && m_subType == other.m_subType && m_nStrRef == other.m_nStrRef &&
+               m_nLevel == other.m_nLevel && m_nSkillID == other.m_nSkillID &&
+               m_nFeatID == other.m_nFeatID && m_nSpellID == other.m_nSpellID;
+    }
+};
+
+// Everything the per-level checks need that is worked out by the checks that come before them.
+struct LevelCheckParams
+{
+    uint8_t m_nCharacterLevel;
+    uint8_t m_nAbility[Ability::MAX];
+    uint16_t m_nDomainFeat1;
+    uint16_t m_nDomainFeat2;
+    int32_t m_nSkillMaxLevel1Bonus;
+    bool m_bEnforceCasterPrimaryStatIs11;
+    const RulesSnapshot *m_pRulesSnapshot;
+};
+
+// Reads the character straight from the engine, on the main thread.
+struct LiveCharacter
+{
+    CNWSPlayer *m_pPlayer;
+    CNWSCreatureStats *m_pStats;
+
+    CNWLevelStats* GetLevelStats(int32_t nLevel) const { return m_pStats->GetLevelStats(nLevel - 1); }
+    void GetStatBonuses(int32_t nLevel, int32_t *pMods) const
+    {
+        CNWSCreatureStats::GetStatBonusesFromFeats(&GetLevelStats(nLevel)->m_lstFeats, pMods, false);
+    }
+    uint8_t GetRace() const { return m_pStats->m_nRace; }
+    uint8_t GetNumMultiClasses() const { return m_pStats->m_nNumMultiClasses; }
+    uint8_t GetClass(uint8_t nMultiClass) const { return m_pStats->GetClass(nMultiClass); }
+    uint8_t GetHitDie(uint8_t nMultiClass, uint8_t nClass) const { return m_pStats->GetHitDie(nMultiClass, nClass); }
+    char CalcStatModifier(uint8_t nValue) const { return m_pStats->CalcStatModifier(nValue); }
+    uint8_t GetSpellGainWithBonus(uint8_t nMultiClass, uint8_t nSpellLevel) const
+    {
+        return m_pStats->GetSpellGainWithBonus(nMultiClass, nSpellLevel);
+    }
+    uint8_t GetSchool(uint8_t nClass) const { return m_pStats->GetSchool(nClass); }
+    bool GetOppositionSchool(uint8_t nSchool, int32_t& nOppositionSchool) const
+    {
+        return Globals::Rules()->m_p2DArrays->GetSpellSchoolTable()->GetINTEntry(nSchool, "Opposition", &nOppositionSchool);
+    }
+    void GetNormalBonusFlags(uint16_t nFeat, int32_t& bNormalListFeat, int32_t& bBonusListFeat, uint8_t nClass) const
+    {
+        m_pPlayer->ValidateCharacter_SetNormalBonusFlags(nFeat, bNormalListFeat, bBonusListFeat, nClass);
+    }
+    uint16_t GetNumberKnownSpells(uint8_t nMultiClass, uint8_t nSpellLevel) const
+    {
+        return m_pStats->GetNumberKnownSpells(nMultiClass, nSpellLevel);
+    }
+    uint32_t GetKnownSpell(uint8_t nMultiClass, uint8_t nSpellLevel, uint8_t nIndex) const
+    {
+        return m_pStats->GetKnownSpell(nMultiClass, nSpellLevel, nIndex);
+    }
+    char GetSkillRank(uint8_t nSkill) const { return m_pStats->GetSkillRank(nSkill, nullptr, true); }
+    int32_t GetNumFeats() const { return m_pStats->m_lstFeats.num; }
+    uint16_t GetFeat(int32_t nIndex) const { return m_pStats->m_lstFeats.element[nIndex]; }
+    bool HasMiscSavingThrows() const
+    {
+        return m_pStats->m_nFortSavingThrowMisc > 0 || m_pStats->m_nReflexSavingThrowMisc > 0 ||
+               m_pStats->m_nWillSavingThrowMisc > 0;
+    }
+};
+
+// A copy of one CNWLevelStats, with the same member names so the checks read it the same way.
+struct LevelSnapshot
+{
+    CExoArrayList<uint32_t> m_pAddedKnownSpellList[NUM_SPELL_LEVELS];
+    CExoArrayList<uint32_t> m_pRemovedKnownSpellList[NUM_SPELL_LEVELS];
+    CExoArrayList<uint16_t> m_lstFeats;
+    std::vector<char> m_lstSkillRanks;
+    uint16_t m_nSkillPointsRemaining = 0;
+    uint8_t m_nAbilityGain = 0;
+    uint8_t m_nHitDie = 0;
+    uint8_t m_nClass = 0;
+    int32_t m_bEpic = 0;
+    int32_t m_nStatBonuses[Ability::MAX] = {};
+};
+
+// Everything the per-level checks read from the character and the player, copied on the main thread so the
+// checks can run on a worker thread. The answers of the engine functions they call are taken for every
+// argument the checks can pass.
+struct CharacterSnapshot
+{
+    std::vector<LevelSnapshot> m_levels;
+    uint8_t m_nRace = 0;
+    uint8_t m_nNumMultiClasses = 0;
+    uint8_t m_classes[NUM_MULTICLASS] = {};
+    // (nMultiClass << 8 | nClass) -> hit die
+    std::unordered_map<uint16_t, uint8_t> m_hitDice;
+    char m_statModifiers[256] = {};
+    uint8_t m_spellGainWithBonus[NUM_MULTICLASS][NUM_SPELL_LEVELS] = {};
+    std::unordered_map<uint8_t, uint8_t> m_schools;
+    std::unordered_map<uint8_t, int32_t> m_oppositionSchools;
+    // (nClass << 16 | nFeat) -> 1 if a normal list feat, 2 if a bonus list feat
+    std::unordered_map<uint32_t, uint8_t> m_normalBonusFlags;
+    std::vector<uint32_t> m_knownSpells[NUM_MULTICLASS][NUM_SPELL_LEVELS];
+    std::vector<char> m_skillRanks;
+    std::vector<uint16_t> m_feats;
+    bool m_bMiscSavingThrows = false;
+
+    const LevelSnapshot* GetLevelStats(int32_t nLevel) const { return &m_levels[nLevel - 1]; }
+    void GetStatBonuses(int32_t nLevel, int32_t *pMods) const
+    {
+        std::copy_n(GetLevelStats(nLevel)->m_nStatBonuses, Ability::MAX, pMods);
+    }
+    uint8_t GetRace() const { return m_nRace; }
+    uint8_t GetNumMultiClasses() const { return m_nNumMultiClasses; }
+    uint8_t GetClass(uint8_t nMultiClass) const { return m_classes[nMultiClass]; }
+    uint8_t GetHitDie(uint8_t nMultiClass, uint8_t nClass) const
+    {
+        auto it = m_hitDice.find(nMultiClass << 8 | nClass);
+        return it != m_hitDice.end() ? it->second : 0;
+    }
+    char CalcStatModifier(uint8_t nValue) const { return m_statModifiers[nValue]; }
+    uint8_t GetSpellGainWithBonus(uint8_t nMultiClass, uint8_t nSpellLevel) const
+    {
+        return nSpellLevel < NUM_SPELL_LEVELS ? m_spellGainWithBonus[nMultiClass][nSpellLevel] : 0;
+    }
+    uint8_t GetSchool(uint8_t nClass) const
+    {
+        auto it = m_schools.find(nClass);
+        return it != m_schools.end() ? it->second : 0;
+    }
+    bool GetOppositionSchool(uint8_t nSchool, int32_t& nOppositionSchool) const
+    {
+        auto it = m_oppositionSchools.find(nSchool);
+        if (it == m_oppositionSchools.end())
+            return false;
+        nOppositionSchool = it->second;
+        return true;
+    }
+    void GetNormalBonusFlags(uint16_t nFeat, int32_t& bNormalListFeat, int32_t& bBonusListFeat, uint8_t nClass) const
+    {
+        auto it = m_normalBonusFlags.find(nClass << 16 | nFeat);
+        uint8_t nFlags = it != m_normalBonusFlags.end() ? it->second : 0;
+        bNormalListFeat = !!(nFlags & 1);
+        bBonusListFeat = !!(nFlags & 2);
+    }
+    uint16_t GetNumberKnownSpells(uint8_t nMultiClass, uint8_t nSpellLevel) const
+    {
+        return m_knownSpells[nMultiClass][nSpellLevel].size();
+    }
+    uint32_t GetKnownSpell(uint8_t nMultiClass, uint8_t nSpellLevel, int32_t nIndex) const
+    {
+        return m_knownSpells[nMultiClass][nSpellLevel][nIndex];
+    }
+    char GetSkillRank(uint8_t nSkill) const { return nSkill < m_skillRanks.size() ? m_skillRanks[nSkill] : 0; }
+    int32_t GetNumFeats() const { return m_feats.size(); }
+    uint16_t GetFeat(int32_t nIndex) const { return m_feats[nIndex]; }
+    bool HasMiscSavingThrows() const { return m_bMiscSavingThrows; }
+};
+
+}
+
+static std::unique_ptr<CharacterSnapshot> TakeCharacterSnapshot(CNWSPlayer *pPlayer, CNWSCreatureStats *pStats,
+                                                                uint8_t nCharacterLevel)
+{
+    auto *pRules = Globals::Rules();
+
+    // Characters the checks can't read safely are left to the main thread.
+    if (pStats->m_nRace >= pRules->m_nNumRaces || pStats->m_nNumMultiClasses > NUM_MULTICLASS)
+        return nullptr;
+
+    auto pSnapshot = std::make_unique<CharacterSnapshot>();
+    pSnapshot->m_nRace = pStats->m_nRace;
+    pSnapshot->m_nNumMultiClasses = pStats->m_nNumMultiClasses;
+
+    for (int32_t nMultiClass = 0; nMultiClass < NUM_MULTICLASS; nMultiClass++)
+    {
+        pSnapshot->m_classes[nMultiClass] = pStats->GetClass(nMultiClass);
+
+        if (nMultiClass < pStats->m_nNumMultiClasses && pSnapshot->m_classes[nMultiClass] >= pRules->m_nNumClasses)
+            return nullptr;
+    }
+
+    std::set<uint8_t> levelClasses;
+    std::set<uint16_t> levelFeats;
+
+    pSnapshot->m_levels.resize(nCharacterLevel);
+    for (int32_t nLevel = 1; nLevel <= nCharacterLevel; nLevel++)
+    {
+        auto *pLevelStats = pStats->GetLevelStats(nLevel - 1);
+        if (!pLevelStats || !pLevelStats->m_lstSkillRanks || pLevelStats->m_nClass >= pRules->m_nNumClasses)
+            return nullptr;
+
+        auto& level = pSnapshot->m_levels[nLevel - 1];
+        for (int32_t nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+        {
+            level.m_pAddedKnownSpellList[nSpellLevel] = pLevelStats->m_pAddedKnownSpellList[nSpellLevel];
+            level.m_pRemovedKnownSpellList[nSpellLevel] = pLevelStats->m_pRemovedKnownSpellList[nSpellLevel];
+        }
+        level.m_lstFeats = pLevelStats->m_lstFeats;
+        level.m_lstSkillRanks.assign(pLevelStats->m_lstSkillRanks, pLevelStats->m_lstSkillRanks + pRules->m_nNumSkills);
+        level.m_nSkillPointsRemaining = pLevelStats->m_nSkillPointsRemaining;
+        level.m_nAbilityGain = pLevelStats->m_nAbilityGain;
+        level.m_nHitDie = pLevelStats->m_nHitDie;
+        level.m_nClass = pLevelStats->m_nClass;
+        level.m_bEpic = pLevelStats->m_bEpic;
+        CNWSCreatureStats::GetStatBonusesFromFeats(&pLevelStats->m_lstFeats, level.m_nStatBonuses, false);
+
+        levelClasses.insert(pLevelStats->m_nClass);
+        for (int32_t nFeatIndex = 0; nFeatIndex < pLevelStats->m_lstFeats.num; nFeatIndex++)
+            levelFeats.insert(pLevelStats->m_lstFeats.element[nFeatIndex]);
+    }
+
+    for (uint8_t nClass : levelClasses)
+    {
+        for (int32_t nMultiClass = 0; nMultiClass < std::max<int32_t>(1, pStats->m_nNumMultiClasses); nMultiClass++)
+            pSnapshot->m_hitDice[nMultiClass << 8 | nClass] = pStats->GetHitDie(nMultiClass, nClass);
+
+        for (uint16_t nFeat : levelFeats)
+        {
+            int32_t bNormalListFeat;
+            int32_t bBonusListFeat;
+            pPlayer->ValidateCharacter_SetNormalBonusFlags(nFeat, bNormalListFeat, bBonusListFeat, nClass);
+            pSnapshot->m_normalBonusFlags[nClass << 16 | nFeat] = (bNormalListFeat ? 1 : 0) | (bBonusListFeat ? 2 : 0);
+        }
+
+        auto *pClass = &pRules->m_lstClasses[nClass];
+        if (pClass->m_bSpellbookRestricted && pClass->m_bNeedsToMemorizeSpells)
+        {
+            uint8_t nSchool = pStats->GetSchool(nClass);
+            pSnapshot->m_schools[nClass] = nSchool;
+
+            int32_t nOppositionSchool;
+            if (nSchool != 0 && pRules->m_p2DArrays->GetSpellSchoolTable()->GetINTEntry(nSchool, "Opposition", &nOppositionSchool))
+                pSnapshot->m_oppositionSchools[nSchool] = nOppositionSchool;
+        }
+    }
+
+    for (int32_t nValue = 0; nValue < 256; nValue++)
+        pSnapshot->m_statModifiers[nValue] = pStats->CalcStatModifier(nValue);
+
+    for (int32_t nMultiClass = 0; nMultiClass < pStats->m_nNumMultiClasses; nMultiClass++)
+    {
+        for (int32_t nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+        {
+            pSnapshot->m_spellGainWithBonus[nMultiClass][nSpellLevel] = pStats->GetSpellGainWithBonus(nMultiClass, nSpellLevel);
+
+            auto& knownSpells = pSnapshot->m_knownSpells[nMultiClass][nSpellLevel];
+            knownSpells.resize(pStats->GetNumberKnownSpells(nMultiClass, nSpellLevel));
+            for (int32_t nSpellIndex = 0; nSpellIndex < (int32_t)knownSpells.size(); nSpellIndex++)
+                knownSpells[nSpellIndex] = pStats->GetKnownSpell(nMultiClass, nSpellLevel, nSpellIndex);
+        }
+    }
+
+    pSnapshot->m_skillRanks.resize(pRules->m_nNumSkills);
+    for (int32_t nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+        pSnapshot->m_skillRanks[nSkill] = pStats->GetSkillRank(nSkill, nullptr, true);
+
+    pSnapshot->m_feats.assign(pStats->m_lstFeats.element, pStats->m_lstFeats.element + pStats->m_lstFeats.num);
+    pSnapshot->m_bMiscSavingThrows = pStats->m_nFortSavingThrowMisc > 0 || pStats->m_nReflexSavingThrowMisc > 0 ||
+                                     pStats->m_nWillSavingThrowMisc > 0;
+
+    return pSnapshot;
+}
+
+// The ability scores the character was created with
+static void GetStartingAbilities(CNWSCreature *pCreature, uint8_t nCharacterLevel, uint8_t *nAbility)
+{
+    CNWSCreatureStats *pCreatureStats = pCreature->m_pStats;
+    int32_t nMods[6] = {0};
+
+    CNWSCreatureStats::GetStatBonusesFromFeats(&pCreatureStats->m_lstFeats, nMods, true);
+
+    //LOG_DEBUG("(GetStatBonusesFromFeats) STR: %i, DEX: %i, CON: %i, INT: %i, WIS: %i, CHA: %i", nMods[0], nMods[1], nMods[2], nMods[3], nMods[4], nMods[5]);
+
+    // Get our base ability stats
+    nAbility[Ability::Strength] = (pCreature->m_bIsPolymorphed ?
+                                   pCreature->m_nPrePolymorphSTR : pCreatureStats->m_nStrengthBase) +
+                                  nMods[Ability::Strength];
+    nAbility[Ability::Dexterity] = (pCreature->m_bIsPolymorphed ?
+                                    pCreature->m_nPrePolymorphDEX : pCreatureStats->m_nDexterityBase) +
+                                   nMods[Ability::Dexterity];
+    nAbility[Ability::Constitution] = (pCreature->m_bIsPolymorphed ?
+                                       pCreature->m_nPrePolymorphCON : pCreatureStats->m_nConstitutionBase) +
+                                      nMods[Ability::Constitution];
+    nAbility[Ability::Intelligence] = pCreatureStats->m_nIntelligenceBase + nMods[Ability::Intelligence];
+    nAbility[Ability::Wisdom] = pCreatureStats->m_nWisdomBase + nMods[Ability::Wisdom];
+    nAbility[Ability::Charisma] = pCreatureStats->m_nCharismaBase + nMods[Ability::Charisma];
+
+    // Get the level 1 ability values
+    for (int nLevel = 4; nLevel <= nCharacterLevel; nLevel += 4)
+    {
+        uint8_t nAbilityGain = pCreatureStats->GetLevelStats(nLevel - 1)->m_nAbilityGain;
+
+        if (nAbilityGain < Ability::MAX)
+            nAbility[nAbilityGain]--;
+    }
+}
+
+static LevelCheckParams GetLevelCheckParams(CNWSCreature *pCreature, uint8_t nCharacterLevel,
+                                            const RulesSnapshot *pRulesSnapshot)
+{
+    CNWSCreatureStats *pCreatureStats = pCreature->m_pStats;
+    LevelCheckParams params = {};
+
+    params.m_nCharacterLevel = nCharacterLevel;
+    GetStartingAbilities(pCreature, nCharacterLevel, params.m_nAbility);
+
+    // Get Cleric Domain Feats
+    params.m_nDomainFeat1 = -1;
+    params.m_nDomainFeat2 = -1;
+    for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
+    {
+        if (Globals::Rules()->m_lstClasses[pCreatureStats->GetClass(nMultiClass)].m_bHasDomains)
+        {
+            CNWDomain *pDomain = Globals::Rules()->GetDomain(pCreatureStats->GetDomain1(nMultiClass));
+
+            if (pDomain)
             {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::ServerLevelRestriction,
-                        STRREF_CHARACTER_LEVEL_RESTRICTION))
-                {
-                    *bFailedServerRestriction = true;
-                    return strrefFailure;
-                }
+                params.m_nDomainFeat1 = pDomain->m_nGrantedFeat;
             }
-            // **********************************************************************************************************************
 
-            if (pCreatureStats->m_nNumMultiClasses > std::clamp<int32_t>(Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("MULTICLASS_LIMIT"), 3), 1, 8))
+            pDomain = Globals::Rules()->GetDomain(pCreatureStats->GetDomain2(nMultiClass));
+
+            if (pDomain)
             {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::NumMulticlass,
-                        STRREF_CHARACTER_NUMBERMULTICLASSES))
-                {
-                    *bFailedServerRestriction = true;
-                    return strrefFailure;
-                }
+                params.m_nDomainFeat2 = pDomain->m_nGrantedFeat;
             }
+        }
+    }
 
-            // *** Level Hack Check *************************************************************************************************
-            // Character level is stored in an uint8_t which means if a character has say 80/80/120 as their levels it'll wrap around
-            // to level 24 (280 - 256) thus not failing the above check
-            int32_t nTotalLevels = 0;
-            for (int i = 0; i < pCreatureStats->m_nNumMultiClasses; i++)
+    static int32_t skillMaxLevel1Bonus = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_SKILL_MAX_LEVEL_1_BONUS"), 3);
+    params.m_nSkillMaxLevel1Bonus = skillMaxLevel1Bonus;
+    params.m_bEnforceCasterPrimaryStatIs11 = s_enforceCasterPrimaryStatIs11;
+    params.m_pRulesSnapshot = pRulesSnapshot;
+
+    return params;
+}
+
+// The per-level feat, skill and spell checks and the final comparisons with the character. They don't run the ELC
+// script or touch the s_ELC* variables, so they can run on a worker thread against a CharacterSnapshot. Every failure
+// is returned in the order it was found, the caller hands them to the ELC script one by one.
+template <typename Character>
+static std::vector<ValidationFailure> ValidateLevels(const Character& character, const LevelCheckParams& params)
+{
+    std::vector<ValidationFailure> failures;
+    CNWRules *pRules = Globals::Rules();
+    const RulesSnapshot *pRulesSnapshot = params.m_pRulesSnapshot;
+
+    if (character.GetRace() >= pRules->m_nNumRaces)
+        return failures;
+
+    CNWRace *pRace = &pRules->m_lstRaces[character.GetRace()];
+    uint8_t nCharacterLevel = params.m_nCharacterLevel;
+    uint16_t nDomainFeat1 = params.m_nDomainFeat1, nDomainFeat2 = params.m_nDomainFeat2;
+    uint8_t nAbilityAtLevel[6];
+    std::copy_n(params.m_nAbility, Ability::MAX, nAbilityAtLevel);
+
+    int32_t nELCLevel = -1;
+    int32_t nELCSkillID = -1;
+    int32_t nELCFeatID = -1;
+    int32_t nELCSpellID = -1;
+
+    auto Fail = [&](ValidationFailureType::TYPE type, ValidationFailureSubType::TYPE subType, int32_t strRef)
+    {
+        failures.push_back({type, subType, strRef, nELCLevel, nELCSkillID, nELCFeatID, nELCSpellID});
+    };
+
+    // Init some vars
+    uint8_t nMultiClassLevel[NUM_MULTICLASS] = {0};
+    uint16_t nSkillPointsRemaining = 0;
+    std::vector<uint8_t> listSkillRanks;
+    listSkillRanks.resize(pRules->m_nNumSkills, 0);
+    std::set<uint16_t> listFeats;
+    std::set<uint16_t> listChosenFeats;
+    // [nMultiClass][nSpellLevel] -> {SpellIDs}
+    std::vector<std::map<uint32_t, std::set<uint32_t>>> listSpells;
+    listSpells.resize(NUM_MULTICLASS);
+
+// *** Character Per-Level Checks********************************************************************************************
+    for (int nLevel = 1; nLevel <= nCharacterLevel; nLevel++)
+    {
+        // Grab our level stats and figure out which class was leveled
+        auto *pLevelStats = character.GetLevelStats(nLevel);
+        uint8_t nClassLeveledUpIn = pLevelStats->m_nClass;
+        CNWClass *pClassLeveledUpIn = &pRules->m_lstClasses[nClassLeveledUpIn];
+
+        // Reset variables
+        nELCSkillID = -1;
+        nELCFeatID = -1;
+        nELCSpellID = -1;
+
+        // Store our current level so we can retrieve it
+        nELCLevel = nLevel;
+
+        // Keep track of multiclass levels
+        uint8_t nMultiClassLeveledUpIn = 0;
+        for (int nMultiClass = 0; nMultiClass < character.GetNumMultiClasses(); nMultiClass++)
+        {
+            if (nClassLeveledUpIn == character.GetClass(nMultiClass))
             {
-                nTotalLevels += pCreatureStats->GetClassLevel(i, false);
+                nMultiClassLevel[nMultiClass]++;
+                nMultiClassLeveledUpIn = nMultiClass;
+            }
+        }
 
-                if (nTotalLevels > pServerInfo->m_JoiningRestrictions.nMaxLevel)
+        if (params.m_bEnforceCasterPrimaryStatIs11)
+        {
+            // Check if our first level class is a spellcaster and if their primary casting stat is >= 11
+            if (nLevel == 1 && pClassLeveledUpIn->m_bIsSpellCasterClass)
+            {
+                if (nAbilityAtLevel[pClassLeveledUpIn->m_nPrimaryAbility] < 11)
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::LevelHack,
-                            STRREF_CHARACTER_LEVEL_RESTRICTION))
-                    {
-                        *bFailedServerRestriction = true;
-                        return strrefFailure;
-                    }
+                    Fail(ValidationFailureType::Character, ValidationFailureSubType::ClassSpellcasterInvalidPrimaryStat, STRREF_CHARACTER_INVALID_ABILITY_SCORES);
                 }
             }
-            // **********************************************************************************************************************
+        }
 
-            // *** Colored Name Checking ********************************************************************************************
-            auto CheckColoredName = [](CExoLocString &lsName) -> bool
+        // Check Epic Level Flag
+        if (nLevel < CHARACTER_EPIC_LEVEL)
+        {
+            if (pLevelStats->m_bEpic != 0)
             {
-                int32_t nID;
-                CExoString sName;
-                uint8_t nGender;
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::EpicLevelFlag, STRREF_FEAT_INVALID);
+            }
+        }
+        else
+        {
+            if (pLevelStats->m_bEpic == 0)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::EpicLevelFlag, STRREF_FEAT_INVALID);
+            }
+        }
 
-                for (uint32_t i = 0; i < lsName.GetStringCount(); i++)
-                {
-                    if (lsName.GetString(i, &nID, &sName, &nGender))
-                    {
-                        if (sName.Find("<c", 0) >= 0)
-                        {
-                            return true;
-                        }
-                    }
-                }
+        // Keep track of our ability values
+        if (((nLevel) % 4) == 0)
+        {
+            nAbilityAtLevel[pLevelStats->m_nAbilityGain]++;
+        }
 
-                return false;
-            };
+        // Add the stat bonus from feats
+        int32_t nStatMods[6] = {0};
+        character.GetStatBonuses(nLevel, nStatMods);
 
-            if (CheckColoredName(pCreatureStats->m_lsFirstName) || CheckColoredName(pCreatureStats->m_lsLastName))
+        // Update our ability values
+        for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
+        {
+            nAbilityAtLevel[nAbilityIndex] += nStatMods[nAbilityIndex];
+        }
+
+        for (int nMultiClass = 0; nMultiClass < NUM_MULTICLASS; nMultiClass++)
+        {
+            uint8_t nClassId = character.GetClass(nMultiClass);
+            CNWClass *pClass = nClassId < pRules->m_nNumClasses ? &pRules->m_lstClasses[nClassId] : nullptr;
+
+            if (pClass)
             {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::ColoredName,
-                        STRREF_CHARACTER_DOES_NOT_EXIST))
+                for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
                 {
-                    *bFailedServerRestriction = true;
-                    return strrefFailure;
+                    nAbilityAtLevel[nAbilityIndex] += pClass->GetAbilityGainForSingleLevel(nAbilityIndex,
+                                                                                           nMultiClassLevel[nMultiClassLeveledUpIn]);
                 }
             }
-            // **********************************************************************************************************************
+        }
 
-            // *** ILR aka Inventory Checks *****************************************************************************************
+// *** Check Hit Die ********************************************************************************************************
+        if (pLevelStats->m_nHitDie > character.GetHitDie(nMultiClassLeveledUpIn, nClassLeveledUpIn))
+        {
+            Fail(ValidationFailureType::Character, ValidationFailureSubType::TooManyHitPoints, STRREF_CHARACTER_TOO_MANY_HITPOINTS);
+        }
+// **************************************************************************************************************************
 
-            // Only check if ILR is enabled
-            if (pServerInfo->m_PlayOptions.bItemLevelRestrictions)
+// *** Check Skills *********************************************************************************************************
+        // Calculate the skillpoints we gained this level
+        auto GetSkillPointAbilityAdjust = [&]() -> int32_t
+        {
+            switch (pRace->m_nSkillPointModifierAbility)
             {
-                for (int slot = 0; slot <= (InventorySlot::MAX - NUM_CREATURE_ITEM_SLOTS); slot++)
-                {
-                    CNWSItem *pItem = pInventory->GetItemInSlot(slot);
-
-                    if (!pItem)
-                        continue;
+                case Constants::Ability::Strength:
+                    return pRace->m_nSTRAdjust;
+                case Constants::Ability::Dexterity:
+                    return pRace->m_nDEXAdjust;
+                case Constants::Ability::Constitution:
+                    return pRace->m_nCONAdjust;
+                case Constants::Ability::Intelligence:
+                    return pRace->m_nINTAdjust;
+                case Constants::Ability::Wisdom:
+                    return pRace->m_nWISAdjust;
+                case Constants::Ability::Charisma:
+                    return pRace->m_nCHAAdjust;
+                default:
+                    return 0;
+            }
+        };
 
-                    // Store the item oid so we can retrieve it in the ELC script
-                    s_ILRItemOID = pItem->m_idSelf;
+        auto numSkillPoints =
+                pRace->m_nSkillPointModifierAbility >= 0 && pRace->m_nSkillPointModifierAbility < Ability::MAX ?
+                character.CalcStatModifier(
+                        nAbilityAtLevel[pRace->m_nSkillPointModifierAbility] + GetSkillPointAbilityAdjust()) : 0;
 
-                    // Check for unidentified equipped items
-                    if (!pItem->m_bIdentified)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Item,
-                                ValidationFailureSubType::UnidentifiedEquippedItem,
-                                STRREF_ITEM_LEVEL_RESTRICTION))
-                        {
-                            *bFailedServerRestriction = true;
-                            return strrefFailure;
-                        }
-                    }
-
-                    // Check the minimum equip level
-                    if (pItem->GetMinEquipLevel() > nCharacterLevel)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Item,
-                                ValidationFailureSubType::MinEquipLevel,
-                                STRREF_ITEM_LEVEL_RESTRICTION))
-                        {
-                            *bFailedServerRestriction = true;
-                            return strrefFailure;
-                        }
-                    }
-
-                    // Reset the item oid
-                    s_ILRItemOID = Constants::OBJECT_INVALID;
-                }
-            }
-
-            // Strip invalid item properties for local vault servers
-            if (pServerInfo->m_JoiningRestrictions.bAllowLocalVaultChars)
-            {
-                pPlayer->StripAllInvalidItemPropertiesInInventory(pCreature);
-            }
-            // **********************************************************************************************************************
+        if (nLevel == 1)
+        {
+            nSkillPointsRemaining += pRace->m_nFirstLevelSkillPointsMultiplier *
+                                     std::max(1, pClassLeveledUpIn->m_nSkillPointBase + numSkillPoints);
+            nSkillPointsRemaining += pRace->m_nFirstLevelSkillPointsMultiplier * pRace->m_nExtraSkillPointsPerLevel;
+        }
+        else
+        {
+            nSkillPointsRemaining += std::max(1, pClassLeveledUpIn->m_nSkillPointBase + numSkillPoints);
+            nSkillPointsRemaining += pRace->m_nExtraSkillPointsPerLevel;
+        }
 
-            // *** Misc Checks ******************************************************************************************************
-            // Set Plot/Immortal to false
-            pCreature->m_bPlotObject = false;
-            pCreature->m_bIsImmortal = false;
-            // **********************************************************************************************************************
+        // Loop all the skills and check our LevelStats to see what changed
+        for (int nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+        {
+            CNWSkill *pSkill = &pRules->m_lstSkills[nSkill];
+            uint8_t nRankChange = pLevelStats->m_lstSkillRanks[nSkill];
 
-            // *** Character Validation (ELC) ***************************************************************************************
-            CNWRules *pRules = Globals::Rules();
+            // Set the id of the skill we're checking so we can retrieve it
+            nELCSkillID = nSkill;
 
-            // Return early if ELC is off
-            if (!pServerInfo->m_PlayOptions.bEnforceLegalCharacters)
+            if (nRankChange)
             {
-                return 0;
-            }
+                // Figure out if we can use the skill and if it's a class skill
+                bool bCanUse = false;
+                bool bClassSkill = false;
 
-            // Enforce default event scripts: default.nss
-            if (s_enforceDefaultEventScripts)
-            {
-                for (auto &eventScript : pCreature->m_sScripts)
+                if (pSkill->m_bAllClassesCanUse)
                 {
-                    eventScript = CExoString("default");
+                    bCanUse = true;
                 }
-            }
-
-            // Enforce empty dialog resref
-            if (s_enforceEmptyDialogResRef)
-            {
-                pCreature->m_pStats->m_cDialog = CResRef("");
-            }
 
-            // Check for non PC
-            if (!pCreatureStats->m_bIsPC)
-            {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::NonPCCharacter,
-                        STRREF_CHARACTER_NON_PLAYER))
+                uint8_t nSkillFlags = GetSkillFlags(pRulesSnapshot, nClassLeveledUpIn, nSkill);
+                if (nSkillFlags & SkillFlags::Useable)
                 {
-                    return strrefFailure;
-                }
-            }
+                    bCanUse = true;
 
-            // Check for DM character file
-            if (pCreatureStats->m_bIsDMCharacterFile)
-            {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::DMCharacter,
-                        STRREF_CHARACTER_DUNGEON_MASTER))
-                {
-                    return strrefFailure;
+                    if (nSkillFlags & SkillFlags::ClassSkill)
+                    {
+                        bClassSkill = true;
+                    }
                 }
-            }
 
-            // Check for non player race
-            CNWRace *pRace =
-                    pCreatureStats->m_nRace < pRules->m_nNumRaces ? &pRules->m_lstRaces[pCreatureStats->m_nRace] : nullptr;
-            if (!pRace || !pRace->m_bIsPlayerRace)
-            {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::NonPlayerRace,
-                        STRREF_CHARACTER_NON_PLAYER_RACE))
+                // We must be able to use the skill
+                if (!bCanUse)
                 {
-                    return strrefFailure;
+                    Fail(ValidationFailureType::Skill, ValidationFailureSubType::UnusableSkill, STRREF_SKILL_UNUSEABLE);
                 }
-            }
 
-            // Check for non player classes, class level restrictions and prestige class requirements
-            // We also check class alignment restrictions for new characters only
-            for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
-            {
-                uint8_t classId = pCreatureStats->m_ClassInfo[nMultiClass].m_nClass;
-
-                CNWClass *pClass = classId < pRules->m_nNumClasses ? &pRules->m_lstClasses[classId] : nullptr;
-
-                if (!pClass || !pClass->m_bIsPlayerClass)
+                // Check if we have enough available points
+                if (bClassSkill)
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::NonPlayerClass,
-                            STRREF_CHARACTER_NON_PLAYER_CLASS))
+                    if (nRankChange > nSkillPointsRemaining)
                     {
-                        return strrefFailure;
+                        Fail(ValidationFailureType::Skill, ValidationFailureSubType::NotEnoughSkillPoints, STRREF_SKILL_INVALID_NUM_SKILLPOINTS);
                     }
-                }
 
-                if (pClass->m_nMaxLevel > 0 && pCreatureStats->GetClassLevel(nMultiClass, false) > pClass->m_nMaxLevel)
+                    nSkillPointsRemaining -= nRankChange;
+                }
+                else
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::ClassLevelRestriction,
-                            STRREF_CHARACTER_NON_PLAYER_CLASS))
+                    if (nRankChange * 2 > nSkillPointsRemaining)
                     {
-                        return strrefFailure;
+                        Fail(ValidationFailureType::Skill, ValidationFailureSubType::NotEnoughSkillPoints, STRREF_SKILL_INVALID_NUM_SKILLPOINTS);
                     }
+
+                    nSkillPointsRemaining -= nRankChange * 2;
                 }
+                // Increase the rank for the skill
+                listSkillRanks[nSkill] += nRankChange;
 
-                if (!pCreatureStats->GetMeetsPrestigeClassRequirements(pClass))
+                // Can't have more than Level + 3 in a class skill, or (Level + 3) / 2 for a non class skill
+                if (bClassSkill)
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::PrestigeClassRequirements,
-                            STRREF_CHARACTER_NON_PLAYER_CLASS))
+                    if (listSkillRanks[nSkill] > nLevel + params.m_nSkillMaxLevel1Bonus)
                     {
-                        return strrefFailure;
+                        Fail(ValidationFailureType::Skill, ValidationFailureSubType::InvalidNumRanksInClassSkill, STRREF_SKILL_INVALID_RANKS);
                     }
                 }
-
-                if (nMultiClass == 0 && nCharacterLevel == 1 && pCreatureStats->m_nExperience == 0)
+                else
                 {
-                    if (!pClass->GetIsAlignmentAllowed(pCreatureStats->GetSimpleAlignmentGoodEvil(),
-                                                       pCreatureStats->GetSimpleAlignmentLawChaos()))
+                    if (listSkillRanks[nSkill] > (nLevel + params.m_nSkillMaxLevel1Bonus) / 2)
                     {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Character,
-                                ValidationFailureSubType::ClassAlignmentRestriction,
-                                STRREF_CHARACTER_NON_PLAYER_CLASS))
-                        {
-                            return strrefFailure;
-                        }
+                        Fail(ValidationFailureType::Skill, ValidationFailureSubType::InvalidNumRanksInNonClassSkill, STRREF_SKILL_INVALID_RANKS);
                     }
                 }
             }
+        }
 
-            // Check movement rate
-            if (pCreatureStats->m_nMovementRate != MovementRate::PC)
-            {
-                pCreatureStats->SetMovementRate(MovementRate::PC);
-            }
+        // Reset the skill id
+        nELCSkillID = -1;
 
-            // Calculate Ability Scores
-            uint8_t nAbility[6] = {0};
-            int32_t nMods[6] = {0};
+        // Compare the remaining skillpoints in LevelStats with our own calculation
+        if (pLevelStats->m_nSkillPointsRemaining > nSkillPointsRemaining)
+        {
+            Fail(ValidationFailureType::Skill, ValidationFailureSubType::InvalidNumRemainingSkillPoints, STRREF_SKILL_INVALID_NUM_SKILLPOINTS);
+        }
+// **************************************************************************************************************************
+
+// *** Check Feats **********************************************************************************************************
+        // Calculate the number of normal and bonus feats for this level
+        uint8_t nNumberNormalFeats = 0;
+        uint8_t nNumberBonusFeats = 0;
 
-            CNWSCreatureStats::GetStatBonusesFromFeats(&pCreatureStats->m_lstFeats, nMods, true);
+        // First and every nth level gets a normal feat
+        if ((nLevel == 1) ||
+            ((pRace->m_nNormalFeatEveryNthLevel != 0) && (nLevel % pRace->m_nNormalFeatEveryNthLevel == 0)))
+        {
+            nNumberNormalFeats = pRace->m_nNumberNormalFeatsEveryNthLevel;
+        }
 
-            //LOG_DEBUG("(GetStatBonusesFromFeats) STR: %i, DEX: %i, CON: %i, INT: %i, WIS: %i, CHA: %i", nMods[0], nMods[1], nMods[2], nMods[3], nMods[4], nMods[5]);
+        // Add any extra first level feats
+        if (nLevel == 1)
+        {
+            nNumberNormalFeats += pRace->m_nExtraFeatsAtFirstLevel;
+        }
 
-            // Get our base ability stats
-            nAbility[Ability::Strength] = (pCreature->m_bIsPolymorphed ?
-                                           pCreature->m_nPrePolymorphSTR : pCreatureStats->m_nStrengthBase) +
-                                          nMods[Ability::Strength];
-            nAbility[Ability::Dexterity] = (pCreature->m_bIsPolymorphed ?
-                                            pCreature->m_nPrePolymorphDEX : pCreatureStats->m_nDexterityBase) +
-                                           nMods[Ability::Dexterity];
-            nAbility[Ability::Constitution] = (pCreature->m_bIsPolymorphed ?
-                                               pCreature->m_nPrePolymorphCON : pCreatureStats->m_nConstitutionBase) +
-                                              nMods[Ability::Constitution];
-            nAbility[Ability::Intelligence] = pCreatureStats->m_nIntelligenceBase + nMods[Ability::Intelligence];
-            nAbility[Ability::Wisdom] = pCreatureStats->m_nWisdomBase + nMods[Ability::Wisdom];
-            nAbility[Ability::Charisma] = pCreatureStats->m_nCharismaBase + nMods[Ability::Charisma];
+        nNumberBonusFeats = pClassLeveledUpIn->GetBonusFeats(nMultiClassLevel[nMultiClassLeveledUpIn]);
 
-            // Get the level 1 ability values
-            for (int nLevel = 4; nLevel <= nCharacterLevel; nLevel += 4)
-            {
-                uint8_t nAbilityGain = pCreatureStats->GetLevelStats(nLevel - 1)->m_nAbilityGain;
+        // Add this level's gained feats to our own list
+        for (int nFeatIndex = 0; nFeatIndex < pLevelStats->m_lstFeats.num; nFeatIndex++)
+        {
+            uint16_t nFeat = pLevelStats->m_lstFeats.element[nFeatIndex];
+            CNWFeat *pFeat = nFeat < pRules->m_nNumFeats ? &pRules->m_lstFeats[nFeat] : nullptr;
 
-                if (nAbilityGain < Ability::MAX)
-                    nAbility[nAbilityGain]--;
+            if (!pFeat)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::InvalidFeat, STRREF_FEAT_INVALID);
             }
 
-            static int32_t charGenBaseAbilityMin = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_BASE_ABILITY_MIN"), 8);
-            static int32_t charGenBaseAbilityMax = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_BASE_ABILITY_MAX"), 18);
+            bool bGranted = false;
 
-            // Check if >18 in an ability
-            for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
+            // Check if this is a feat that's automatically granted at first level
+            if (nLevel == 1)
             {
-                if (nAbility[nAbilityIndex] > charGenBaseAbilityMax)
+                if (IsFirstLevelGrantedFeat(pRulesSnapshot, pRace, character.GetRace(), nFeat))
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::StartingAbilityValueMax,
-                            STRREF_CHARACTER_INVALID_ABILITY_SCORES))
-                    {
-                        return strrefFailure;
-                    }
+                    listFeats.insert(nFeat);
+                    bGranted = true;
                 }
             }
 
-            // Point Buy System calculation
-            uint8_t nAbilityAtLevel[6] = {0};
-            uint8_t nPointBuy = pRace->m_nAbilitiesPointBuyNumber;
-
-            static int32_t abilityCostIncrement2 = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_ABILITY_COST_INCREMENT2"), 14);
-            static int32_t abilityCostIncrement3 = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_ABILITY_COST_INCREMENT3"), 16);
-
-            for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
+            // Check if this is a feat that's automatically granted for this level
+            if (!bGranted)
             {
-                nAbilityAtLevel[nAbilityIndex] = nAbility[nAbilityIndex];
-
-                while (nAbility[nAbilityIndex] > charGenBaseAbilityMin)
+                uint8_t nLevelGranted;
+                if (IsGrantedFeat(pRulesSnapshot, nClassLeveledUpIn, nFeat, nLevelGranted))
                 {
-                    if (nAbility[nAbilityIndex] > abilityCostIncrement3)
-                    {
-                        if (nPointBuy < 3)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Character,
-                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
-                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        nAbility[nAbilityIndex]--;
-                        nPointBuy -= 3;
-                    }
-                    else if (nAbility[nAbilityIndex] > abilityCostIncrement2)
+                    if (nLevelGranted == nMultiClassLevel[nMultiClassLeveledUpIn])
                     {
-                        if (nPointBuy < 2)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Character,
-                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
-                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        nAbility[nAbilityIndex]--;
-                        nPointBuy -= 2;
-                    }
-                    else
-                    {
-                        if (nPointBuy < 1)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Character,
-                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
-                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        nAbility[nAbilityIndex]--;
-                        nPointBuy--;
+                        listFeats.insert(nFeat);
+                        bGranted = true;
                     }
                 }
             }
 
-            // Get Cleric Domain Feats
-            uint16_t nDomainFeat1 = -1, nDomainFeat2 = -1;
-            for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
+            // Check if it's one of our cleric domain feats
+            if (!bGranted)
             {
-                if (Globals::Rules()->m_lstClasses[pCreatureStats->GetClass(nMultiClass)].m_bHasDomains)
+                if (pClassLeveledUpIn->m_bHasDomains && (nMultiClassLevel[nMultiClassLeveledUpIn] == 1))
                 {
-                    CNWDomain *pDomain = pRules->GetDomain(pCreatureStats->GetDomain1(nMultiClass));
-
-                    if (pDomain)
+                    if ((nFeat == nDomainFeat1) || (nFeat == nDomainFeat2))
                     {
-                        nDomainFeat1 = pDomain->m_nGrantedFeat;
+                        listFeats.insert(nFeat);
+                        bGranted = true;
                     }
+                }
+            }
 
-                    pDomain = pRules->GetDomain(pCreatureStats->GetDomain2(nMultiClass));
-
-                    if (pDomain)
-                    {
-                        nDomainFeat2 = pDomain->m_nGrantedFeat;
-                    }
+            // Check if it's the "EpicCharacter" feat and we're level 21
+            if (!bGranted)
+            {
+                if (nLevel == CHARACTER_EPIC_LEVEL && nFeat == Feat::EpicCharacter)
+                {
+                    listFeats.insert(nFeat);
+                    bGranted = true;
                 }
             }
 
-            // Init some vars
-            uint8_t nMultiClassLevel[NUM_MULTICLASS] = {0};
-            uint16_t nSkillPointsRemaining = 0;
-            std::vector<uint8_t> listSkillRanks;
-            listSkillRanks.resize(pRules->m_nNumSkills, 0);
-            std::set<uint16_t> listFeats;
-            std::set<uint16_t> listChosenFeats;
-            // [nMultiClass][nSpellLevel] -> {SpellIDs}
-            std::vector<std::map<uint32_t, std::set<uint32_t>>> listSpells;
-            listSpells.resize(NUM_MULTICLASS);
+            // Not a granted feat, add it to listChosenFeats
+            if (!bGranted)
+            {
+                listChosenFeats.insert(nFeat);
+            }
+        }
+
+        // Check the requirements of the chosen feats
+        for (uint16_t nFeat : listChosenFeats)
+        {
+            CNWFeat *pFeat = nFeat < pRules->m_nNumFeats ? &pRules->m_lstFeats[nFeat] : nullptr;
 
-// *** Character Per-Level Checks********************************************************************************************
-            for (int nLevel = 1; nLevel <= nCharacterLevel; nLevel++)
+            if (!pFeat)
             {
-                // Grab our level stats and figure out which class was leveled
-                CNWLevelStats *pLevelStats = pCreatureStats->GetLevelStats(nLevel - 1);
-                uint8_t nClassLeveledUpIn = pLevelStats->m_nClass;
-                CNWClass *pClassLeveledUpIn = &pRules->m_lstClasses[nClassLeveledUpIn];
+                // There are no requirements to check if the failure is skipped
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::InvalidFeat, STRREF_FEAT_INVALID);
+                continue;
+            }
 
-                // Reset variables
-                s_ELCSkillID = -1;
-                s_ELCFeatID = -1;
-                s_ELCSpellID = -1;
+            // Set the id of the feat we're checking so we can retrieve it
+            nELCFeatID = nFeat;
 
-                // Store our current level so we can retrieve it
-                s_ELCLevel = nLevel;
+            // Spell Level Requirements
+            if (pFeat->m_nMinSpellLevel)
+            {
+                bool bSpellLevelMet = false;
 
-                // Keep track of multiclass levels
-                uint8_t nMultiClassLeveledUpIn = 0;
-                for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
+                for (int nMultiClass = 0;
+                     !bSpellLevelMet && (nMultiClass < character.GetNumMultiClasses()); nMultiClass++)
                 {
-                    if (nClassLeveledUpIn == pCreatureStats->GetClass(nMultiClass))
+                    if (nMultiClassLevel[nMultiClass])
                     {
-                        nMultiClassLevel[nMultiClass]++;
-                        nMultiClassLeveledUpIn = nMultiClass;
-                    }
-                }
+                        uint8_t nClass = character.GetClass(nMultiClass);
+                        CNWClass *pClass = &pRules->m_lstClasses[nClass];
 
-                if (s_enforceCasterPrimaryStatIs11)
-                {
-                    // Check if our first level class is a spellcaster and if their primary casting stat is >= 11
-                    if (nLevel == 1 && pClassLeveledUpIn->m_bIsSpellCasterClass)
-                    {
-                        if (nAbilityAtLevel[pClassLeveledUpIn->m_nPrimaryAbility] < 11)
+                        if (pClass->m_bIsSpellCasterClass)
                         {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Character,
-                                    ValidationFailureSubType::ClassSpellcasterInvalidPrimaryStat,
-                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
+                            if (!pClass->m_bNeedsToMemorizeSpells)
                             {
-                                return strrefFailure;
+                                if (pClass->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClass],
+                                                                   pFeat->m_nMinSpellLevel,
+                                                                   nClass, character.GetRace(),
+                                                                   nAbilityAtLevel[pClass->m_nSpellcastingAbility]))
+                                {
+                                    bSpellLevelMet = true;
+                                }
+                            }
+                            else
+                            {
+                                if (character.GetSpellGainWithBonus(nMultiClass, pFeat->m_nMinSpellLevel))
+                                {
+                                    bSpellLevelMet = true;
+                                }
                             }
                         }
                     }
                 }
 
-                // Check Epic Level Flag
-                if (nLevel < CHARACTER_EPIC_LEVEL)
+                if (!bSpellLevelMet)
                 {
-                    if (pLevelStats->m_bEpic != 0)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::EpicLevelFlag,
-                                STRREF_FEAT_INVALID))
-                        {
-                            return strrefFailure;
-                        }
-                    }
-                }
-                else
-                {
-                    if (pLevelStats->m_bEpic == 0)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::EpicLevelFlag,
-                                STRREF_FEAT_INVALID))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                    Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredSpellLevelNotMet, STRREF_FEAT_REQ_SPELL_LEVEL);
                 }
+            }
+
+            // Ability Requirements
+            uint8_t nBaseAttackBonus = 0;
 
-                // Keep track of our ability values
-                if (((nLevel) % 4) == 0)
+            for (int nMultiClass = 0; nMultiClass < character.GetNumMultiClasses(); nMultiClass++)
+            {
+                if (nMultiClassLevel[nMultiClass])
                 {
-                    nAbilityAtLevel[pLevelStats->m_nAbilityGain]++;
+                    CNWClass *pClass = &pRules->m_lstClasses[character.GetClass(nMultiClass)];
+
+                    nBaseAttackBonus += pClass->GetAttackBonus(nMultiClassLevel[nMultiClass]);
                 }
+            }
+
+            if (pFeat->m_nMinAttackBonus > nBaseAttackBonus)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredBaseAttackBonusNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
 
-                // Add the stat bonus from feats
-                int32_t nStatMods[6] = {0};
-                CNWSCreatureStats::GetStatBonusesFromFeats(&pLevelStats->m_lstFeats, nStatMods, false);
+            if (pFeat->m_nMinSTR > nAbilityAtLevel[Ability::Strength] + pRace->m_nSTRAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
 
-                // Update our ability values
-                for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
-                {
-                    nAbilityAtLevel[nAbilityIndex] += nStatMods[nAbilityIndex];
-                }
+            if (pFeat->m_nMinDEX > nAbilityAtLevel[Ability::Dexterity] + pRace->m_nDEXAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
+
+            if (pFeat->m_nMinINT > nAbilityAtLevel[Ability::Intelligence] + pRace->m_nINTAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
+
+            if (pFeat->m_nMinWIS > nAbilityAtLevel[Ability::Wisdom] + pRace->m_nWISAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
+
+            if (pFeat->m_nMinCON > nAbilityAtLevel[Ability::Constitution] + pRace->m_nCONAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
+
+            if (pFeat->m_nMinCHA > nAbilityAtLevel[Ability::Charisma] + pRace->m_nCHAAdjust)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredAbilityValueNotMet, STRREF_FEAT_REQ_ABILITY);
+            }
 
-                for (int nMultiClass = 0; nMultiClass < NUM_MULTICLASS; nMultiClass++)
+            // Skill Focus Feats
+            auto SkillFocusFeatCheck = [&](uint16_t nReqSkill) -> int32_t
+            {
+                if (nReqSkill != (uint16_t) -1)
                 {
-                    uint8_t nClassId = pCreatureStats->GetClass(nMultiClass);
-                    CNWClass *pClass = nClassId < pRules->m_nNumClasses ? &pRules->m_lstClasses[nClassId] : nullptr;
+                    bool bSkillRequirementMet = false;
+                    CNWSkill *pReqSkill = &pRules->m_lstSkills[nReqSkill];
 
-                    if (pClass)
+                    if (pReqSkill->m_bUntrained)
                     {
-                        for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
+                        // Make sure we have a class that can use the skill
+                        for (int nMultiClass = 0; nMultiClass < character.GetNumMultiClasses(); nMultiClass++)
+                        {
+                            if (GetSkillFlags(pRulesSnapshot, character.GetClass(nMultiClass), nReqSkill) &
+                                SkillFlags::Useable)
+                            {
+                                bSkillRequirementMet = true;
+                            }
+                        }
+
+                        if (!bSkillRequirementMet)
                         {
-                            nAbilityAtLevel[nAbilityIndex] += pClass->GetAbilityGainForSingleLevel(nAbilityIndex,
-                                                                                                   nMultiClassLevel[nMultiClassLeveledUpIn]);
+                            return STRREF_FEAT_REQ_SKILL;
                         }
                     }
-                }
 
-// *** Check Hit Die ********************************************************************************************************
-                if (pLevelStats->m_nHitDie > pCreatureStats->GetHitDie(nMultiClassLeveledUpIn, nClassLeveledUpIn))
-                {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Character,
-                            ValidationFailureSubType::TooManyHitPoints,
-                            STRREF_CHARACTER_TOO_MANY_HITPOINTS))
+                    if (!bSkillRequirementMet)
                     {
-                        return strrefFailure;
+                        if (listSkillRanks[nReqSkill] > 0)
+                        {
+                            bSkillRequirementMet = true;
+                        }
+                        else
+                        {
+                            return STRREF_FEAT_REQ_SKILL;
+                        }
+                    }
+
+                    uint16_t nSkillRanks = pFeat->m_nMinRequiredSkillRank2;
+
+                    if (listSkillRanks[nReqSkill] < nSkillRanks)
+                    {
+                        return STRREF_SKILL_UNUSEABLE;
                     }
                 }
-// **************************************************************************************************************************
 
-// *** Check Skills *********************************************************************************************************
-                // Calculate the skillpoints we gained this level
-                auto GetSkillPointAbilityAdjust = [&]() -> int32_t
+                return 0;
+            };
+
+            int32_t retVal = SkillFocusFeatCheck(pFeat->m_nRequiredSkill);
+            if (retVal)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredSkillNotMet, retVal);
+            }
+
+            retVal = SkillFocusFeatCheck(pFeat->m_nRequiredSkill2);
+            if (retVal)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredSkillNotMet, retVal);
+            }
+
+            // Check Feat Prereqs
+            auto PrerequisitesFeatCheck = [&](uint16_t nPrereqFeat) -> int32_t
+            {
+                if (nPrereqFeat != (uint16_t) -1)
                 {
-                    switch (pRace->m_nSkillPointModifierAbility)
+                    if (listFeats.find(nPrereqFeat) == listFeats.end() &&
+                        listChosenFeats.find(nPrereqFeat) == listChosenFeats.end())
                     {
-                        case Constants::Ability::Strength:
-                            return pRace->m_nSTRAdjust;
-                        case Constants::Ability::Dexterity:
-                            return pRace->m_nDEXAdjust;
-                        case Constants::Ability::Constitution:
-                            return pRace->m_nCONAdjust;
-                        case Constants::Ability::Intelligence:
-                            return pRace->m_nINTAdjust;
-                        case Constants::Ability::Wisdom:
-                            return pRace->m_nWISAdjust;
-                        case Constants::Ability::Charisma:
-                            return pRace->m_nCHAAdjust;
-                        default:
-                            return 0;
+                        return STRREF_FEAT_REQ_FEAT;
                     }
-                };
+                }
+
+                return 0;
+            };
+
+            retVal = PrerequisitesFeatCheck(pFeat->m_lstPrereqFeats[0]);
+            if (retVal)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredFeatNotMet, retVal);
+            }
+
+            retVal = PrerequisitesFeatCheck(pFeat->m_lstPrereqFeats[1]);
+            if (retVal)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredFeatNotMet, retVal);
+            }
 
-                auto numSkillPoints =
-                        pRace->m_nSkillPointModifierAbility >= 0 && pRace->m_nSkillPointModifierAbility < Ability::MAX ?
-                        pCreatureStats->CalcStatModifier(
-                                nAbilityAtLevel[pRace->m_nSkillPointModifierAbility] + GetSkillPointAbilityAdjust()) : 0;
+            // The feat requires a "OrPrereq" feat
+            bool bHasOrPrereqFeat = false;
+            // The character has one of these feats
+            bool bOrPrereqFeatAcquired = false;
 
-                if (nLevel == 1)
+            for (int32_t nOrPrereqFeat = 0; !bOrPrereqFeatAcquired && nOrPrereqFeat < 5; nOrPrereqFeat++)
+            {
+                uint16_t nPrereqFeat = pFeat->m_lstOrPrereqFeats[nOrPrereqFeat];
+
+                if (nPrereqFeat != (uint16_t) -1)
                 {
-                    nSkillPointsRemaining += pRace->m_nFirstLevelSkillPointsMultiplier *
-                                             std::max(1, pClassLeveledUpIn->m_nSkillPointBase + numSkillPoints);
-                    nSkillPointsRemaining += pRace->m_nFirstLevelSkillPointsMultiplier * pRace->m_nExtraSkillPointsPerLevel;
+                    bHasOrPrereqFeat = true;
+                    bOrPrereqFeatAcquired = listFeats.find(nPrereqFeat) != listFeats.end() ||
+                                            listChosenFeats.find(nPrereqFeat) != listChosenFeats.end();
                 }
-                else
+            }
+
+            if (bHasOrPrereqFeat && !bOrPrereqFeatAcquired)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatRequiredFeatNotMet, STRREF_FEAT_REQ_FEAT);
+            }
+
+            // Reset feat id
+            nELCFeatID = -1;
+        }
+
+        // Check if we can actually pick our chosen feats this level
+        if (!listChosenFeats.empty() && !nNumberNormalFeats && !nNumberBonusFeats)
+        {
+            Fail(ValidationFailureType::Feat, ValidationFailureSubType::TooManyFeatsThisLevel, STRREF_FEAT_TOO_MANY);
+        }
+
+        // List to hold moved chosen feats
+        std::vector<uint16_t> listMovedFeats;
+
+        for (auto nFeatIndex : listChosenFeats)
+        {
+            // Set the id of the feat we're checking so we can retrieve it
+            nELCFeatID = nFeatIndex;
+
+            int32_t bNormalListFeat;
+            int32_t bBonusListFeat;
+
+            character.GetNormalBonusFlags(nFeatIndex, bNormalListFeat, bBonusListFeat,
+                                                           nClassLeveledUpIn);
+
+            // Not available to class
+            if (!bNormalListFeat && !bBonusListFeat)
+            {
+                Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatNotAvailableToClass, STRREF_FEAT_TOO_MANY);
+            }
+
+            // Normal Feat Only
+            if (bNormalListFeat && !bBonusListFeat)
+            {
+                if (!nNumberNormalFeats)
                 {
-                    nSkillPointsRemaining += std::max(1, pClassLeveledUpIn->m_nSkillPointBase + numSkillPoints);
-                    nSkillPointsRemaining += pRace->m_nExtraSkillPointsPerLevel;
+                    Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatIsNormalFeatOnly, STRREF_FEAT_TOO_MANY);
                 }
 
-                // Loop all the skills and check our LevelStats to see what changed
-                for (int nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+                // Move the feat from our level list to the main list
+                listFeats.insert(nFeatIndex);
+                // Add the feat that's being moved to a different list because removing stuff while iterating is bad
+                listMovedFeats.push_back(nFeatIndex);
+                nNumberNormalFeats--;
+            }
+
+            // Bonus Feat Only
+            if (!bNormalListFeat && bBonusListFeat)
+            {
+                if (!nNumberBonusFeats)
                 {
-                    CNWSkill *pSkill = &pRules->m_lstSkills[nSkill];
-                    uint8_t nRankChange = pLevelStats->m_lstSkillRanks[nSkill];
+                    Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatIsBonusFeatOnly, STRREF_FEAT_TOO_MANY);
+                }
 
-                    // Set the id of the skill we're checking so we can retrieve it
-                    s_ELCSkillID = nSkill;
+                // Move the feat from our level list to the main list
+                listFeats.insert(nFeatIndex);
+                // Add the feat that's being moved to a different list because removing stuff while iterating is bad
+                listMovedFeats.push_back(nFeatIndex);
+                nNumberBonusFeats--;
+            }
 
-                    if (nRankChange)
-                    {
-                        // Figure out if we can use the skill and if it's a class skill
-                        bool bCanUse = false;
-                        bool bClassSkill = false;
+            // Reset the feat id
+            nELCFeatID = -1;
+        }
 
-                        if (pSkill->m_bAllClassesCanUse)
-                        {
-                            bCanUse = true;
-                        }
+        // Remove the moved feats from the chosen feat list
+        for (auto remove : listMovedFeats)
+        {
+            listChosenFeats.erase(remove);
+        }
+        listMovedFeats.clear();
 
-                        if (pClassLeveledUpIn->IsSkillUseable(nSkill))
-                        {
-                            bCanUse = true;
+        // The feats that are left can be normal or bonus
+        for (auto nFeatIndex : listChosenFeats)
+        {
+            // Set the id of the feat we're checking so we can retrieve it
+            nELCFeatID = nFeatIndex;
 
-                            if (pClassLeveledUpIn->IsSkillClassSkill(nSkill))
-                            {
-                                bClassSkill = true;
-                            }
-                        }
+            if (nNumberBonusFeats)
+            {
+                // Move the feat from our level list to the main list
+                listFeats.insert(nFeatIndex);
+                // Add the feat that's being moved to a different list because removing stuff while iterating is bad
+                listMovedFeats.push_back(nFeatIndex);
+                nNumberBonusFeats--;
+            }
+            else
+            {
+                if (nNumberNormalFeats)
+                {
+                    // Move the feat from our level list to the main list
+                    listFeats.insert(nFeatIndex);
+                    // Add the feat that's being moved to a different list because removing stuff while iterating is bad
+                    listMovedFeats.push_back(nFeatIndex);
+                    nNumberNormalFeats--;
+                }
+                else
+                {
+                    Fail(ValidationFailureType::Feat, ValidationFailureSubType::TooManyFeatsThisLevel, STRREF_FEAT_TOO_MANY);
+                }
+            }
 
-                        // We must be able to use the skill
-                        if (!bCanUse)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Skill,
-                                    ValidationFailureSubType::UnusableSkill,
-                                    STRREF_SKILL_UNUSEABLE))
-                            {
-                                return strrefFailure;
-                            }
-                        }
+            // Reset the feat id
+            nELCFeatID = -1;
+        }
 
-                        // Check if we have enough available points
-                        if (bClassSkill)
-                        {
-                            if (nRankChange > nSkillPointsRemaining)
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Skill,
-                                        ValidationFailureSubType::NotEnoughSkillPoints,
-                                        STRREF_SKILL_INVALID_NUM_SKILLPOINTS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
+        // Remove the moved feats from the chosen feat list
+        for (auto remove : listMovedFeats)
+        {
+            listChosenFeats.erase(remove);
+        }
+        listMovedFeats.clear();
+// **************************************************************************************************************************
 
-                            nSkillPointsRemaining -= nRankChange;
-                        }
-                        else
-                        {
-                            if (nRankChange * 2 > nSkillPointsRemaining)
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Skill,
-                                        ValidationFailureSubType::NotEnoughSkillPoints,
-                                        STRREF_SKILL_INVALID_NUM_SKILLPOINTS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
 
-                            nSkillPointsRemaining -= nRankChange * 2;
-                        }
-                        // Increase the rank for the skill
-                        listSkillRanks[nSkill] += nRankChange;
+// *** Check Known Spells ***************************************************************************************************
+        uint32_t nNumberWizardSpellsToAdd = 0;
 
-                        // Can't have more than Level + 3 in a class skill, or (Level + 3) / 2 for a non class skill
-                        static int32_t skillMaxLevel1Bonus = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_SKILL_MAX_LEVEL_1_BONUS"), 3);
-                        if (bClassSkill)
-                        {
-                            if (listSkillRanks[nSkill] > nLevel + skillMaxLevel1Bonus)
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Skill,
-                                        ValidationFailureSubType::InvalidNumRanksInClassSkill,
-                                        STRREF_SKILL_INVALID_RANKS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if (listSkillRanks[nSkill] > (nLevel + skillMaxLevel1Bonus) / 2)
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Skill,
-                                        ValidationFailureSubType::InvalidNumRanksInNonClassSkill,
-                                        STRREF_SKILL_INVALID_RANKS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
-                        }
+        // Calculate the num of spells a wizard can add
+        if (pClassLeveledUpIn->m_bCanLearnFromScrolls)
+        {
+            if (nMultiClassLevel[nMultiClassLeveledUpIn] == 1)
+            {
+                nNumberWizardSpellsToAdd = 3 + std::max((char) 0,
+                                                        character.CalcStatModifier(
+                                                                nAbilityAtLevel[Ability::Intelligence] +
+                                                                pRace->m_nINTAdjust));
+            }
+            else
+            {
+                nNumberWizardSpellsToAdd = 2;
+            }
+        }
+
+        for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+        {
+            for (int nSpellIndex = 0;
+                 nSpellIndex < pLevelStats->m_pAddedKnownSpellList[nSpellLevel].num; nSpellIndex++)
+            {
+                // Can we add spells this level?
+                if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
+                {
+                    if (!pClassLeveledUpIn->GetSpellGain(nMultiClassLevel[nMultiClassLeveledUpIn], nSpellLevel))
+                    {
+                        Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellInvalidSpellGainWizard, STRREF_SPELL_ILLEGAL_LEVEL);
                     }
                 }
-
-                // Reset the skill id
-                s_ELCSkillID = -1;
-
-                // Compare the remaining skillpoints in LevelStats with our own calculation
-                if (pLevelStats->m_nSkillPointsRemaining > nSkillPointsRemaining)
+                else if (pClassLeveledUpIn->m_bSpellbookRestricted && !pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
                 {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Skill,
-                            ValidationFailureSubType::InvalidNumRemainingSkillPoints,
-                            STRREF_SKILL_INVALID_NUM_SKILLPOINTS))
+                    if (!pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
+                                                                   nSpellLevel,
+                                                                   nClassLeveledUpIn, character.GetRace(),
+                                                                   nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
                     {
-                        return strrefFailure;
+                        Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellInvalidSpellGainBardSorcerer, STRREF_SPELL_ILLEGAL_LEVEL);
                     }
                 }
-// **************************************************************************************************************************
-
-// *** Check Feats **********************************************************************************************************
-                // Calculate the number of normal and bonus feats for this level
-                uint8_t nNumberNormalFeats = 0;
-                uint8_t nNumberBonusFeats = 0;
-
-                // First and every nth level gets a normal feat
-                if ((nLevel == 1) ||
-                    ((pRace->m_nNormalFeatEveryNthLevel != 0) && (nLevel % pRace->m_nNormalFeatEveryNthLevel == 0)))
+                else
                 {
-                    nNumberNormalFeats = pRace->m_nNumberNormalFeatsEveryNthLevel;
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellInvalidSpellGainOtherClasses, STRREF_SPELL_ILLEGAL_LEVEL);
                 }
 
-                // Add any extra first level feats
-                if (nLevel == 1)
+                uint32_t nSpellID = pLevelStats->m_pAddedKnownSpellList[nSpellLevel].element[nSpellIndex];
+                CNWSpell *pSpell = pRules->m_pSpellArray->GetSpell(nSpellID);
+
+                if (!pSpell)
                 {
-                    nNumberNormalFeats += pRace->m_nExtraFeatsAtFirstLevel;
+                    // There is nothing to check or learn if the failure is skipped
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::InvalidSpell, STRREF_SPELL_INVALID_SPELL);
+                    continue;
                 }
 
-                nNumberBonusFeats = pClassLeveledUpIn->GetBonusFeats(nMultiClassLevel[nMultiClassLeveledUpIn]);
+                // Store the spell id so we can retrieve it later
+                nELCSpellID = nSpellID;
 
-                // Add this level's gained feats to our own list
-                for (int nFeatIndex = 0; nFeatIndex < pLevelStats->m_lstFeats.num; nFeatIndex++)
+                // Check the spell level
+                if (pSpell->GetSpellLevel(nClassLeveledUpIn) != nSpellLevel)
                 {
-                    uint16_t nFeat = pLevelStats->m_lstFeats.element[nFeatIndex];
-                    CNWFeat *pFeat = nFeat < pRules->m_nNumFeats ? &pRules->m_lstFeats[nFeat] : nullptr;
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellInvalidSpellLevel, STRREF_SPELL_REQ_SPELL_LEVEL);
+                }
 
-                    if (!pFeat)
+                // Check for minimum ability
+                if (pClassLeveledUpIn->m_bSpellbookRestricted)
+                {
+                    if (nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility] < 10 + nSpellLevel)
                     {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::InvalidFeat,
-                                STRREF_FEAT_INVALID))
-                        {
-                            return strrefFailure;
-                        }
+                        Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellMinimumAbility, STRREF_SPELL_REQ_ABILITY);
                     }
+                }
 
-                    bool bGranted = false;
-
-                    // Check if this is a feat that's automatically granted at first level
-                    if (nLevel == 1)
-                    {
-                        if (pRace->IsFirstLevelGrantedFeat(nFeat))
-                        {
-                            listFeats.insert(nFeat);
-                            bGranted = true;
-                        }
-                    }
+                // Check Opposition School
+                if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
+                {
+                    uint8_t nSchool = character.GetSchool(nClassLeveledUpIn);
 
-                    // Check if this is a feat that's automatically granted for this level
-                    if (!bGranted)
+                    if (nSchool != 0)
                     {
-                        uint8_t nLevelGranted;
-                        if (pClassLeveledUpIn->IsGrantedFeat(nFeat, nLevelGranted))
+                        int32_t nOppositionSchool;
+                        if (character.GetOppositionSchool(nSchool, nOppositionSchool))
                         {
-                            if (nLevelGranted == nMultiClassLevel[nMultiClassLeveledUpIn])
+                            if (pSpell->m_nSchool == (uint8_t) nOppositionSchool)
                             {
-                                listFeats.insert(nFeat);
-                                bGranted = true;
+                                Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellRestrictedSpellSchool, STRREF_SPELL_OPPOSITE_SPELL_SCHOOL);
                             }
                         }
                     }
+                }
 
-                    // Check if it's one of our cleric domain feats
-                    if (!bGranted)
-                    {
-                        if (pClassLeveledUpIn->m_bHasDomains && (nMultiClassLevel[nMultiClassLeveledUpIn] == 1))
-                        {
-                            if ((nFeat == nDomainFeat1) || (nFeat == nDomainFeat2))
-                            {
-                                listFeats.insert(nFeat);
-                                bGranted = true;
-                            }
-                        }
-                    }
+                // Check if we already know the spell
+                if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].find(nSpellID) !=
+                    listSpells[nMultiClassLeveledUpIn][nSpellLevel].end())
+                {
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellAlreadyKnown, STRREF_SPELL_LEARNED_TWICE);
+                }
 
-                    // Check if it's the "EpicCharacter" feat and we're level 21
-                    if (!bGranted)
+                // Check if we're a wizard and haven't exceeded the number of spells we can add
+                if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
+                {
+                    if (nSpellLevel != 0)
                     {
-                        if (nLevel == CHARACTER_EPIC_LEVEL && nFeat == Feat::EpicCharacter)
+                        if (!nNumberWizardSpellsToAdd)
                         {
-                            listFeats.insert(nFeat);
-                            bGranted = true;
+                            Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellWizardExceedsNumSpellsToAdd, STRREF_SPELL_ILLEGAL_NUM_SPELLS);
                         }
-                    }
-
-                    // Not a granted feat, add it to listChosenFeats
-                    if (!bGranted)
-                    {
-                        listChosenFeats.insert(nFeat);
+                        nNumberWizardSpellsToAdd--;
                     }
                 }
 
-                // Check the requirements of the chosen feats
-                for (uint16_t nFeat : listChosenFeats)
+                // Add the spell to our list
+                listSpells[nMultiClassLeveledUpIn][nSpellLevel].insert(nSpellID);
+
+                // Reset the spell id
+                nELCSpellID = -1;
+            }
+
+            // Check Bard/Sorc removed spells
+            for (int nSpellIndex = 0;
+                 nSpellIndex < pLevelStats->m_pRemovedKnownSpellList[nSpellLevel].num; nSpellIndex++)
+            {
+                if (!pClassLeveledUpIn->m_bSpellbookRestricted || pClassLeveledUpIn->m_bNeedsToMemorizeSpells ||
+                    (nMultiClassLevel[nMultiClassLeveledUpIn] == 1) ||
+                    !pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
+                                                               nSpellLevel, nClassLeveledUpIn,
+                                                               character.GetRace(),
+                                                               nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
                 {
-                    CNWFeat *pFeat = nFeat < pRules->m_nNumFeats ? &pRules->m_lstFeats[nFeat] : nullptr;
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::IllegalRemovedSpell, STRREF_SPELL_ILLEGAL_REMOVED_SPELLS);
+                }
 
-                    if (!pFeat)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::InvalidFeat,
-                                STRREF_FEAT_INVALID))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                uint32_t nSpellID = pLevelStats->m_pRemovedKnownSpellList[nSpellLevel].element[nSpellIndex];
 
-                    // Set the id of the feat we're checking so we can retrieve it
-                    s_ELCFeatID = nFeat;
+                CNWSpell *pSpell = pRules->m_pSpellArray->GetSpell(nSpellID);
 
-                    // Spell Level Requirements
-                    if (pFeat->m_nMinSpellLevel)
-                    {
-                        bool bSpellLevelMet = false;
+                if (!pSpell)
+                {
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::InvalidSpell, STRREF_SPELL_INVALID_SPELL);
+                }
 
-                        for (int nMultiClass = 0;
-                             !bSpellLevelMet && (nMultiClass < pCreatureStats->m_nNumMultiClasses); nMultiClass++)
-                        {
-                            if (nMultiClassLevel[nMultiClass])
-                            {
-                                uint8_t nClass = pCreatureStats->GetClass(nMultiClass);
-                                CNWClass *pClass = &pRules->m_lstClasses[nClass];
+                // Store te spell id so we can retrieve it later
+                nELCSpellID = nSpellID;
 
-                                if (pClass->m_bIsSpellCasterClass)
-                                {
-                                    if (!pClass->m_bNeedsToMemorizeSpells)
-                                    {
-                                        if (pClass->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClass],
-                                                                           pFeat->m_nMinSpellLevel,
-                                                                           nClass, pCreatureStats->m_nRace,
-                                                                           nAbilityAtLevel[pClass->m_nSpellcastingAbility]))
-                                        {
-                                            bSpellLevelMet = true;
-                                        }
-                                    }
-                                    else
-                                    {
-                                        if (pCreatureStats->GetSpellGainWithBonus(nMultiClass, pFeat->m_nMinSpellLevel))
-                                        {
-                                            bSpellLevelMet = true;
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                // Check if we actually know the spell
+                if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].find(nSpellID) ==
+                    listSpells[nMultiClassLeveledUpIn][nSpellLevel].end())
+                {
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::RemovedNotKnownSpell, STRREF_SPELL_ILLEGAL_REMOVED_SPELLS);
+                }
 
-                        if (!bSpellLevelMet)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Feat,
-                                    ValidationFailureSubType::FeatRequiredSpellLevelNotMet,
-                                    STRREF_FEAT_REQ_SPELL_LEVEL))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-                    }
+                // Remove the spell from our list
+                listSpells[nMultiClassLeveledUpIn][nSpellLevel].erase(nSpellID);
 
-                    // Ability Requirements
-                    uint8_t nBaseAttackBonus = 0;
+                // Reset the spell id
+                nELCSpellID = -1;
+            }
+        }
 
-                    for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
-                    {
-                        if (nMultiClassLevel[nMultiClass])
-                        {
-                            CNWClass *pClass = &pRules->m_lstClasses[pCreatureStats->GetClass(nMultiClass)];
+        // Check if we have the valid number of spells
+        if (pClassLeveledUpIn->m_bSpellbookRestricted && !pClassLeveledUpIn->m_bCanLearnFromScrolls)
+        {
+            for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+            {
+                if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].size() >
+                    pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
+                                                              nSpellLevel, nClassLeveledUpIn,
+                                                              character.GetRace(),
+                                                              nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
+                {
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::InvalidNumSpells, STRREF_SPELL_ILLEGAL_NUM_SPELLS);
+                }
+            }
+        }
+// **************************************************************************************************************************
+    }
+    // All levels processed, hurray!
 
-                            nBaseAttackBonus += pClass->GetAttackBonus(nMultiClassLevel[nMultiClass]);
-                        }
+    // Final Spells Check
+    // Check if our list of spells from LevelStats are the same as the spells the character knows
+    for (int nMultiClass = 0; nMultiClass < character.GetNumMultiClasses(); nMultiClass++)
+    {
+        auto *pClass = &pRules->m_lstClasses[character.GetClass(nMultiClass)];
+        // We skip wizard because they can learn spells from scrolls
+        if (!pClass->m_bCanLearnFromScrolls)
+        {
+            for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+            {
+                //  NOTE: Not sure if this is still needed, removing it for now.
+                /*
+                if (nSpellLevel != 0 || !(pClass->m_bSpellbookRestricted && pClass->m_bCanLearnFromScrolls))
+                {
+                */
+                for (int nSpellIndex = 0;
+                     nSpellIndex < character.GetNumberKnownSpells(nMultiClass, nSpellLevel); nSpellIndex++)
+                {
+                    if (listSpells[nMultiClass][nSpellLevel].empty())
+                    {
+                        Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellListComparison, STRREF_SPELL_ILLEGAL_NUM_SPELLS);
                     }
 
-                    if (pFeat->m_nMinAttackBonus > nBaseAttackBonus)
+                    uint32_t nSpellID = character.GetKnownSpell(nMultiClass, nSpellLevel, nSpellIndex);
+
+                    // Store the spell id so we can retrieve it later
+                    nELCSpellID = nSpellID;
+
+                    if (listSpells[nMultiClass][nSpellLevel].find(nSpellID) ==
+                        listSpells[nMultiClass][nSpellLevel].end())
                     {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredBaseAttackBonusNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
+                        Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellListComparison, STRREF_SPELL_ILLEGAL_NUM_SPELLS);
                     }
 
-                    if (pFeat->m_nMinSTR > nAbilityAtLevel[Ability::Strength] + pRace->m_nSTRAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
-
-                    if (pFeat->m_nMinDEX > nAbilityAtLevel[Ability::Dexterity] + pRace->m_nDEXAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                    listSpells[nMultiClass][nSpellLevel].erase(nSpellID);
 
-                    if (pFeat->m_nMinINT > nAbilityAtLevel[Ability::Intelligence] + pRace->m_nINTAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
-
-                    if (pFeat->m_nMinWIS > nAbilityAtLevel[Ability::Wisdom] + pRace->m_nWISAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
-
-                    if (pFeat->m_nMinCON > nAbilityAtLevel[Ability::Constitution] + pRace->m_nCONAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                    // Reset the spell id
+                    nELCSpellID = -1;
+                }
 
-                    if (pFeat->m_nMinCHA > nAbilityAtLevel[Ability::Charisma] + pRace->m_nCHAAdjust)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredAbilityValueNotMet,
-                                STRREF_FEAT_REQ_ABILITY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                if (!listSpells[nMultiClass][nSpellLevel].empty())
+                {
+                    Fail(ValidationFailureType::Spell, ValidationFailureSubType::SpellListComparison, STRREF_SPELL_ILLEGAL_NUM_SPELLS);
+                }
+                //}
+            }
+        }
+    }
 
-                    // Skill Focus Feats
-                    auto SkillFocusFeatCheck = [&](uint16_t nReqSkill) -> int32_t
-                    {
-                        if (nReqSkill != (uint16_t) -1)
-                        {
-                            bool bSkillRequirementMet = false;
-                            CNWSkill *pReqSkill = &pRules->m_lstSkills[nReqSkill];
+    // Final Skills Check
+    // Compare our calculated rank with the saved rank
+    for (int nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+    {
+        // Store the skill id so we can retrieve it later
+        nELCSkillID = nSkill;
 
-                            if (pReqSkill->m_bUntrained)
-                            {
-                                // Make sure we have a class that can use the skill
-                                for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
-                                {
-                                    if (pRules->m_lstClasses[pCreatureStats->GetClass(nMultiClass)].IsSkillUseable(
-                                            nReqSkill))
-                                    {
-                                        bSkillRequirementMet = true;
-                                    }
-                                }
+        if (listSkillRanks[nSkill] != (uint8_t) character.GetSkillRank(nSkill))
+        {
+            Fail(ValidationFailureType::Skill, ValidationFailureSubType::SkillListComparison, STRREF_SKILL_INVALID_RANKS);
+        }
 
-                                if (!bSkillRequirementMet)
-                                {
-                                    return STRREF_FEAT_REQ_SKILL;
-                                }
-                            }
+        // Reset the skill id
+        nELCSkillID = -1;
+    }
 
-                            if (!bSkillRequirementMet)
-                            {
-                                if (listSkillRanks[nReqSkill] > 0)
-                                {
-                                    bSkillRequirementMet = true;
-                                }
-                                else
-                                {
-                                    return STRREF_FEAT_REQ_SKILL;
-                                }
-                            }
+    // Final Feats Check
+    // Check if our list of feats from LevelStats are the same as the feats the character has
+    for (int nFeatIndex = 0; nFeatIndex < character.GetNumFeats(); nFeatIndex++)
+    {
+        if (listFeats.empty())
+        {
+            Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatListComparison, STRREF_FEAT_TOO_MANY);
+        }
 
-                            uint16_t nSkillRanks = pFeat->m_nMinRequiredSkillRank2;
+        uint16_t nFeat = character.GetFeat(nFeatIndex);
 
-                            if (listSkillRanks[nReqSkill] < nSkillRanks)
-                            {
-                                return STRREF_SKILL_UNUSEABLE;
-                            }
-                        }
+        // Store the skill id so we can retrieve it later
+        nELCFeatID = nFeat;
 
-                        return 0;
-                    };
+        if (listFeats.find(nFeat) == listFeats.end())
+        {
+            Fail(ValidationFailureType::Feat, ValidationFailureSubType::FeatListComparison, STRREF_FEAT_TOO_MANY);
+        }
 
-                    int32_t retVal = SkillFocusFeatCheck(pFeat->m_nRequiredSkill);
-                    if (retVal)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredSkillNotMet,
-                                retVal))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+        listFeats.erase(nFeat);
 
-                    retVal = SkillFocusFeatCheck(pFeat->m_nRequiredSkill2);
-                    if (retVal)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredSkillNotMet,
-                                retVal))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+        // Reset the feat id
+        nELCFeatID = -1;
+    }
 
-                    // Check Feat Prereqs
-                    auto PrerequisitesFeatCheck = [&](uint16_t nPrereqFeat) -> int32_t
-                    {
-                        if (nPrereqFeat != (uint16_t) -1)
-                        {
-                            if (listFeats.find(nPrereqFeat) == listFeats.end() &&
-                                listChosenFeats.find(nPrereqFeat) == listChosenFeats.end())
-                            {
-                                return STRREF_FEAT_REQ_FEAT;
-                            }
-                        }
+    // Check Misc Saving Throws
+    if (character.HasMiscSavingThrows())
+    {
+        Fail(ValidationFailureType::Character, ValidationFailureSubType::MiscSavingThrow, STRREF_CHARACTER_SAVING_THROW);
+    }
 
-                        return 0;
-                    };
+    // Compare Feats Lists
+    int32_t nNumberOfFeats = 0;
+    for (int nLevel = 1; nLevel <= nCharacterLevel; nLevel++)
+    {
+        auto *pLevelStats = character.GetLevelStats(nLevel);
+        nNumberOfFeats += pLevelStats->m_lstFeats.num;
+    }
 
-                    retVal = PrerequisitesFeatCheck(pFeat->m_lstPrereqFeats[0]);
-                    if (retVal)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredFeatNotMet,
-                                retVal))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+    if (character.GetNumFeats() > nNumberOfFeats)
+    {
+        Fail(ValidationFailureType::Feat, ValidationFailureSubType::NumFeatComparison, STRREF_FEAT_INVALID);
+    }
 
-                    retVal = PrerequisitesFeatCheck(pFeat->m_lstPrereqFeats[1]);
-                    if (retVal)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredFeatNotMet,
-                                retVal))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+    return failures;
+}
 
-                    // The feat requires a "OrPrereq" feat
-                    bool bHasOrPrereqFeat = false;
-                    // The character has one of these feats
-                    bool bOrPrereqFeatAcquired = false;
+static auto s_ValidateCharacter = Hooks::HookFunction(&CNWSPlayer::ValidateCharacter,
+        +[](CNWSPlayer *pPlayer, int32_t *bFailedServerRestriction) -> int32_t
+        {
+            // Reset Variables
+            s_ILRItemOID = Constants::OBJECT_INVALID;
+            s_ELCLevel = -1;
+            s_ELCSkillID = -1;
+            s_ELCFeatID = -1;
+            s_ELCSpellID = -1;
 
-                    for (int32_t nOrPrereqFeat = 0; !bOrPrereqFeatAcquired && nOrPrereqFeat < 5; nOrPrereqFeat++)
-                    {
-                        uint16_t nPrereqFeat = pFeat->m_lstOrPrereqFeats[nOrPrereqFeat];
+            // *** Sanity Checks ****************************************************************************************************
+            if (!pPlayer)
+                return STRREF_CHARACTER_DOES_NOT_EXIST;
 
-                        if (nPrereqFeat != (uint16_t) -1)
-                        {
-                            bHasOrPrereqFeat = true;
-                            bOrPrereqFeatAcquired = listFeats.find(nPrereqFeat) != listFeats.end() ||
-                                                    listChosenFeats.find(nPrereqFeat) != listChosenFeats.end();
-                        }
-                    }
+            CGameObject *pGameObject = Utils::GetGameObject(pPlayer->m_oidNWSObject);
+            if (!pGameObject)
+                return STRREF_CHARACTER_DOES_NOT_EXIST;
 
-                    if (bHasOrPrereqFeat && !bOrPrereqFeatAcquired)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatRequiredFeatNotMet,
-                                STRREF_FEAT_REQ_FEAT))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+            CNWSCreature *pCreature = Utils::AsNWSCreature(pGameObject);
+            if (!pCreature)
+                return STRREF_CHARACTER_DOES_NOT_EXIST;
 
-                    // Reset feat id
-                    s_ELCFeatID = -1;
-                }
+            CNWSCreatureStats *pCreatureStats = pCreature->m_pStats;
+            if (!pCreatureStats)
+                return STRREF_CHARACTER_DOES_NOT_EXIST;
 
-                // Check if we can actually pick our chosen feats this level
-                if (!listChosenFeats.empty() && !nNumberNormalFeats && !nNumberBonusFeats)
-                {
-                    if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Feat,
-                            ValidationFailureSubType::TooManyFeatsThisLevel,
-                            STRREF_FEAT_TOO_MANY))
-                    {
-                        return strrefFailure;
-                    }
-                }
+            CNWSInventory *pInventory = pCreature->m_pInventory;
+            if (!pInventory)
+                return STRREF_CHARACTER_DOES_NOT_EXIST;
+            // **********************************************************************************************************************
 
-                // List to hold moved chosen feats
-                std::vector<uint16_t> listMovedFeats;
+            auto HandleValidationFailure = [&](ValidationFailureType::TYPE type, ValidationFailureSubType::TYPE subType,
+                                               int32_t strRef) -> int32_t
+            {
+                s_skipValidationFailure = false;
+                s_validationFailureType = type;
+                s_validationFailureSubType = subType;
+                s_validationFailureMessageStrRef = strRef;
 
-                for (auto nFeatIndex : listChosenFeats)
+                if (!s_elcScript.empty())
                 {
-                    // Set the id of the feat we're checking so we can retrieve it
-                    s_ELCFeatID = nFeatIndex;
-
-                    int32_t bNormalListFeat;
-                    int32_t bBonusListFeat;
-
-                    pPlayer->ValidateCharacter_SetNormalBonusFlags(nFeatIndex, bNormalListFeat, bBonusListFeat,
-                                                                   nClassLeveledUpIn);
+                    LOG_DEBUG("Running ELC Script '%s' on object '%x' with Type '%i', subType '%i' and strRef '%i'",
+                              s_elcScript, pPlayer->m_oidNWSObject,
+                              s_validationFailureType, s_validationFailureSubType,
+                              s_validationFailureMessageStrRef);
 
-                    // Not available to class
-                    if (!bNormalListFeat && !bBonusListFeat)
-                    {
-                        if (auto strrefFailure = HandleValidationFailure(
-                                ValidationFailureType::Feat,
-                                ValidationFailureSubType::FeatNotAvailableToClass,
-                                STRREF_FEAT_TOO_MANY))
-                        {
-                            return strrefFailure;
-                        }
-                    }
+                    ++s_elcDepth;
+                    Utils::ExecuteScript(s_elcScript, pPlayer->m_oidNWSObject);
+                    --s_elcDepth;
 
-                    // Normal Feat Only
-                    if (bNormalListFeat && !bBonusListFeat)
+                    if (s_skipValidationFailure)
                     {
-                        if (!nNumberNormalFeats)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Feat,
-                                    ValidationFailureSubType::FeatIsNormalFeatOnly,
-                                    STRREF_FEAT_TOO_MANY))
-                            {
-                                return strrefFailure;
-                            }
-                        }
+                        LOG_DEBUG("Skipping ELC Validation Failure of object '%x' with Type '%i', subType '%i' and strRef '%i'",
+                                  pPlayer->m_oidNWSObject, s_validationFailureType,
+                                  s_validationFailureSubType,
+                                  s_validationFailureMessageStrRef);
 
-                        // Move the feat from our level list to the main list
-                        listFeats.insert(nFeatIndex);
-                        // Add the feat that's being moved to a different list because removing stuff while iterating is bad
-                        listMovedFeats.push_back(nFeatIndex);
-                        nNumberNormalFeats--;
+                        s_validationFailureMessageStrRef = 0;
                     }
+                }
 
-                    // Bonus Feat Only
-                    if (!bNormalListFeat && bBonusListFeat)
-                    {
-                        if (!nNumberBonusFeats)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Feat,
-                                    ValidationFailureSubType::FeatIsBonusFeatOnly,
-                                    STRREF_FEAT_TOO_MANY))
-                            {
-                                return strrefFailure;
-                            }
-                        }
+                return s_validationFailureMessageStrRef;
+            };
 
-                        // Move the feat from our level list to the main list
-                        listFeats.insert(nFeatIndex);
-                        // Add the feat that's being moved to a different list because removing stuff while iterating is bad
-                        listMovedFeats.push_back(nFeatIndex);
-                        nNumberBonusFeats--;
-                    }
+            MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_ELC_VALIDATE_CHARACTER_BEFORE",
+                                                             Utils::ObjectIDToString(pPlayer->m_oidNWSObject)});
 
-                    // Reset the feat id
-                    s_ELCFeatID = -1;
-                }
+            // *** Server Restrictions **********************************************************************************************
+            CServerInfo *pServerInfo = Globals::AppManager()->m_pServerExoApp->GetServerInfo();
+
+            *bFailedServerRestriction = false;
+            uint8_t nCharacterLevel = pCreatureStats->GetLevel(false);
 
-                // Remove the moved feats from the chosen feat list
-                for (auto remove : listMovedFeats)
+            // Start the per-level checks on a worker thread while the checks below run the engine and the ELC script
+            std::future<std::vector<ValidationFailure>> pendingLevelChecks;
+            if (s_asyncValidation && pServerInfo->m_PlayOptions.bEnforceLegalCharacters)
+            {
+                if (auto pSnapshot = TakeCharacterSnapshot(pPlayer, pCreatureStats, nCharacterLevel))
                 {
-                    listChosenFeats.erase(remove);
+                    auto params = GetLevelCheckParams(pCreature, nCharacterLevel, GetRulesSnapshot());
+                    pendingLevelChecks = std::async(std::launch::async,
+                        [pSnapshot = std::move(pSnapshot), params]() { return ValidateLevels(*pSnapshot, params); });
                 }
-                listMovedFeats.clear();
+            }
 
-                // The feats that are left can be normal or bonus
-                for (auto nFeatIndex : listChosenFeats)
+            // *** Level Restriction Check ******************************************************************************************
+            if (nCharacterLevel < pServerInfo->m_JoiningRestrictions.nMinLevel ||
+                nCharacterLevel > pServerInfo->m_JoiningRestrictions.nMaxLevel)
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::ServerLevelRestriction,
+                        STRREF_CHARACTER_LEVEL_RESTRICTION))
                 {
-                    // Set the id of the feat we're checking so we can retrieve it
-                    s_ELCFeatID = nFeatIndex;
-
-                    if (nNumberBonusFeats)
-                    {
-                        // Move the feat from our level list to the main list
-                        listFeats.insert(nFeatIndex);
-                        // Add the feat that's being moved to a different list because removing stuff while iterating is bad
-                        listMovedFeats.push_back(nFeatIndex);
-                        nNumberBonusFeats--;
-                    }
-                    else
-                    {
-                        if (nNumberNormalFeats)
-                        {
-                            // Move the feat from our level list to the main list
-                            listFeats.insert(nFeatIndex);
-                            // Add the feat that's being moved to a different list because removing stuff while iterating is bad
-                            listMovedFeats.push_back(nFeatIndex);
-                            nNumberNormalFeats--;
-                        }
-                        else
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Feat,
-                                    ValidationFailureSubType::TooManyFeatsThisLevel,
-                                    STRREF_FEAT_TOO_MANY))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-                    }
-
-                    // Reset the feat id
-                    s_ELCFeatID = -1;
+                    *bFailedServerRestriction = true;
+                    return strrefFailure;
                 }
+            }
+            // **********************************************************************************************************************
 
-                // Remove the moved feats from the chosen feat list
-                for (auto remove : listMovedFeats)
+            if (pCreatureStats->m_nNumMultiClasses > std::clamp<int32_t>(Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("MULTICLASS_LIMIT"), 3), 1, 8))
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::NumMulticlass,
+                        STRREF_CHARACTER_NUMBERMULTICLASSES))
                 {
-                    listChosenFeats.erase(remove);
+                    *bFailedServerRestriction = true;
+                    return strrefFailure;
                 }
-                listMovedFeats.clear();
-// **************************************************************************************************************************
-
+            }
 
-// *** Check Known Spells ***************************************************************************************************
-                uint32_t nNumberWizardSpellsToAdd = 0;
+            // *** Level Hack Check *************************************************************************************************
+            // Character level is stored in an uint8_t which means if a character has say 80/80/120 as their levels it'll wrap around
+            // to level 24 (280 - 256) thus not failing the above check
+            int32_t nTotalLevels = 0;
+            for (int i = 0; i < pCreatureStats->m_nNumMultiClasses; i++)
+            {
+                nTotalLevels += pCreatureStats->GetClassLevel(i, false);
 
-                // Calculate the num of spells a wizard can add
-                if (pClassLeveledUpIn->m_bCanLearnFromScrolls)
+                if (nTotalLevels > pServerInfo->m_JoiningRestrictions.nMaxLevel)
                 {
-                    if (nMultiClassLevel[nMultiClassLeveledUpIn] == 1)
-                    {
-                        nNumberWizardSpellsToAdd = 3 + std::max((char) 0,
-                                                                pCreatureStats->CalcStatModifier(
-                                                                        nAbilityAtLevel[Ability::Intelligence] +
-                                                                        pRace->m_nINTAdjust));
-                    }
-                    else
+                    if (auto strrefFailure = HandleValidationFailure(
+                            ValidationFailureType::Character,
+                            ValidationFailureSubType::LevelHack,
+                            STRREF_CHARACTER_LEVEL_RESTRICTION))
                     {
-                        nNumberWizardSpellsToAdd = 2;
+                        *bFailedServerRestriction = true;
+                        return strrefFailure;
                     }
                 }
+            }
+            // **********************************************************************************************************************
+
+            // *** Colored Name Checking ********************************************************************************************
+            auto CheckColoredName = [](CExoLocString &lsName) -> bool
+            {
+                int32_t nID;
+                CExoString sName;
+                uint8_t nGender;
 
-                for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+                for (uint32_t i = 0; i < lsName.GetStringCount(); i++)
                 {
-                    for (int nSpellIndex = 0;
-                         nSpellIndex < pLevelStats->m_pAddedKnownSpellList[nSpellLevel].num; nSpellIndex++)
+                    if (lsName.GetString(i, &nID, &sName, &nGender))
                     {
-                        // Can we add spells this level?
-                        if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
-                        {
-                            if (!pClassLeveledUpIn->GetSpellGain(nMultiClassLevel[nMultiClassLeveledUpIn], nSpellLevel))
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Spell,
-                                        ValidationFailureSubType::SpellInvalidSpellGainWizard,
-                                        STRREF_SPELL_ILLEGAL_LEVEL))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
-                        }
-                        else if (pClassLeveledUpIn->m_bSpellbookRestricted && !pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
-                        {
-                            if (!pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
-                                                                           nSpellLevel,
-                                                                           nClassLeveledUpIn, pCreatureStats->m_nRace,
-                                                                           nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Spell,
-                                        ValidationFailureSubType::SpellInvalidSpellGainBardSorcerer,
-                                        STRREF_SPELL_ILLEGAL_LEVEL))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::SpellInvalidSpellGainOtherClasses,
-                                    STRREF_SPELL_ILLEGAL_LEVEL))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        uint32_t nSpellID = pLevelStats->m_pAddedKnownSpellList[nSpellLevel].element[nSpellIndex];
-                        CNWSpell *pSpell = pRules->m_pSpellArray->GetSpell(nSpellID);
-
-                        if (!pSpell)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::InvalidSpell,
-                                    STRREF_SPELL_INVALID_SPELL))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        // Store the spell id so we can retrieve it later
-                        s_ELCSpellID = nSpellID;
-
-                        // Check the spell level
-                        if (pSpell->GetSpellLevel(nClassLeveledUpIn) != nSpellLevel)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::SpellInvalidSpellLevel,
-                                    STRREF_SPELL_REQ_SPELL_LEVEL))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        // Check for minimum ability
-                        if (pClassLeveledUpIn->m_bSpellbookRestricted)
-                        {
-                            if (nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility] < 10 + nSpellLevel)
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Spell,
-                                        ValidationFailureSubType::SpellMinimumAbility,
-                                        STRREF_SPELL_REQ_ABILITY))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
-                        }
-
-                        // Check Opposition School
-                        if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
-                        {
-                            uint8_t nSchool = pCreatureStats->GetSchool(nClassLeveledUpIn);
-
-                            if (nSchool != 0)
-                            {
-                                int32_t nOppositionSchool;
-                                if (pRules->m_p2DArrays->GetSpellSchoolTable()->GetINTEntry(nSchool, "Opposition", &nOppositionSchool))
-                                {
-                                    if (pSpell->m_nSchool == (uint8_t) nOppositionSchool)
-                                    {
-                                        if (auto strrefFailure = HandleValidationFailure(
-                                                ValidationFailureType::Spell,
-                                                ValidationFailureSubType::SpellRestrictedSpellSchool,
-                                                STRREF_SPELL_OPPOSITE_SPELL_SCHOOL))
-                                        {
-                                            return strrefFailure;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        // Check if we already know the spell
-                        if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].find(nSpellID) !=
-                            listSpells[nMultiClassLeveledUpIn][nSpellLevel].end())
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::SpellAlreadyKnown,
-                                    STRREF_SPELL_LEARNED_TWICE))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        // Check if we're a wizard and haven't exceeded the number of spells we can add
-                        if (pClassLeveledUpIn->m_bSpellbookRestricted && pClassLeveledUpIn->m_bNeedsToMemorizeSpells)
+                        if (sName.Find("<c", 0) >= 0)
                         {
-                            if (nSpellLevel != 0)
-                            {
-                                if (!nNumberWizardSpellsToAdd)
-                                {
-                                    if (auto strrefFailure = HandleValidationFailure(
-                                            ValidationFailureType::Spell,
-                                            ValidationFailureSubType::SpellWizardExceedsNumSpellsToAdd,
-                                            STRREF_SPELL_ILLEGAL_NUM_SPELLS))
-                                    {
-                                        return strrefFailure;
-                                    }
-                                }
-                                nNumberWizardSpellsToAdd--;
-                            }
+                            return true;
                         }
-
-                        // Add the spell to our list
-                        listSpells[nMultiClassLeveledUpIn][nSpellLevel].insert(nSpellID);
-
-                        // Reset the spell id
-                        s_ELCSpellID = -1;
                     }
+                }
 
-                    // Check Bard/Sorc removed spells
-                    for (int nSpellIndex = 0;
-                         nSpellIndex < pLevelStats->m_pRemovedKnownSpellList[nSpellLevel].num; nSpellIndex++)
-                    {
-                        if (!pClassLeveledUpIn->m_bSpellbookRestricted || pClassLeveledUpIn->m_bNeedsToMemorizeSpells ||
-                            (nMultiClassLevel[nMultiClassLeveledUpIn] == 1) ||
-                            !pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
-                                                                       nSpellLevel, nClassLeveledUpIn,
-                                                                       pCreatureStats->m_nRace,
-                                                                       nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::IllegalRemovedSpell,
-                                    STRREF_SPELL_ILLEGAL_REMOVED_SPELLS))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-
-                        uint32_t nSpellID = pLevelStats->m_pRemovedKnownSpellList[nSpellLevel].element[nSpellIndex];
+                return false;
+            };
 
-                        CNWSpell *pSpell = pRules->m_pSpellArray->GetSpell(nSpellID);
+            if (CheckColoredName(pCreatureStats->m_lsFirstName) || CheckColoredName(pCreatureStats->m_lsLastName))
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::ColoredName,
+                        STRREF_CHARACTER_DOES_NOT_EXIST))
+                {
+                    *bFailedServerRestriction = true;
+                    return strrefFailure;
+                }
+            }
+            // **********************************************************************************************************************
 
-                        if (!pSpell)
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::InvalidSpell,
-                                    STRREF_SPELL_INVALID_SPELL))
-                            {
-                                return strrefFailure;
-                            }
-                        }
+            // *** ILR aka Inventory Checks *****************************************************************************************
 
-                        // Store te spell id so we can retrieve it later
-                        s_ELCSpellID = nSpellID;
+            // Only check if ILR is enabled
+            if (pServerInfo->m_PlayOptions.bItemLevelRestrictions)
+            {
+                for (int slot = 0; slot <= (InventorySlot::MAX - NUM_CREATURE_ITEM_SLOTS); slot++)
+                {
+                    CNWSItem *pItem = pInventory->GetItemInSlot(slot);
 
-                        // Check if we actually know the spell
-                        if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].find(nSpellID) ==
-                            listSpells[nMultiClassLeveledUpIn][nSpellLevel].end())
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::RemovedNotKnownSpell,
-                                    STRREF_SPELL_ILLEGAL_REMOVED_SPELLS))
-                            {
-                                return strrefFailure;
-                            }
-                        }
+                    if (!pItem)
+                        continue;
 
-                        // Remove the spell from our list
-                        listSpells[nMultiClassLeveledUpIn][nSpellLevel].erase(nSpellID);
+                    // Store the item oid so we can retrieve it in the ELC script
+                    s_ILRItemOID = pItem->m_idSelf;
 
-                        // Reset the spell id
-                        s_ELCSpellID = -1;
+                    // Check for unidentified equipped items
+                    if (!pItem->m_bIdentified)
+                    {
+                        if (auto strrefFailure = HandleValidationFailure(
+                                ValidationFailureType::Item,
+                                ValidationFailureSubType::UnidentifiedEquippedItem,
+                                STRREF_ITEM_LEVEL_RESTRICTION))
+                        {
+                            *bFailedServerRestriction = true;
+                            return strrefFailure;
+                        }
                     }
-                }
 
-                // Check if we have the valid number of spells
-                if (pClassLeveledUpIn->m_bSpellbookRestricted && !pClassLeveledUpIn->m_bCanLearnFromScrolls)
-                {
-                    for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
+                    // Check the minimum equip level
+                    if (pItem->GetMinEquipLevel() > nCharacterLevel)
                     {
-                        if (listSpells[nMultiClassLeveledUpIn][nSpellLevel].size() >
-                            pClassLeveledUpIn->GetSpellsKnownPerLevel(nMultiClassLevel[nMultiClassLeveledUpIn],
-                                                                      nSpellLevel, nClassLeveledUpIn,
-                                                                      pCreatureStats->m_nRace,
-                                                                      nAbilityAtLevel[pClassLeveledUpIn->m_nSpellcastingAbility]))
+                        if (auto strrefFailure = HandleValidationFailure(
+                                ValidationFailureType::Item,
+                                ValidationFailureSubType::MinEquipLevel,
+                                STRREF_ITEM_LEVEL_RESTRICTION))
                         {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::InvalidNumSpells,
-                                    STRREF_SPELL_ILLEGAL_NUM_SPELLS))
-                            {
-                                return strrefFailure;
-                            }
+                            *bFailedServerRestriction = true;
+                            return strrefFailure;
                         }
                     }
+
+                    // Reset the item oid
+                    s_ILRItemOID = Constants::OBJECT_INVALID;
                 }
-// **************************************************************************************************************************
             }
-            // All levels processed, hurray!
 
-            // Final Spells Check
-            // Check if our list of spells from LevelStats are the same as the spells the character knows
-            for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
+            // Strip invalid item properties for local vault servers
+            if (pServerInfo->m_JoiningRestrictions.bAllowLocalVaultChars)
             {
-                auto *pClass = &Globals::Rules()->m_lstClasses[pCreatureStats->GetClass(nMultiClass)];
-                // We skip wizard because they can learn spells from scrolls
-                if (!pClass->m_bCanLearnFromScrolls)
-                {
-                    for (int nSpellLevel = 0; nSpellLevel < NUM_SPELL_LEVELS; nSpellLevel++)
-                    {
-                        //  NOTE: Not sure if this is still needed, removing it for now.
-                        /*
-                        if (nSpellLevel != 0 || !(pClass->m_bSpellbookRestricted && pClass->m_bCanLearnFromScrolls))
-                        {
-                        */
-                        for (int nSpellIndex = 0;
-                             nSpellIndex < pCreatureStats->GetNumberKnownSpells(nMultiClass, nSpellLevel); nSpellIndex++)
-                        {
-                            if (listSpells[nMultiClass][nSpellLevel].empty())
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Spell,
-                                        ValidationFailureSubType::SpellListComparison,
-                                        STRREF_SPELL_ILLEGAL_NUM_SPELLS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
+                pPlayer->StripAllInvalidItemPropertiesInInventory(pCreature);
+            }
+            // **********************************************************************************************************************
+
+            // *** Misc Checks ******************************************************************************************************
+            // Set Plot/Immortal to false
+            pCreature->m_bPlotObject = false;
+            pCreature->m_bIsImmortal = false;
+            // **********************************************************************************************************************
 
-                            uint32_t nSpellID = pCreatureStats->GetKnownSpell(nMultiClass, nSpellLevel, nSpellIndex);
+            // *** Character Validation (ELC) ***************************************************************************************
+            CNWRules *pRules = Globals::Rules();
+            const RulesSnapshot *pRulesSnapshot = GetRulesSnapshot();
 
-                            // Store the spell id so we can retrieve it later
-                            s_ELCSpellID = nSpellID;
+            // Return early if ELC is off
+            if (!pServerInfo->m_PlayOptions.bEnforceLegalCharacters)
+            {
+                return 0;
+            }
 
-                            if (listSpells[nMultiClass][nSpellLevel].find(nSpellID) ==
-                                listSpells[nMultiClass][nSpellLevel].end())
-                            {
-                                if (auto strrefFailure = HandleValidationFailure(
-                                        ValidationFailureType::Spell,
-                                        ValidationFailureSubType::SpellListComparison,
-                                        STRREF_SPELL_ILLEGAL_NUM_SPELLS))
-                                {
-                                    return strrefFailure;
-                                }
-                            }
+            // Enforce default event scripts: default.nss
+            if (s_enforceDefaultEventScripts)
+            {
+                for (auto &eventScript : pCreature->m_sScripts)
+                {
+                    eventScript = CExoString("default");
+                }
+            }
 
-                            listSpells[nMultiClass][nSpellLevel].erase(nSpellID);
+            // Enforce empty dialog resref
+            if (s_enforceEmptyDialogResRef)
+            {
+                pCreature->m_pStats->m_cDialog = CResRef("");
+            }
 
-                            // Reset the spell id
-                            s_ELCSpellID = -1;
-                        }
+            // Check for non PC
+            if (!pCreatureStats->m_bIsPC)
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::NonPCCharacter,
+                        STRREF_CHARACTER_NON_PLAYER))
+                {
+                    return strrefFailure;
+                }
+            }
 
-                        if (!listSpells[nMultiClass][nSpellLevel].empty())
-                        {
-                            if (auto strrefFailure = HandleValidationFailure(
-                                    ValidationFailureType::Spell,
-                                    ValidationFailureSubType::SpellListComparison,
-                                    STRREF_SPELL_ILLEGAL_NUM_SPELLS))
-                            {
-                                return strrefFailure;
-                            }
-                        }
-                        //}
-                    }
+            // Check for DM character file
+            if (pCreatureStats->m_bIsDMCharacterFile)
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::DMCharacter,
+                        STRREF_CHARACTER_DUNGEON_MASTER))
+                {
+                    return strrefFailure;
+                }
+            }
+
+            // Check for non player race
+            CNWRace *pRace =
+                    pCreatureStats->m_nRace < pRules->m_nNumRaces ? &pRules->m_lstRaces[pCreatureStats->m_nRace] : nullptr;
+            if (!pRace || !pRace->m_bIsPlayerRace)
+            {
+                if (auto strrefFailure = HandleValidationFailure(
+                        ValidationFailureType::Character,
+                        ValidationFailureSubType::NonPlayerRace,
+                        STRREF_CHARACTER_NON_PLAYER_RACE))
+                {
+                    return strrefFailure;
                 }
             }
 
-            // Final Skills Check
-            // Compare our calculated rank with the saved rank
-            for (int nSkill = 0; nSkill < pRules->m_nNumSkills; nSkill++)
+            // Check for non player classes, class level restrictions and prestige class requirements
+            // We also check class alignment restrictions for new characters only
+            for (int nMultiClass = 0; nMultiClass < pCreatureStats->m_nNumMultiClasses; nMultiClass++)
             {
-                // Store the skill id so we can retrieve it later
-                s_ELCSkillID = nSkill;
+                uint8_t classId = pCreatureStats->m_ClassInfo[nMultiClass].m_nClass;
+
+                CNWClass *pClass = classId < pRules->m_nNumClasses ? &pRules->m_lstClasses[classId] : nullptr;
 
-                if (listSkillRanks[nSkill] != (uint8_t) pCreatureStats->GetSkillRank(nSkill, nullptr, true))
+                if (!pClass || !pClass->m_bIsPlayerClass)
                 {
                     if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Skill,
-                            ValidationFailureSubType::SkillListComparison,
-                            STRREF_SKILL_INVALID_RANKS))
+                            ValidationFailureType::Character,
+                            ValidationFailureSubType::NonPlayerClass,
+                            STRREF_CHARACTER_NON_PLAYER_CLASS))
                     {
                         return strrefFailure;
                     }
                 }
 
-                // Reset the skill id
-                s_ELCSkillID = -1;
-            }
-
-            // Final Feats Check
-            // Check if our list of feats from LevelStats are the same as the feats the character has
-            for (int nFeatIndex = 0; nFeatIndex < pCreatureStats->m_lstFeats.num; nFeatIndex++)
-            {
-                if (listFeats.empty())
+                if (pClass->m_nMaxLevel > 0 && pCreatureStats->GetClassLevel(nMultiClass, false) > pClass->m_nMaxLevel)
                 {
                     if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Feat,
-                            ValidationFailureSubType::FeatListComparison,
-                            STRREF_FEAT_TOO_MANY))
+                            ValidationFailureType::Character,
+                            ValidationFailureSubType::ClassLevelRestriction,
+                            STRREF_CHARACTER_NON_PLAYER_CLASS))
                     {
                         return strrefFailure;
                     }
                 }
 
-                uint16_t nFeat = pCreatureStats->m_lstFeats.element[nFeatIndex];
-
-                // Store the skill id so we can retrieve it later
-                s_ELCFeatID = nFeat;
-
-                if (listFeats.find(nFeat) == listFeats.end())
+                if (!pCreatureStats->GetMeetsPrestigeClassRequirements(pClass))
                 {
                     if (auto strrefFailure = HandleValidationFailure(
-                            ValidationFailureType::Feat,
-                            ValidationFailureSubType::FeatListComparison,
-                            STRREF_FEAT_TOO_MANY))
+                            ValidationFailureType::Character,
+                            ValidationFailureSubType::PrestigeClassRequirements,
+                            STRREF_CHARACTER_NON_PLAYER_CLASS))
                     {
                         return strrefFailure;
                     }
                 }
 
-                listFeats.erase(nFeat);
+                if (nMultiClass == 0 && nCharacterLevel == 1 && pCreatureStats->m_nExperience == 0)
+                {
+                    if (!pClass->GetIsAlignmentAllowed(pCreatureStats->GetSimpleAlignmentGoodEvil(),
+                                                       pCreatureStats->GetSimpleAlignmentLawChaos()))
+                    {
+                        if (auto strrefFailure = HandleValidationFailure(
+                                ValidationFailureType::Character,
+                                ValidationFailureSubType::ClassAlignmentRestriction,
+                                STRREF_CHARACTER_NON_PLAYER_CLASS))
+                        {
+                            return strrefFailure;
+                        }
+                    }
+                }
+            }
 
-                // Reset the feat id
-                s_ELCFeatID = -1;
+            // Check movement rate
+            if (pCreatureStats->m_nMovementRate != MovementRate::PC)
+            {
+                pCreatureStats->SetMovementRate(MovementRate::PC);
             }
 
-            // Check Misc Saving Throws
-            if (pCreatureStats->m_nFortSavingThrowMisc > 0 ||
-                pCreatureStats->m_nReflexSavingThrowMisc > 0 ||
-                pCreatureStats->m_nWillSavingThrowMisc > 0)
+            // Calculate Ability Scores
+            uint8_t nAbility[6] = {0};
+            GetStartingAbilities(pCreature, nCharacterLevel, nAbility);
+
+            static int32_t charGenBaseAbilityMin = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_BASE_ABILITY_MIN"), 8);
+            static int32_t charGenBaseAbilityMax = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_BASE_ABILITY_MAX"), 18);
+
+            // Check if >18 in an ability
+            for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
             {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Character,
-                        ValidationFailureSubType::MiscSavingThrow,
-                        STRREF_CHARACTER_SAVING_THROW))
+                if (nAbility[nAbilityIndex] > charGenBaseAbilityMax)
                 {
-                    return strrefFailure;
+                    if (auto strrefFailure = HandleValidationFailure(
+                            ValidationFailureType::Character,
+                            ValidationFailureSubType::StartingAbilityValueMax,
+                            STRREF_CHARACTER_INVALID_ABILITY_SCORES))
+                    {
+                        return strrefFailure;
+                    }
                 }
             }
 
-            // Compare Feats Lists
-            int32_t nNumberOfFeats = 0;
-            for (int nLevel = 1; nLevel <= nCharacterLevel; nLevel++)
+            // Point Buy System calculation
+            uint8_t nPointBuy = pRace->m_nAbilitiesPointBuyNumber;
+
+            static int32_t abilityCostIncrement2 = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_ABILITY_COST_INCREMENT2"), 14);
+            static int32_t abilityCostIncrement3 = Globals::Rules()->GetRulesetIntEntry(CRULES_HASHEDSTR("CHARGEN_ABILITY_COST_INCREMENT3"), 16);
+
+            for (int nAbilityIndex = 0; nAbilityIndex < Ability::MAX; nAbilityIndex++)
             {
-                CNWLevelStats *pLevelStats = pCreatureStats->GetLevelStats(nLevel - 1);
-                nNumberOfFeats += pLevelStats->m_lstFeats.num;
+                while (nAbility[nAbilityIndex] > charGenBaseAbilityMin)
+                {
+                    if (nAbility[nAbilityIndex] > abilityCostIncrement3)
+                    {
+                        if (nPointBuy < 3)
+                        {
+                            if (auto strrefFailure = HandleValidationFailure(
+                                    ValidationFailureType::Character,
+                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
+                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
+                            {
+                                return strrefFailure;
+                            }
+                        }
+
+                        nAbility[nAbilityIndex]--;
+                        nPointBuy -= 3;
+                    }
+                    else if (nAbility[nAbilityIndex] > abilityCostIncrement2)
+                    {
+                        if (nPointBuy < 2)
+                        {
+                            if (auto strrefFailure = HandleValidationFailure(
+                                    ValidationFailureType::Character,
+                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
+                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
+                            {
+                                return strrefFailure;
+                            }
+                        }
+
+                        nAbility[nAbilityIndex]--;
+                        nPointBuy -= 2;
+                    }
+                    else
+                    {
+                        if (nPointBuy < 1)
+                        {
+                            if (auto strrefFailure = HandleValidationFailure(
+                                    ValidationFailureType::Character,
+                                    ValidationFailureSubType::AbilityPointBuySystemCalculation,
+                                    STRREF_CHARACTER_INVALID_ABILITY_SCORES))
+                            {
+                                return strrefFailure;
+                            }
+                        }
+
+                        nAbility[nAbilityIndex]--;
+                        nPointBuy--;
+                    }
+                }
             }
 
-            if (pCreatureStats->m_lstFeats.num > nNumberOfFeats)
+            // Per-level checks and the final comparisons, replayed through the ELC script in the order they were found
+            std::vector<ValidationFailure> failures = pendingLevelChecks.valid() ?
+                    pendingLevelChecks.get() :
+                    ValidateLevels(LiveCharacter{pPlayer, pCreatureStats},
+                                   GetLevelCheckParams(pCreature, nCharacterLevel, pRulesSnapshot));
+
+            for (auto& failure : failures)
             {
-                if (auto strrefFailure = HandleValidationFailure(
-                        ValidationFailureType::Feat,
-                        ValidationFailureSubType::NumFeatComparison,
-                        STRREF_FEAT_INVALID))
+                s_ELCLevel = failure.m_nLevel;
+                s_ELCSkillID = failure.m_nSkillID;
+                s_ELCFeatID = failure.m_nFeatID;
+                s_ELCSpellID = failure.m_nSpellID;
+
+                if (auto strrefFailure = HandleValidationFailure(failure.m_type, failure.m_subType, failure.m_nStrRef))
                 {
                     return strrefFailure;
                 }
             }
 
+            s_ELCLevel = nCharacterLevel ? nCharacterLevel : -1;
+            s_ELCSkillID = -1;
+            s_ELCFeatID = -1;
+            s_ELCSpellID = -1;
+
             // Run a custom ELC check if enabled and there is an ELC script set
             if (s_enableCustomELCCheck)
             {
@@ -1993,3 +2203,51 @@ NWNX_EXPORT ArgumentStack GetValidationFailureSpellID(ArgumentStack&&)
 
     return s_ELCSpellID;
 }
+
+NWNX_EXPORT ArgumentStack CompareValidators(ArgumentStack&& args)
+{
+    const auto oidPlayer = args.extract<ObjectID>();
+      ASSERT_OR_THROW(oidPlayer != Constants::OBJECT_INVALID);
+
+    auto *pPlayer = Globals::AppManager()->m_pServerExoApp->GetClientObjectByObjectId(oidPlayer);
+    auto *pCreature = Utils::AsNWSCreature(Utils::GetGameObject(oidPlayer));
+    if (!pPlayer || !pCreature || !pCreature->m_pStats)
+        return -1;
+
+    uint8_t nCharacterLevel = pCreature->m_pStats->GetLevel(false);
+    auto pSnapshot = TakeCharacterSnapshot(pPlayer, pCreature->m_pStats, nCharacterLevel);
+    if (!pSnapshot)
+        return -1;
+
+    // The old validator reads the engine's tables and the character on the main thread, the new one reads the
+    // snapshots on a worker thread.
+    auto params = GetLevelCheckParams(pCreature, nCharacterLevel, nullptr);
+    auto oldFailures = ValidateLevels(LiveCharacter{pPlayer, pCreature->m_pStats}, params);
+
+    params.m_pRulesSnapshot = GetRulesSnapshot(true);
+    auto newFailures = std::async(std::launch::async, [&]() { return ValidateLevels(*pSnapshot, params); }).get();
+
+    for (size_t i = 0; i < std::max(oldFailures.size(), newFailures.size()); i++)
+    {
+        if (i < oldFailures.size() && i < newFailures.size() && oldFailures[i] == newFailures[i])
+            continue;
+
+        auto LogFailure = [&](const char *sValidator, const std::vector<ValidationFailure>& failures)
+        {
+            if (i >= failures.size())
+            {
+                LOG_WARNING("%s validator of '%x': failure %i missing", sValidator, oidPlayer, (int32_t)i);
+                return;
+            }
+            auto& failure = failures[i];
+            LOG_WARNING("%s validator of '%x': failure %i Type '%i', subType '%i', strRef '%i', level %i, skill %i, feat %i, spell %i",
+                        sValidator, oidPlayer, (int32_t)i, failure.m_type, failure.m_subType, failure.m_nStrRef,
+                        failure.m_nLevel, failure.m_nSkillID, failure.m_nFeatID, failure.m_nSpellID);
+        };
+        LogFailure("Old", oldFailures);
+        LogFailure("New", newFailures);
+        return 0;
+    }
+
+    return 1;
+}
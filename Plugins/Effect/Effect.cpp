@@ -210,6 +210,8 @@ NWNX_EXPORT ArgumentStack ReplaceEffect(ArgumentStack&& args)
                 found++;
             }
         }
+        if (found)
+            MessageBus::Broadcast("NWNX_EFFECT_SIGNAL_REPLACED", { std::to_string(objId) });
     }
     return found;
 }
@@ -242,6 +244,7 @@ NWNX_EXPORT ArgumentStack ReplaceEffectByIndex(ArgumentStack&& args)
           ASSERT_OR_THROW(index < pObject->m_appliedEffects.num);
 
         ResolvePack(pObject->m_appliedEffects[index], args, true);
+        MessageBus::Broadcast("NWNX_EFFECT_SIGNAL_REPLACED", { std::to_string(pObject->m_idSelf) });
     }
 
     return {};
@@ -29,7 +29,12 @@ static std::unordered_map<std::string, std::set<int32_t>> s_idWhitelist;
 static auto s_idSignal = MessageBus::Subscribe("NWNX_EVENT_SIGNAL_EVENT",
     [](const std::vector<std::string> &message)
     {
-        ASSERT(message.size() == 2);
+        // Event name and target, optionally followed by the event data as tag/value pairs.
+        ASSERT(message.size() >= 2 && message.size() % 2 == 0);
+        for (size_t i = 2; i + 1 < message.size(); i += 2)
+        {
+            PushEventData(message[i], message[i + 1]);
+        }
         SignalEvent(message[0], std::strtoul(message[1].c_str(), nullptr, 16));
     });
 
@@ -43,6 +48,7 @@ static auto s_idPush = MessageBus::Subscribe("NWNX_EVENT_PUSH_EVENT_DATA",
 static std::string GetEventData(const std::string& tag);
 static void CreateNewEventDataIfNeeded();
 static void RunEventInit(const std::string& eventName);
+static void PinScriptChunk(const std::pair<int32_t, std::string>& subscriber, bool bPin);
 
 void PushEventData(const std::string& tag, const std::string& data)
 {
@@ -177,6 +183,13 @@ void CreateNewEventDataIfNeeded()
     }
 }
 
+// Lets the Optimizations chunk cache keep subscribed chunks compiled. Nothing listens if it is disabled.
+void PinScriptChunk(const std::pair<int32_t, std::string>& subscriber, bool bPin)
+{
+    MessageBus::Broadcast(bPin ? "NWNX_OPTIMIZATIONS_PIN_SCRIPT_CHUNK" : "NWNX_OPTIMIZATIONS_UNPIN_SCRIPT_CHUNK",
+                          { subscriber.second, subscriber.first == 2 ? "1" : "0" });
+}
+
 void RunEventInit(const std::string& eventName)
 {
     std::vector<std::string> erase;
@@ -257,6 +270,8 @@ NWNX_EXPORT ArgumentStack UnsubscribeAllStartingWith(ArgumentStack&& args)
             if (it->second.rfind(prefix, 0) == 0)
             {
                 LOG_INFO("Script '%s' unsubscribed from event '%s'.", it->second, eventMapPair.first);
+                if (it->first != 0)
+                    PinScriptChunk(*it, false);
                 it = eventMapPair.second.erase(it);
             }
             else
@@ -290,6 +305,7 @@ NWNX_EXPORT ArgumentStack SubscribeEventScriptChunk(ArgumentStack&& args)
     {
         LOG_INFO("Script Chunk '%s' subscribed to event '%s'.", scriptChunk, event);
         eventVector.emplace_back(pair);
+        PinScriptChunk(pair, true);
     }
 
     return {};
@@ -315,6 +331,7 @@ NWNX_EXPORT ArgumentStack UnsubscribeEventScriptChunk(ArgumentStack&& args)
     {
         LOG_INFO("Script Chunk '%s' unsubscribed from event '%s'.", scriptChunk, event);
         eventVector.erase(it);
+        PinScriptChunk(pair, false);
     }
 
     return {};
@@ -18,6 +18,7 @@
 #include "API/Globals.hpp"
 #include "API/Functions.hpp"
 #include <cmath>
+#include <cstring>
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
@@ -80,261 +81,287 @@ Feat::~Feat()
 {
 }
 
-void Feat::DoEffect(CNWSCreature *pCreature,
-                    uint16_t featId,
-                    uint16_t nType,
-                    int32_t param0,
-                    int32_t param1,
-                    int32_t param2,
-                    int32_t param3,
-                    int32_t param4,
-                    int32_t param5)
+void Feat::DoEffect(CNWSCreature *pCreature, const CExoString& sTag, const EffectTemplate& effect)
 {
     auto *eff = new CGameEffect(true);
-    std::string sCustomTag = "NWNX_Feat_FeatMod_" + std::to_string(featId);
     eff->m_oidCreator         = MODULE_OID;
-    eff->m_nType              = nType;
+    eff->m_nType              = effect.m_nType;
     eff->m_nSubType           = Constants::EffectSubType::Supernatural | Constants::EffectDurationType::Innate;
     eff->m_bShowIcon          = g_plugin->m_ShowEffectIcon;
     eff->m_nSpellId           = g_plugin->m_nCustomSpellID;
-    eff->m_nParamInteger[0]   = param0;
-    eff->m_nParamInteger[1]   = param1;
-    eff->m_nParamInteger[2]   = param2;
-    eff->m_nParamInteger[3]   = param3;
-    eff->m_nParamInteger[4]   = param4;
-    eff->m_nParamInteger[5]   = param5;
-    eff->m_sCustomTag         = sCustomTag;
+    for (int i = 0; i < 6; i++)
+        eff->m_nParamInteger[i] = effect.m_nParams[i];
+    eff->m_sCustomTag         = sTag;
     pCreature->ApplyEffect(eff, true, true);
 }
 
-void Feat::ApplyFeatEffects(CNWSCreature *pCreature, uint16_t nFeat)
+const Feat::CompiledFeat* Feat::GetCompiledFeat(uint16_t nFeat)
 {
-    // AB
-    auto modAB = g_plugin->m_FeatAB[nFeat];
-    if (modAB != 0)
+    if (nFeat >= g_plugin->m_CompiledFeats.size() || !g_plugin->m_CompiledFeats[nFeat].m_bDefined)
+        return nullptr;
+    return &g_plugin->m_CompiledFeats[nFeat];
+}
+
+void Feat::CompileFeat(uint16_t nFeat)
+{
+    if (nFeat >= m_CompiledFeats.size())
+        m_CompiledFeats.resize(nFeat + 1);
+
+    auto& compiled = m_CompiledFeats[nFeat];
+    compiled = CompiledFeat();
+    compiled.m_bDefined = true;
+    compiled.m_sTag = ("NWNX_Feat_FeatMod_" + std::to_string(nFeat)).c_str();
+
+    auto Find = [nFeat](auto& map) -> decltype(&map.begin()->second)
     {
-        g_plugin->DoEffect(pCreature, nFeat,
-                           modAB > 0 ? AttackIncrease : AttackDecrease,
-                           abs(modAB), 0, Constants::RacialType::Invalid);
-    }
+        auto it = map.find(nFeat);
+        return it == map.end() ? nullptr : &it->second;
+    };
+    auto Has = [nFeat](auto& set) { return set.find(nFeat) != set.end(); };
+    auto Add = [](vector<EffectTemplate>& effects, uint16_t nType, int32_t param0 = 0, int32_t param1 = 0, int32_t param2 = 0,
+                  int32_t param3 = 0, int32_t param4 = 0, int32_t param5 = 0)
+    {
+        effects.push_back({nType, {param0, param1, param2, param3, param4, param5}});
+    };
+    auto& effects = compiled.m_Effects;
+
+    // AB
+    if (auto *pAB = Find(m_FeatAB); pAB && *pAB != 0)
+        Add(effects, *pAB > 0 ? AttackIncrease : AttackDecrease, abs(*pAB), 0, Constants::RacialType::Invalid);
 
     // ABILITY
-    for (auto &abilityMod : g_plugin->m_FeatAbility[nFeat])
+    if (auto *pAbility = Find(m_FeatAbility))
     {
-        auto abilityType = abilityMod.first;
-        auto mod = abilityMod.second;
-        if (mod != 0)
+        for (auto &abilityMod : *pAbility)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               mod > 0 ? AbilityIncrease : AbilityDecrease,
-                               abilityType, abs(mod));
+            if (abilityMod.second != 0)
+                Add(effects, abilityMod.second > 0 ? AbilityIncrease : AbilityDecrease, abilityMod.first, abs(abilityMod.second));
         }
     }
 
     // ABVSRACE
-    for (auto &ABVsRaceMod : g_plugin->m_FeatABVsRace[nFeat])
+    if (auto *pABVsRace = Find(m_FeatABVsRace))
     {
-        auto vsRace = ABVsRaceMod.first;
-        auto modVsRace = ABVsRaceMod.second;
-        if (modVsRace != 0)
+        for (auto &ABVsRaceMod : *pABVsRace)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               modVsRace > 0 ? AttackIncrease : AttackDecrease,
-                               abs(modVsRace), 0, vsRace);
+            if (ABVsRaceMod.second != 0)
+                Add(effects, ABVsRaceMod.second > 0 ? AttackIncrease : AttackDecrease, abs(ABVsRaceMod.second), 0, ABVsRaceMod.first);
         }
     }
 
     // AC
-    auto modAC = g_plugin->m_FeatAC[nFeat];
-    if (modAC != 0)
-    {
-        g_plugin->DoEffect(pCreature, nFeat,
-                           modAC > 0 ? ACIncrease : ACDecrease, Constants::ACBonus::Dodge,
-                           abs(modAC), Constants::RacialType::Invalid, 0, 0, 4103);
-    }
+    if (auto *pAC = Find(m_FeatAC); pAC && *pAC != 0)
+        Add(effects, *pAC > 0 ? ACIncrease : ACDecrease, Constants::ACBonus::Dodge, abs(*pAC), Constants::RacialType::Invalid, 0, 0, 4103);
 
     // ACVSRACE
-    for (auto &ACVsRaceMod : g_plugin->m_FeatACVsRace[nFeat])
+    if (auto *pACVsRace = Find(m_FeatACVsRace))
     {
-        auto vsRace = ACVsRaceMod.first;
-        auto modVsRace = ACVsRaceMod.second;
-        if (modVsRace != 0)
+        for (auto &ACVsRaceMod : *pACVsRace)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               modVsRace > 0 ? ACIncrease : ACDecrease, Constants::ACBonus::Dodge,
-                               abs(modVsRace), vsRace, 0, 0, 4103);
+            if (ACVsRaceMod.second != 0)
+                Add(effects, ACVsRaceMod.second > 0 ? ACIncrease : ACDecrease, Constants::ACBonus::Dodge, abs(ACVsRaceMod.second), ACVsRaceMod.first, 0, 0, 4103);
         }
     }
 
     // ARCANESPELLFAILURE
-    auto modArcaneSpellFailure = g_plugin->m_FeatArcaneSpellFailure[nFeat];
-    if (modArcaneSpellFailure != 0)
-    {
-        g_plugin->DoEffect(pCreature, nFeat, ArcaneSpellFailure, modArcaneSpellFailure);
-    }
+    if (auto *pArcaneSpellFailure = Find(m_FeatArcaneSpellFailure); pArcaneSpellFailure && *pArcaneSpellFailure != 0)
+        Add(effects, ArcaneSpellFailure, *pArcaneSpellFailure);
 
     // BONUSSPELL
-    g_plugin->AddRemoveBonusSpell(pCreature->m_pStats, nFeat);
-
-    // CONCEALMENT
-    auto modConceal = g_plugin->m_FeatConcealment[nFeat];
-    if (modConceal != 0)
+    if (auto *pBonusSpell = Find(m_FeatBonusSpell))
     {
-        g_plugin->DoEffect(pCreature, nFeat,Concealment, modConceal, Constants::RacialType::Invalid);
+        for (auto &bonusSpellMod : *pBonusSpell)
+        {
+            for (auto &bonusSpellModClass : bonusSpellMod.second)
+            {
+                if (bonusSpellModClass.second != 0)
+                    compiled.m_BonusSpells.emplace_back(bonusSpellMod.first, bonusSpellModClass.first, bonusSpellModClass.second);
+            }
+        }
     }
 
+    // CONCEALMENT
+    if (auto *pConceal = Find(m_FeatConcealment); pConceal && *pConceal != 0)
+        Add(effects, Concealment, *pConceal, Constants::RacialType::Invalid);
+
     // DAMAGE
-    for (auto &damageMod : g_plugin->m_FeatDamage[nFeat])
+    if (auto *pDamage = Find(m_FeatDamage))
     {
-        auto modDamageType = damageMod.first;
-        auto modDamageValue = damageMod.second;
-        if (modDamageValue != 0)
+        for (auto &damageMod : *pDamage)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               modDamageValue > 0 ? DamageIncrease : DamageDecrease,
-                               abs(modDamageValue), modDamageType, 28, 0, 0);
+            if (damageMod.second != 0)
+                Add(effects, damageMod.second > 0 ? DamageIncrease : DamageDecrease, abs(damageMod.second), damageMod.first, 28);
         }
     }
 
     // DMGIMMUNITY
-    for (auto &dmgImmunityMod : g_plugin->m_FeatDmgImmunity[nFeat])
+    if (auto *pDmgImmunity = Find(m_FeatDmgImmunity))
     {
-        auto modDmgImmunityType = dmgImmunityMod.first;
-        auto modDmgImmunityValue = dmgImmunityMod.second;
-        if (modDmgImmunityValue != 0)
+        for (auto &dmgImmunityMod : *pDmgImmunity)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               modDmgImmunityValue > 0 ? DamageImmunityIncrease : DamageImmunityDecrease,
-                               modDmgImmunityType, abs(modDmgImmunityValue));
+            if (dmgImmunityMod.second != 0)
+                Add(effects, dmgImmunityMod.second > 0 ? DamageImmunityIncrease : DamageImmunityDecrease, dmgImmunityMod.first, abs(dmgImmunityMod.second));
         }
     }
 
     // DMGREDUCTION
-    for (auto &dmgResistMod : g_plugin->m_FeatDmgReduction[nFeat])
+    if (auto *pDmgReduction = Find(m_FeatDmgReduction))
     {
-        auto modDmgReductionType = dmgResistMod.first;
-        auto modDmgReductionValue = dmgResistMod.second;
-        if (modDmgReductionValue != 0)
+        for (auto &dmgReductionMod : *pDmgReduction)
         {
-            g_plugin->DoEffect(pCreature, nFeat, DamageReduction, modDmgReductionType, modDmgReductionValue);
+            if (dmgReductionMod.second != 0)
+                Add(effects, DamageReduction, dmgReductionMod.first, dmgReductionMod.second);
         }
     }
 
     // DMGRESIST
-    for (auto &dmgResistMod : g_plugin->m_FeatDmgResist[nFeat])
+    if (auto *pDmgResist = Find(m_FeatDmgResist))
     {
-        auto modDmgResistType = dmgResistMod.first;
-        auto modDmgResistValue = dmgResistMod.second;
-        if (modDmgResistValue != 0)
+        for (auto &dmgResistMod : *pDmgResist)
         {
-            g_plugin->DoEffect(pCreature, nFeat, DamageResistance, modDmgResistType, modDmgResistValue);
+            if (dmgResistMod.second != 0)
+                Add(effects, DamageResistance, dmgResistMod.first, dmgResistMod.second);
         }
     }
 
     // HASTE
-    if (g_plugin->m_FeatHaste.find(nFeat) != g_plugin->m_FeatHaste.end())
-    {
-        g_plugin->DoEffect(pCreature, nFeat, Haste);
-    }
+    if (Has(m_FeatHaste))
+        Add(effects, Haste);
 
     // IMMUNITY
-    for (auto &immunity : g_plugin->m_FeatImmunities[nFeat])
+    if (auto *pImmunities = Find(m_FeatImmunities))
     {
-        g_plugin->DoEffect(pCreature, nFeat, Immunity, immunity,Constants::RacialType::Invalid);
+        for (auto &immunity : *pImmunities)
+            Add(effects, Immunity, immunity, Constants::RacialType::Invalid);
     }
 
     // MOVEMENTSPEED
-    auto modSpeed = g_plugin->m_FeatMovementSpeed[nFeat];
-    if (modSpeed != 0)
-    {
-        g_plugin->DoEffect(pCreature, nFeat, MovementSpeedIncrease, modSpeed);
-    }
+    if (auto *pSpeed = Find(m_FeatMovementSpeed); pSpeed && *pSpeed != 0)
+        Add(effects, MovementSpeedIncrease, *pSpeed);
 
     // REGENERATION
-    auto modRegenAmount = g_plugin->m_FeatRegeneration[nFeat].first;
-    auto modRegenInterval = g_plugin->m_FeatRegeneration[nFeat].second;
-    if (modRegenAmount != 0)
-    {
-        g_plugin->DoEffect(pCreature, nFeat, Regenerate, modRegenAmount,
-                modRegenInterval > 0 ? modRegenInterval * 1000 : 6000);
-    }
+    if (auto *pRegen = Find(m_FeatRegeneration); pRegen && pRegen->first != 0)
+        Add(effects, Regenerate, pRegen->first, pRegen->second > 0 ? pRegen->second * 1000 : 6000);
 
     // SAVE
-    for (auto &saveMod : g_plugin->m_FeatSave[nFeat])
+    if (auto *pSave = Find(m_FeatSave))
     {
-        auto saveType = saveMod.first;
-        auto mod = saveMod.second;
-        if (mod != 0)
+        for (auto &saveMod : *pSave)
         {
-            g_plugin->DoEffect(pCreature, nFeat,
-                               mod > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(mod),
-                               saveType, Constants::SavingThrowType::All, Constants::RacialType::Invalid);
+            if (saveMod.second != 0)
+                Add(effects, saveMod.second > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(saveMod.second),
+                    saveMod.first, Constants::SavingThrowType::All, Constants::RacialType::Invalid);
         }
     }
 
     // SAVEVSRACE
-    for (auto &saveMod : g_plugin->m_FeatSaveVsRace[nFeat])
+    if (auto *pSaveVsRace = Find(m_FeatSaveVsRace))
     {
-        auto saveType = saveMod.first;
-        for (auto &saveVsFeatMod : g_plugin->m_FeatSaveVsRace[nFeat][saveType])
+        for (auto &saveMod : *pSaveVsRace)
         {
-            auto saveVsRace = saveVsFeatMod.first;
-            auto modVsRace = saveVsFeatMod.second;
-            if (modVsRace != 0)
+            for (auto &saveVsRaceMod : saveMod.second)
             {
-                g_plugin->DoEffect(pCreature, nFeat,
-                                   modVsRace > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(modVsRace),
-                                   saveType, Constants::SavingThrowType::All, saveVsRace);
+                if (saveVsRaceMod.second != 0)
+                    Add(effects, saveVsRaceMod.second > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(saveVsRaceMod.second),
+                        saveMod.first, Constants::SavingThrowType::All, saveVsRaceMod.first);
             }
         }
     }
 
     // SAVEVSTYPE
-    for (auto &saveMod : g_plugin->m_FeatSaveVsType[nFeat])
+    if (auto *pSaveVsType = Find(m_FeatSaveVsType))
     {
-        auto saveType = saveMod.first;
-        for (auto &saveVsTypeMod : g_plugin->m_FeatSaveVsType[nFeat][saveType])
+        for (auto &saveMod : *pSaveVsType)
         {
-            auto saveVsType = saveVsTypeMod.first;
-            auto modVsType = saveVsTypeMod.second;
-            if (modVsType != 0)
+            for (auto &saveVsTypeMod : saveMod.second)
             {
-                g_plugin->DoEffect(pCreature, nFeat,
-                                   modVsType > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(modVsType),
-                                   saveType, saveVsType, Constants::RacialType::Invalid);
+                if (saveVsTypeMod.second != 0)
+                    Add(effects, saveVsTypeMod.second > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(saveVsTypeMod.second),
+                        saveMod.first, saveVsTypeMod.first, Constants::RacialType::Invalid);
             }
         }
     }
 
     // SAVEVSTYPERACE
-    for (auto &saveMod : g_plugin->m_FeatSaveVsTypeRace[nFeat])
+    if (auto *pSaveVsTypeRace = Find(m_FeatSaveVsTypeRace))
     {
-        auto saveType = saveMod.first;
-        for (auto &saveVsTypeMod : g_plugin->m_FeatSaveVsTypeRace[nFeat][saveType])
+        for (auto &saveMod : *pSaveVsTypeRace)
         {
-            auto saveVsType = saveVsTypeMod.first;
-            for (auto &saveVsTypeRaceMod : g_plugin->m_FeatSaveVsTypeRace[nFeat][saveType][saveVsType])
+            for (auto &saveVsTypeMod : saveMod.second)
             {
-                auto saveVsRace = saveVsTypeRaceMod.first;
-                auto modVsTypeRace = saveVsTypeRaceMod.second;
-                if (modVsTypeRace != 0)
+                for (auto &saveVsTypeRaceMod : saveVsTypeMod.second)
                 {
-                    g_plugin->DoEffect(pCreature, nFeat,
-                                       modVsTypeRace > 0 ? SavingThrowIncrease : SavingThrowDecrease,
-                                       abs(modVsTypeRace), saveType, saveVsType, saveVsRace);
+                    if (saveVsTypeRaceMod.second != 0)
+                        Add(effects, saveVsTypeRaceMod.second > 0 ? SavingThrowIncrease : SavingThrowDecrease, abs(saveVsTypeRaceMod.second),
+                            saveMod.first, saveVsTypeMod.first, saveVsTypeRaceMod.first);
                 }
             }
         }
     }
 
     // SEEINVISIBLE
-    if (g_plugin->m_FeatSeeInvisible.find(nFeat) != g_plugin->m_FeatSeeInvisible.end())
+    if (Has(m_FeatSeeInvisible))
+        Add(effects, SeeInvisible);
+
+    // SPELLSAVEDC / SPELLSAVEDCFORSCHOOL / SPELLSAVEDCFORSPELL
+    auto *pSpellSaveDC = Find(m_FeatSpellSaveDC);
+    auto *pSpellSaveDCForSchool = Find(m_FeatSpellSaveDCForSpellSchool);
+    auto *pSpellSaveDCForSpell = Find(m_FeatSpellSaveDCForSpell);
+    compiled.m_bSpellSaveDC = (pSpellSaveDC && *pSpellSaveDC != 0) ||
+                              (pSpellSaveDCForSchool && pSpellSaveDCForSchool->second != 0) ||
+                              (pSpellSaveDCForSpell && pSpellSaveDCForSpell->second != 0);
+
+    // SPELLIMMUNITY
+    if (auto *pSpellImmunities = Find(m_FeatSpellImmunities))
+    {
+        for (auto &spellImmunity : *pSpellImmunities)
+            Add(effects, SpellImmunity, spellImmunity);
+    }
+
+    // SR
+    if (auto *pSRCharGen = Find(m_FeatSRCharGen))
+    {
+        compiled.m_nSRCharGen = pSRCharGen->first;
+        compiled.m_nSRMax = pSRCharGen->second;
+    }
+    if (auto *pSR = Find(m_FeatSR))
+    {
+        compiled.m_nSRInc = std::get<0>(*pSR);
+        compiled.m_nSRLevel = std::get<1>(*pSR);
+        compiled.m_nSRStart = std::get<2>(*pSR);
+    }
+
+    // TRUESEEING
+    if (Has(m_FeatTrueSeeing))
+        Add(compiled.m_EffectsAfterSR, Trueseeing);
+
+    // ULTRAVISION
+    if (Has(m_FeatUltravision))
+        Add(compiled.m_EffectsAfterSR, Ultravision);
+
+    // VISUALEFFECT
+    if (auto *pVFX = Find(m_FeatVFX))
     {
-        g_plugin->DoEffect(pCreature, nFeat, SeeInvisible);
+        for (auto &vfx : *pVFX)
+            Add(compiled.m_EffectsAfterSR, VisualEffect, vfx);
     }
+}
+
+void Feat::ApplyFeatEffects(CNWSCreature *pCreature, uint16_t nFeat)
+{
+    auto *pCompiled = GetCompiledFeat(nFeat);
+    if (!pCompiled)
+        return;
+
+    for (auto &effect : pCompiled->m_Effects)
+        DoEffect(pCreature, pCompiled->m_sTag, effect);
+
+    // BONUSSPELL
+    if (!pCompiled->m_BonusSpells.empty())
+        AddRemoveBonusSpell(pCreature->m_pStats, nFeat);
 
     // SPELLSAVEDC / SPELLSAVEDCFORSCHOOL / SPELLSAVEDCFORSPELL
-    if ((g_plugin->m_FeatSpellSaveDC[nFeat] != 0) || (g_plugin->m_FeatSpellSaveDCForSpellSchool[nFeat].second != 0) || (g_plugin->m_FeatSpellSaveDCForSpell[nFeat].second != 0))
+    if (pCompiled->m_bSpellSaveDC)
     {
         static NWNXLib::Hooks::Hook pCalculateSpellSaveDC_hook;
         if (!pCalculateSpellSaveDC_hook)
@@ -381,46 +408,19 @@ void Feat::ApplyFeatEffects(CNWSCreature *pCreature, uint16_t nFeat)
         }
     }
 
-
-    // SPELLIMMUNITY
-    for (auto &spellImmunity : g_plugin->m_FeatSpellImmunities[nFeat])
-    {
-        g_plugin->DoEffect(pCreature, nFeat, SpellImmunity, spellImmunity);
-    }
-
     // SR
-    auto mod_SRCharGen = g_plugin->m_FeatSRCharGen[nFeat].first;
-    auto mod_SRMax = g_plugin->m_FeatSRCharGen[nFeat].second;
-    auto mod_SRInc = std::get<0>(g_plugin->m_FeatSR[nFeat]);
-    auto mod_SRLevel = std::get<1>(g_plugin->m_FeatSR[nFeat]);
-    auto mod_SRStart = std::get<2>(g_plugin->m_FeatSR[nFeat]);
     auto mod_SRPerLevelCalc = 0;
-    if (mod_SRLevel > 0)
-        mod_SRPerLevelCalc = int32_t(std::floor(((pCreature->m_pStats->GetLevel(true) - mod_SRStart + 1) / mod_SRLevel) * mod_SRInc));
-    int32_t mod_SR = mod_SRCharGen + (mod_SRPerLevelCalc > 0 ? mod_SRPerLevelCalc : 0);
-    mod_SR = (mod_SR > mod_SRMax && mod_SRMax > 0) ? mod_SRMax : mod_SR;
+    if (pCompiled->m_nSRLevel > 0)
+        mod_SRPerLevelCalc = int32_t(std::floor(((pCreature->m_pStats->GetLevel(true) - pCompiled->m_nSRStart + 1) / pCompiled->m_nSRLevel) * pCompiled->m_nSRInc));
+    int32_t mod_SR = pCompiled->m_nSRCharGen + (mod_SRPerLevelCalc > 0 ? mod_SRPerLevelCalc : 0);
+    mod_SR = (mod_SR > pCompiled->m_nSRMax && pCompiled->m_nSRMax > 0) ? pCompiled->m_nSRMax : mod_SR;
     if (mod_SR != 0)
     {
-        g_plugin->DoEffect(pCreature, nFeat, SpellResistanceIncrease, mod_SR);
+        DoEffect(pCreature, pCompiled->m_sTag, {SpellResistanceIncrease, {mod_SR, 0, 0, 0, 0, 0}});
     }
 
-    // TRUESEEING
-    if (g_plugin->m_FeatTrueSeeing.find(nFeat) != g_plugin->m_FeatTrueSeeing.end())
-    {
-        g_plugin->DoEffect(pCreature, nFeat, Trueseeing);
-    }
-
-    // ULTRAVISION
-    if (g_plugin->m_FeatUltravision.find(nFeat) != g_plugin->m_FeatUltravision.end())
-    {
-        g_plugin->DoEffect(pCreature, nFeat, Ultravision);
-    }
-
-    // VISUALEFFECT
-    for (auto &vfx : g_plugin->m_FeatVFX[nFeat])
-    {
-        g_plugin->DoEffect(pCreature, nFeat, VisualEffect, vfx);
-    }
+    for (auto &effect : pCompiled->m_EffectsAfterSR)
+        DoEffect(pCreature, pCompiled->m_sTag, effect);
 }
 
 uint8_t Feat::SavingThrowRollHook(CNWSCreature *pCreature, uint8_t nSaveType, uint16_t nDifficultyClass, uint8_t nSpecificType,
@@ -547,7 +547,7 @@ int32_t Feat::GetWeaponPowerHook(CNWSCreature *pCreature, CNWSObject *pObject, i
 
 void Feat::AddFeatEffects(CNWSCreatureStats *pCreatureStats, uint16_t featId)
 {
-    if (g_plugin->m_Feats.find(featId) != g_plugin->m_Feats.end())
+    if (GetCompiledFeat(featId))
     {
         if (!pCreatureStats->HasFeat(featId))
         {
@@ -558,20 +558,19 @@ void Feat::AddFeatEffects(CNWSCreatureStats *pCreatureStats, uint16_t featId)
 
 void Feat::RemoveFeatEffects(CNWSCreatureStats *pCreatureStats, uint16_t featId)
 {
-    if (g_plugin->m_Feats.find(featId) != g_plugin->m_Feats.end())
+    if (auto *pCompiled = GetCompiledFeat(featId))
     {
         if (pCreatureStats->HasFeat(featId))
         {
-            if (g_plugin->m_FeatBonusSpell.find(featId) != g_plugin->m_FeatBonusSpell.end())
+            if (!pCompiled->m_BonusSpells.empty())
             {
                 g_plugin->AddRemoveBonusSpell(pCreatureStats, featId, false);
             }
-            std::vector<uint64_t> remove(128);
+            std::vector<uint64_t> remove;
             for (int i = 0; i < pCreatureStats->m_pBaseCreature->m_appliedEffects.num; i++)
             {
                 auto eff = (CGameEffect *) pCreatureStats->m_pBaseCreature->m_appliedEffects.element[i];
-                std::string featTag = "NWNX_Feat_FeatMod_" + std::to_string(featId);
-                if (eff->m_sCustomTag == featTag)
+                if (eff->m_sCustomTag == pCompiled->m_sTag)
                 {
                     remove.push_back(eff->m_nID);
                 }
@@ -584,30 +583,29 @@ void Feat::RemoveFeatEffects(CNWSCreatureStats *pCreatureStats, uint16_t featId)
 
 void Feat::AddRemoveBonusSpell(CNWSCreatureStats *pCreatureStats, uint16_t featId, bool bAdd)
 {
-    for (auto &bonusSpellMod : g_plugin->m_FeatBonusSpell[featId])
+    auto *pCompiled = GetCompiledFeat(featId);
+    if (!pCompiled)
+        return;
+
+    for (auto &bonusSpell : pCompiled->m_BonusSpells)
     {
-        auto classType = bonusSpellMod.first;
-        for (auto &bonusSpellModClass : g_plugin->m_FeatBonusSpell[featId][classType])
+        auto classType = std::get<0>(bonusSpell);
+        uint8_t classLevel = std::get<1>(bonusSpell);
+        int32_t classLevelBonus = std::get<2>(bonusSpell);
+
+        int nMultiClass = -1;
+        for (int i = 0; i < pCreatureStats->m_nNumMultiClasses; i++)
         {
-            uint8_t classLevel = bonusSpellModClass.first;
-            int32_t classLevelBonus = bonusSpellModClass.second;
-            if (classLevelBonus != 0)
+            if (pCreatureStats->m_ClassInfo[i].m_nClass == classType)
             {
-                int nMultiClass = -1;
-                for (int i = 0; i < pCreatureStats->m_nNumMultiClasses; i++)
-                {
-                    if (pCreatureStats->m_ClassInfo[i].m_nClass == classType)
-                    {
-                        nMultiClass = i;
-                        break;
-                    }
-                }
-                if (nMultiClass >= 0)
-                {
-                    pCreatureStats->ModifyNumberBonusSpells(nMultiClass, classLevel, (bAdd ? 1 : -1) * classLevelBonus);
-                }
+                nMultiClass = i;
+                break;
             }
         }
+        if (nMultiClass >= 0)
+        {
+            pCreatureStats->ModifyNumberBonusSpells(nMultiClass, classLevel, (bAdd ? 1 : -1) * classLevelBonus);
+        }
     }
 }
 
@@ -643,13 +641,13 @@ void Feat::EatTURDHook(CNWSPlayer *pPlayer, CNWSPlayerTURD *pTURD)
 {
     if (pTURD)
     {
-        std::vector<uint64_t> remove(128);
+        static constexpr char tagPrefix[] = "NWNX_Feat_FeatMod_";
+        std::vector<uint64_t> remove;
         for (int i = 0; i < pTURD->m_appliedEffects.num; i++)
         {
             auto *eff = pTURD->m_appliedEffects.element[i];
 
-            std::string sCustomTag = eff->m_sCustomTag.CStr();
-            if (sCustomTag.find("NWNX_Feat_FeatMod_", 0) == 0)
+            if (std::strncmp(eff->m_sCustomTag.CStr(), tagPrefix, sizeof(tagPrefix) - 1) == 0)
             {
                 remove.push_back(eff->m_nID);
             }
@@ -997,8 +995,13 @@ ArgumentStack Feat::SetFeatModifier(ArgumentStack&& args)
     auto param3 = ScriptAPI::ExtractArgument<int>(args);
     auto param4 = ScriptAPI::ExtractArgument<int>(args);
 
-    if (DoFeatModifier(featId, featMod, param1, param2, param3, param4) && !g_plugin->m_Feats.count(featId))
-        g_plugin->m_Feats.insert(featId);
+    if (DoFeatModifier(featId, featMod, param1, param2, param3, param4))
+    {
+        if (!g_plugin->m_Feats.count(featId))
+            g_plugin->m_Feats.insert(featId);
+        g_plugin->CompileFeat(featId);
+        MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
+    }
 
     return ScriptAPI::Arguments();
 }
@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <tuple>
 using namespace std;
 using namespace NWNXLib::API;
 using namespace NWNXLib::Services;
@@ -91,7 +92,35 @@ private:
     unordered_map<uint16_t, pair<uint8_t, int32_t>>                                   m_FeatSpellSaveDCForSpellSchool;
     unordered_map<uint16_t, pair<uint16_t, int32_t>>                                  m_FeatSpellSaveDCForSpell;
 
-    static void DoEffect(CNWSCreature*, uint16_t, uint16_t, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0);
+    struct EffectTemplate
+    {
+        uint16_t m_nType;
+        int32_t m_nParams[6];
+    };
+
+    // The modifiers above flattened per feat when they are set, so applying a feat doesn't look anything up.
+    struct CompiledFeat
+    {
+        bool m_bDefined = false;
+        CExoString m_sTag;
+        vector<EffectTemplate> m_Effects;
+        // Applied after the level dependent spell resistance effect.
+        vector<EffectTemplate> m_EffectsAfterSR;
+        vector<tuple<uint8_t, uint8_t, int32_t>> m_BonusSpells;
+        bool m_bSpellSaveDC = false;
+        uint8_t m_nSRCharGen = 0;
+        uint8_t m_nSRMax = 0;
+        uint8_t m_nSRInc = 0;
+        uint8_t m_nSRLevel = 0;
+        uint8_t m_nSRStart = 0;
+    };
+
+    // Indexed by feat id.
+    vector<CompiledFeat> m_CompiledFeats;
+
+    void CompileFeat(uint16_t);
+    static const CompiledFeat* GetCompiledFeat(uint16_t);
+    static void DoEffect(CNWSCreature*, const CExoString&, const EffectTemplate&);
     static void ApplyFeatEffects(CNWSCreature*, uint16_t);
     static void AddFeatEffects(CNWSCreatureStats*, uint16_t);
     static void RemoveFeatEffects(CNWSCreatureStats*, uint16_t);
@@ -13,9 +13,11 @@
 #include "API/CNWSRules.hpp"
 #include "API/CExoArrayList.hpp"
 #include "API/CServerExoApp.hpp"
+#include "API/CNWSEffectListHandler.hpp"
 
 #include <algorithm>
 #include <numeric>
+#include <unordered_map>
 
 namespace NostackMode
 {
@@ -46,6 +48,19 @@ typedef enum
 } TYPE;
 }
 
+namespace BonusCategory
+{
+typedef enum
+{
+    Attack,
+    SavingThrow,
+    Ability,
+    Skill,
+    Count,
+    Invalid = Count
+} TYPE;
+}
+
 using namespace NWNXLib;
 using namespace NWNXLib::API;
 
@@ -74,8 +89,49 @@ static std::vector<EffectData> s_positiveEffects;
 static std::vector<EffectData> s_negativeEffects;
 static int32_t s_nMaxValues[NostackType::Max + 1];
 
+// Everything the unstacked totals depend on, with the versus creature reduced to its race and alignment.
+struct BonusQuery
+{
+    uint8_t nEffectBonusType;
+    uint8_t nAttackType;
+    uint8_t nSaveType;
+    uint8_t nSpecificType;
+    uint8_t nSkill;
+    uint8_t nAbilityScore;
+    uint16_t nRace;
+    uint8_t nAlignLaw;
+    uint8_t nAlignGood;
+};
+
+struct UnstackedBonus
+{
+    int32_t bonus = 0;
+    int32_t penalty = 0;
+};
+
+struct CategoryCache
+{
+    // Any effect added to or removed from the creature changes the count, even one the hooks below
+    // see before it's in the list.
+    int32_t numEffects = -1;
+    std::unordered_map<uint64_t, UnstackedBonus> bonuses;
+};
+
+struct BonusCache
+{
+    uint32_t generation = 0;
+    CategoryCache categories[BonusCategory::Count];
+};
+
+static bool s_bCacheEnabled = false;
+static bool s_bVerifyCache = false;
+static POS::ExtensionId s_cacheExtensionId;
+// Bumped when a spell's bonus type changes.
+static uint32_t s_cacheGeneration = 1;
+
 void CNWSCreatureStats__UpdateCombatInformation(CNWSCreatureStats*);
 int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature*, uint8_t, CNWSObject*, BOOL, BOOL, uint8_t, uint8_t, uint8_t, uint8_t, BOOL);
+static void InitializeCache();
 
 
 void BonusStacking() __attribute__((constructor));
@@ -100,6 +156,11 @@ void BonusStacking()
 
         s_positiveEffects.reserve(50);
         s_negativeEffects.reserve(50);
+
+        s_bCacheEnabled = Config::Get<bool>("CACHE", false);
+        s_bVerifyCache = Config::Get<bool>("VERIFY_CACHE", false);
+        if (s_bCacheEnabled)
+            InitializeCache();
     }
 }
 
@@ -135,53 +196,16 @@ void AddEffect(EffectData&& effectData, bool negative)
     }
 }
 
-int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffectBonusType, CNWSObject* pObject, BOOL bElementalDamage,
-    BOOL bForceMax, uint8_t nSaveType, uint8_t nSpecificType, uint8_t nSkill, uint8_t nAbilityScore, BOOL bOffHand)
+static UnstackedBonus ScanEffects(CNWSCreature* thisPtr, const BonusQuery& query)
 {
-    if (nEffectBonusType == Constants::EffectBonusType::Damage
-        || ((nEffectBonusType == Constants::EffectBonusType::Attack || nEffectBonusType == Constants::EffectBonusType::TouchAttack) && !s_nAttackBonusStackingMode)
-        || (nEffectBonusType == Constants::EffectBonusType::SavingThrow && !s_nSavingThrowStackingMode)
-        || (nEffectBonusType == Constants::EffectBonusType::Ability && !s_nAbilityStackingMode)
-        || (nEffectBonusType == Constants::EffectBonusType::Skill && !s_nSkillStackingMode)
-        )
-    {
-        return s_GetTotalEffectBonusHook->CallOriginal<int32_t>(thisPtr, nEffectBonusType, pObject,
-            bElementalDamage, bForceMax, nSaveType, nSpecificType, nSkill, nAbilityScore, bOffHand);
-    }
-
-    auto* pCurrentAttack = thisPtr->m_pcCombatRound->GetAttack(thisPtr->m_pcCombatRound->m_nCurrentAttack);
-    auto nAttackType = pCurrentAttack->m_nWeaponAttackType;
-    if (!nAttackType)
-    {
-        nAttackType = bOffHand ? 2 : 1;
-    }
-
-    uint16_t nRace = static_cast<uint16_t>(~0u);
-    uint8_t nAlignLaw = static_cast<uint8_t>(~0u), nAlignGood = static_cast<uint8_t>(~0u);
-    uint32_t nEffectBonus = 0, nEffectPenalty = 0;
-
-    if (pObject)
-    {
-        auto* pCreature = Utils::AsNWSCreature(pObject);
-        if (!pCreature)
-            if (auto* pAoE = Utils::AsNWSAreaOfEffectObject(pObject))
-                pCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(pAoE->m_oidCreator);
-
-        if (pCreature && pCreature->m_pStats)
-        {
-            nRace = pCreature->m_pStats->m_nRace;
-            nAlignLaw = pCreature->m_pStats->GetSimpleAlignmentLawChaos();
-            nAlignGood = pCreature->m_pStats->GetSimpleAlignmentGoodEvil();
-        }
-    }
-
     s_positiveEffects.resize(0);
     s_negativeEffects.resize(0);
 
-    switch (nEffectBonusType)
+    int mode;
+    switch (query.nEffectBonusType)
     {
         default:
-            return 0;
+            return {};
         case Constants::EffectBonusType::Attack:
         case Constants::EffectBonusType::TouchAttack:
             for (auto i = thisPtr->m_pStats->m_nAttackBonusPtr; i < thisPtr->m_appliedEffects.num; i++)
@@ -192,22 +216,22 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
 
                 auto pEffect = thisPtr->m_appliedEffects.element[i];
                 auto nEffectWeaponType = pEffect->GetInteger(1);
-                bool bValidWeapon = nEffectWeaponType == 0 || nEffectWeaponType == nAttackType;
-                if (nAttackType == Constants::WeaponAttackType::AdditionalWeapon)
+                bool bValidWeapon = nEffectWeaponType == 0 || nEffectWeaponType == query.nAttackType;
+                if (query.nAttackType == Constants::WeaponAttackType::AdditionalWeapon)
                     bValidWeapon |= nEffectWeaponType == Constants::WeaponAttackType::MainhandWeapon
                                  || nEffectWeaponType == Constants::WeaponAttackType::CreatureLeftWeapon;
-                else if (nAttackType == Constants::WeaponAttackType::AdditionalUnarmed)
+                else if (query.nAttackType == Constants::WeaponAttackType::AdditionalUnarmed)
                     bValidWeapon |= nEffectWeaponType == Constants::WeaponAttackType::Unarmed;
 
                 if (bValidWeapon
-                    && CheckRaceAlignment(nRace, pEffect->GetInteger(2),
-                                          nAlignLaw, pEffect->GetInteger(3),
-                                          nAlignGood, pEffect->GetInteger(4))
+                    && CheckRaceAlignment(query.nRace, pEffect->GetInteger(2),
+                                          query.nAlignLaw, pEffect->GetInteger(3),
+                                          query.nAlignGood, pEffect->GetInteger(4))
                     )
                 {
                     int32_t nEffectStrength = pEffect->GetInteger(0);
 
-                    if (nEffectWeaponType == 0 || nEffectBonusType != Constants::EffectBonusType::TouchAttack)
+                    if (nEffectWeaponType == 0 || query.nEffectBonusType != Constants::EffectBonusType::TouchAttack)
                     {
                         if (pEffect->m_nType == Constants::EffectTrueType::AttackIncrease)
                             AddEffect(EffectData{ pEffect->m_oidCreator, pEffect->m_nSpellId, nEffectStrength }, false);
@@ -216,20 +240,8 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                     }
                 }
             }
-
-            {
-                nEffectBonus = GetUnstackedBonus(false, s_nAttackBonusStackingMode);
-                nEffectPenalty = GetUnstackedBonus(true, s_bAlwaysStackPenalties ? NostackMode::Disabled : s_nAttackBonusStackingMode);
-
-                uint32_t nAttackBonusLimit = Globals::AppManager()->m_pServerExoApp->GetAttackBonusLimit();
-                nEffectBonus = std::min(nEffectBonus, nAttackBonusLimit);
-                nEffectPenalty = std::min(nEffectPenalty, nAttackBonusLimit);
-            }
-            return nEffectBonus - nEffectPenalty;
-
-        case Constants::EffectBonusType::Damage:
-            //TODO: Damage bonuses can be added if needed by someone
-            return 0;
+            mode = s_nAttackBonusStackingMode;
+            break;
 
         case Constants::EffectBonusType::SavingThrow:
             for (int i = thisPtr->m_pStats->m_nSavingThrowBonusPtr; i < thisPtr->m_appliedEffects.num; i++)
@@ -242,11 +254,11 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                 auto nEffectSaveType = pEffect->GetInteger(1);
                 auto nEffectSpecificType = pEffect->GetInteger(2);
 
-                if ((nEffectSaveType == 0 || nEffectSaveType == nSaveType)
-                    && (nEffectSpecificType == 0 || nEffectSpecificType == nSpecificType)
-                    && CheckRaceAlignment(nRace, pEffect->GetInteger(3),
-                                          nAlignLaw, pEffect->GetInteger(4),
-                                          nAlignGood, pEffect->GetInteger(5))
+                if ((nEffectSaveType == 0 || nEffectSaveType == query.nSaveType)
+                    && (nEffectSpecificType == 0 || nEffectSpecificType == query.nSpecificType)
+                    && CheckRaceAlignment(query.nRace, pEffect->GetInteger(3),
+                                          query.nAlignLaw, pEffect->GetInteger(4),
+                                          query.nAlignGood, pEffect->GetInteger(5))
                     )
                 {
                     int32_t nEffectStrength = pEffect->GetInteger(0);
@@ -261,24 +273,8 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                     }
                 }
             }
-
-            nEffectBonus = GetUnstackedBonus(false, s_nSavingThrowStackingMode);
-            nEffectPenalty = GetUnstackedBonus(true, s_bAlwaysStackPenalties ? NostackMode::Disabled : s_nSavingThrowStackingMode);
-
-            {
-                uint32_t nSavingThrowBonusLimit = Globals::AppManager()->m_pServerExoApp->GetSavingThrowBonusLimit();
-                nEffectBonus = std::min(nEffectBonus, nSavingThrowBonusLimit);
-                nEffectPenalty = std::min(nEffectPenalty, nSavingThrowBonusLimit);
-            }
-
-            if (thisPtr->m_pStats->HasFeat(Constants::Feat::SacredDefense1))
-            {
-                int nChampionLevel = thisPtr->m_pStats->GetNumLevelsOfClass(Constants::ClassType::DivineChampion);
-                if (nChampionLevel > 1)
-                    nEffectBonus += nChampionLevel / 2;
-            }
-
-            return nEffectBonus - nEffectPenalty;
+            mode = s_nSavingThrowStackingMode;
+            break;
 
         case Constants::EffectBonusType::Ability:
             for (int i = thisPtr->m_pStats->m_nAbilityPtr; i < thisPtr->m_appliedEffects.num; i++)
@@ -290,7 +286,7 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                 auto pEffect = thisPtr->m_appliedEffects.element[i];
                 uint8_t nEffectAbility = pEffect->GetInteger(0);
 
-                if (nEffectAbility != nAbilityScore)
+                if (nEffectAbility != query.nAbilityScore)
                     continue;
 
                 int32_t nEffectStrength = pEffect->GetInteger(1);
@@ -304,17 +300,8 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                     AddEffect(EffectData{ pEffect->m_oidCreator, pEffect->m_nSpellId, nEffectStrength }, true);
                 }
             }
-
-            nEffectBonus = GetUnstackedBonus(false, s_nAbilityStackingMode);
-            nEffectPenalty = GetUnstackedBonus(true, s_bAlwaysStackPenalties ? NostackMode::Disabled : s_nAbilityStackingMode);
-
-            {
-                uint32_t nAbilityBonusLimit = Globals::AppManager()->m_pServerExoApp->GetAbilityBonusLimit();
-                uint32_t nAbilityPenaltyLimit = Globals::AppManager()->m_pServerExoApp->GetAbilityPenaltyLimit();
-                nEffectBonus = std::min(nEffectBonus, nAbilityBonusLimit);
-                nEffectPenalty = std::min(nEffectPenalty, nAbilityPenaltyLimit);
-            }
-            return nEffectBonus - nEffectPenalty;
+            mode = s_nAbilityStackingMode;
+            break;
 
         case Constants::EffectBonusType::Skill:
             for (int i = thisPtr->m_pStats->m_nSkillBonusPtr; i < thisPtr->m_appliedEffects.num; i++)
@@ -326,10 +313,10 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                 auto pEffect = thisPtr->m_appliedEffects.element[i];
                 uint8_t nEffectSkill = pEffect->GetInteger(0);
 
-                if ((nEffectSkill == nSkill || nEffectSkill == static_cast<uint8_t>(~0u))
-                    && CheckRaceAlignment(nRace, pEffect->GetInteger(2),
-                                          nAlignLaw, pEffect->GetInteger(3),
-                                          nAlignGood, pEffect->GetInteger(4))
+                if ((nEffectSkill == query.nSkill || nEffectSkill == static_cast<uint8_t>(~0u))
+                    && CheckRaceAlignment(query.nRace, pEffect->GetInteger(2),
+                                          query.nAlignLaw, pEffect->GetInteger(3),
+                                          query.nAlignGood, pEffect->GetInteger(4))
                     )
                 {
                     auto nEffectStrength = pEffect->GetInteger(1);
@@ -344,10 +331,263 @@ int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffect
                     }
                 }
             }
+            mode = s_nSkillStackingMode;
+            break;
+    }
+
+    return { GetUnstackedBonus(false, mode), GetUnstackedBonus(true, s_bAlwaysStackPenalties ? NostackMode::Disabled : mode) };
+}
+
+static int GetCategory(uint8_t nEffectBonusType)
+{
+    switch (nEffectBonusType)
+    {
+        case Constants::EffectBonusType::Attack:
+        case Constants::EffectBonusType::TouchAttack:  return BonusCategory::Attack;
+        case Constants::EffectBonusType::SavingThrow:  return BonusCategory::SavingThrow;
+        case Constants::EffectBonusType::Ability:      return BonusCategory::Ability;
+        case Constants::EffectBonusType::Skill:        return BonusCategory::Skill;
+        default:                                       return BonusCategory::Invalid;
+    }
+}
+
+// Parameters a bonus type doesn't look at are left out, so e.g. ability queries share one entry per ability.
+static uint64_t MakeKey(const BonusQuery& query)
+{
+    uint64_t subtype = 0;
+    bool bVersus = true;
+    switch (query.nEffectBonusType)
+    {
+        case Constants::EffectBonusType::Attack:
+        case Constants::EffectBonusType::TouchAttack:
+            subtype = query.nEffectBonusType << 8 | query.nAttackType;
+            break;
+        case Constants::EffectBonusType::SavingThrow:
+            subtype = query.nSaveType << 8 | query.nSpecificType;
+            break;
+        case Constants::EffectBonusType::Ability:
+            subtype = query.nAbilityScore;
+            bVersus = false;
+            break;
+        case Constants::EffectBonusType::Skill:
+            subtype = query.nSkill;
+            break;
+    }
+
+    uint64_t versus = bVersus ? (uint64_t(query.nRace) << 16 | query.nAlignLaw << 8 | query.nAlignGood) : 0;
+    return subtype << 32 | versus;
+}
+
+static BonusCache* GetBonusCache(CNWSObject* pObject)
+{
+    return static_cast<BonusCache*>(POS::GetExtension(pObject, s_cacheExtensionId));
+}
+
+static UnstackedBonus GetCachedBonus(CNWSCreature* thisPtr, int nCategory, const BonusQuery& query)
+{
+    auto *pCache = GetBonusCache(thisPtr);
+    if (!pCache)
+    {
+        pCache = new BonusCache();
+        POS::SetExtension(thisPtr, s_cacheExtensionId, pCache);
+    }
+
+    if (pCache->generation != s_cacheGeneration)
+    {
+        for (auto& category : pCache->categories)
+            category.bonuses.clear();
+        pCache->generation = s_cacheGeneration;
+    }
+
+    auto& category = pCache->categories[nCategory];
+    if (category.numEffects != thisPtr->m_appliedEffects.num)
+    {
+        category.bonuses.clear();
+        category.numEffects = thisPtr->m_appliedEffects.num;
+    }
+
+    const auto key = MakeKey(query);
+    auto it = category.bonuses.find(key);
+    if (it != category.bonuses.end())
+        return it->second;
+
+    return category.bonuses[key] = ScanEffects(thisPtr, query);
+}
+
+static void InvalidateCategory(CNWSObject* pObject, int nCategory)
+{
+    if (auto *pCache = GetBonusCache(pObject))
+        pCache->categories[nCategory].bonuses.clear();
+}
+
+static void InvalidateAllCategories(CNWSObject* pObject)
+{
+    if (auto *pCache = GetBonusCache(pObject))
+    {
+        for (auto& category : pCache->categories)
+            category.bonuses.clear();
+    }
+}
+
+static void InitializeCache()
+{
+    if (s_bVerifyCache)
+        LOG_INFO("Verifying cached effect bonuses against a full scan of the applied effects.");
+
+    s_cacheExtensionId = POS::RegisterExtension([](void *p) { delete static_cast<BonusCache*>(p); });
+
+    // Effects of a bonus type only change that type's totals.
+#define HOOK_EFFECT_HANDLERS(_type, _category) \
+    static Hooks::Hook CAT(s_OnApply##_type##Hook, __LINE__) = Hooks::HookFunction(&CNWSEffectListHandler::OnApply##_type, \
+    +[](CNWSEffectListHandler *pThis, CNWSObject *pObject, CGameEffect *pEffect, BOOL bLoadingGame) -> int32_t \
+    { \
+        auto retVal = CAT(s_OnApply##_type##Hook, __LINE__)->CallOriginal<int32_t>(pThis, pObject, pEffect, bLoadingGame); \
+        InvalidateCategory(pObject, _category); \
+        return retVal; \
+    }, Hooks::Order::VeryEarly); \
+    static Hooks::Hook CAT(s_OnRemove##_type##Hook, __LINE__) = Hooks::HookFunction(&CNWSEffectListHandler::OnRemove##_type, \
+    +[](CNWSEffectListHandler *pThis, CNWSObject *pObject, CGameEffect *pEffect) -> int32_t \
+    { \
+        auto retVal = CAT(s_OnRemove##_type##Hook, __LINE__)->CallOriginal<int32_t>(pThis, pObject, pEffect); \
+        InvalidateCategory(pObject, _category); \
+        return retVal; \
+    }, Hooks::Order::VeryEarly)
+
+    HOOK_EFFECT_HANDLERS(AttackIncrease, BonusCategory::Attack);
+    HOOK_EFFECT_HANDLERS(AttackDecrease, BonusCategory::Attack);
+    HOOK_EFFECT_HANDLERS(SavingThrowIncrease, BonusCategory::SavingThrow);
+    HOOK_EFFECT_HANDLERS(SavingThrowDecrease, BonusCategory::SavingThrow);
+    HOOK_EFFECT_HANDLERS(AbilityIncrease, BonusCategory::Ability);
+    HOOK_EFFECT_HANDLERS(AbilityDecrease, BonusCategory::Ability);
+    HOOK_EFFECT_HANDLERS(SkillIncrease, BonusCategory::Skill);
+    HOOK_EFFECT_HANDLERS(SkillDecrease, BonusCategory::Skill);
+
+#undef HOOK_EFFECT_HANDLERS
+
+    static Hooks::Hook s_EquipItemHook = Hooks::HookFunction(&CNWSCreature::EquipItem,
+    +[](CNWSCreature *pThis, uint32_t nInventorySlot, CNWSItem *pItem, BOOL bApplyPropertyEffects, BOOL bLoadingItem) -> BOOL
+    {
+        auto retVal = s_EquipItemHook->CallOriginal<BOOL>(pThis, nInventorySlot, pItem, bApplyPropertyEffects, bLoadingItem);
+        InvalidateAllCategories(pThis);
+        return retVal;
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_UnequipItemHook = Hooks::HookFunction(&CNWSCreature::UnequipItem,
+    +[](CNWSCreature *pThis, CNWSItem *pItem, BOOL bUnequipWhilePolymorphed) -> BOOL
+    {
+        auto retVal = s_UnequipItemHook->CallOriginal<BOOL>(pThis, pItem, bUnequipWhilePolymorphed);
+        InvalidateAllCategories(pThis);
+        return retVal;
+    }, Hooks::Order::VeryEarly);
+
+    // NWNX_Effect can change applied effects in place.
+    MessageBus::Subscribe("NWNX_EFFECT_SIGNAL_REPLACED",
+        [](const std::vector<std::string>& message)
+        {
+            if (auto *pObject = Utils::AsNWSObject(Utils::GetGameObject(std::stoul(message[0]))))
+                InvalidateAllCategories(pObject);
+        });
+}
+
+int32_t CNWSCreature__GetTotalEffectBonus(CNWSCreature* thisPtr, uint8_t nEffectBonusType, CNWSObject* pObject, BOOL bElementalDamage,
+    BOOL bForceMax, uint8_t nSaveType, uint8_t nSpecificType, uint8_t nSkill, uint8_t nAbilityScore, BOOL bOffHand)
+{
+    if (nEffectBonusType == Constants::EffectBonusType::Damage
+        || ((nEffectBonusType == Constants::EffectBonusType::Attack || nEffectBonusType == Constants::EffectBonusType::TouchAttack) && !s_nAttackBonusStackingMode)
+        || (nEffectBonusType == Constants::EffectBonusType::SavingThrow && !s_nSavingThrowStackingMode)
+        || (nEffectBonusType == Constants::EffectBonusType::Ability && !s_nAbilityStackingMode)
+        || (nEffectBonusType == Constants::EffectBonusType::Skill && !s_nSkillStackingMode)
+        )
+    {
+        return s_GetTotalEffectBonusHook->CallOriginal<int32_t>(thisPtr, nEffectBonusType, pObject,
+            bElementalDamage, bForceMax, nSaveType, nSpecificType, nSkill, nAbilityScore, bOffHand);
+    }
+
+    const auto nCategory = GetCategory(nEffectBonusType);
+    if (nCategory == BonusCategory::Invalid)
+        return 0;
+
+    auto* pCurrentAttack = thisPtr->m_pcCombatRound->GetAttack(thisPtr->m_pcCombatRound->m_nCurrentAttack);
+    auto nAttackType = pCurrentAttack->m_nWeaponAttackType;
+    if (!nAttackType)
+    {
+        nAttackType = bOffHand ? 2 : 1;
+    }
+
+    uint16_t nRace = static_cast<uint16_t>(~0u);
+    uint8_t nAlignLaw = static_cast<uint8_t>(~0u), nAlignGood = static_cast<uint8_t>(~0u);
+
+    if (pObject)
+    {
+        auto* pCreature = Utils::AsNWSCreature(pObject);
+        if (!pCreature)
+            if (auto* pAoE = Utils::AsNWSAreaOfEffectObject(pObject))
+                pCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(pAoE->m_oidCreator);
+
+        if (pCreature && pCreature->m_pStats)
+        {
+            nRace = pCreature->m_pStats->m_nRace;
+            nAlignLaw = pCreature->m_pStats->GetSimpleAlignmentLawChaos();
+            nAlignGood = pCreature->m_pStats->GetSimpleAlignmentGoodEvil();
+        }
+    }
+
+    const BonusQuery query{ nEffectBonusType, nAttackType, nSaveType, nSpecificType, nSkill, nAbilityScore, nRace, nAlignLaw, nAlignGood };
+    auto unstacked = s_bCacheEnabled ? GetCachedBonus(thisPtr, nCategory, query) : ScanEffects(thisPtr, query);
+
+    if (s_bCacheEnabled && s_bVerifyCache)
+    {
+        auto scanned = ScanEffects(thisPtr, query);
+        if (scanned.bonus != unstacked.bonus || scanned.penalty != unstacked.penalty)
+        {
+            LOG_WARNING("Cached effect bonus %d/-%d of type %d for creature %x doesn't match the applied effects (%d/-%d).",
+                        unstacked.bonus, unstacked.penalty, nEffectBonusType, thisPtr->m_idSelf, scanned.bonus, scanned.penalty);
+            InvalidateCategory(thisPtr, nCategory);
+            unstacked = scanned;
+        }
+    }
+
+    uint32_t nEffectBonus = unstacked.bonus, nEffectPenalty = unstacked.penalty;
+
+    switch (nEffectBonusType)
+    {
+        default:
+            return 0;
+        case Constants::EffectBonusType::Attack:
+        case Constants::EffectBonusType::TouchAttack:
+            {
+                uint32_t nAttackBonusLimit = Globals::AppManager()->m_pServerExoApp->GetAttackBonusLimit();
+                nEffectBonus = std::min(nEffectBonus, nAttackBonusLimit);
+                nEffectPenalty = std::min(nEffectPenalty, nAttackBonusLimit);
+            }
+            return nEffectBonus - nEffectPenalty;
 
-            nEffectBonus =  GetUnstackedBonus(false, s_nSkillStackingMode);
-            nEffectPenalty = GetUnstackedBonus(true, s_bAlwaysStackPenalties ? NostackMode::Disabled : s_nSkillStackingMode);
+        case Constants::EffectBonusType::SavingThrow:
+            {
+                uint32_t nSavingThrowBonusLimit = Globals::AppManager()->m_pServerExoApp->GetSavingThrowBonusLimit();
+                nEffectBonus = std::min(nEffectBonus, nSavingThrowBonusLimit);
+                nEffectPenalty = std::min(nEffectPenalty, nSavingThrowBonusLimit);
+            }
 
+            if (thisPtr->m_pStats->HasFeat(Constants::Feat::SacredDefense1))
+            {
+                int nChampionLevel = thisPtr->m_pStats->GetNumLevelsOfClass(Constants::ClassType::DivineChampion);
+                if (nChampionLevel > 1)
+                    nEffectBonus += nChampionLevel / 2;
+            }
+
+            return nEffectBonus - nEffectPenalty;
+
+        case Constants::EffectBonusType::Ability:
+            {
+                uint32_t nAbilityBonusLimit = Globals::AppManager()->m_pServerExoApp->GetAbilityBonusLimit();
+                uint32_t nAbilityPenaltyLimit = Globals::AppManager()->m_pServerExoApp->GetAbilityPenaltyLimit();
+                nEffectBonus = std::min(nEffectBonus, nAbilityBonusLimit);
+                nEffectPenalty = std::min(nEffectPenalty, nAbilityPenaltyLimit);
+            }
+            return nEffectBonus - nEffectPenalty;
+
+        case Constants::EffectBonusType::Skill:
             {
                 uint32_t nSkillBonusLimit = Globals::AppManager()->m_pServerExoApp->GetSkillBonusLimit();
                 nEffectBonus = std::min(nEffectBonus, nSkillBonusLimit);
@@ -447,6 +687,7 @@ NWNX_EXPORT ArgumentStack SetSpellBonusType(ArgumentStack&& args)
       ASSERT_OR_THROW(nBonusType <= NostackType::Max);
 
     s_nSpellBonusTypes[nSpellId] = nBonusType;
+    s_cacheGeneration++;
 
     return {};
 }
@@ -127,7 +127,14 @@ NWNX_EXPORT ArgumentStack SetMaxHitPoints(ArgumentStack&& args)
 NWNX_EXPORT ArgumentStack Serialize(ArgumentStack&& args)
 {
     if (auto *pObject = Utils::PopGameObject(args))
-        return Utils::SerializeGameObjectB64(pObject);
+    {
+        // Older nwnx_object.nss versions don't push bCompress.
+        const bool bCompress = !args.empty() && !!args.extract<int32_t>();
+
+        std::string serialized;
+        Utils::SerializeGameObjectB64(pObject, serialized, true, bCompress);
+        return serialized;
+    }
 
     return "";
 }
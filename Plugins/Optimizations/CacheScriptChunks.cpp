@@ -5,19 +5,201 @@
 #include "API/CExoResMan.hpp"
 #include "API/CTlkTable.hpp"
 
+#include <chrono>
+#include <list>
+#include <string_view>
+
 namespace Optimizations {
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
+using namespace std::chrono;
+
+namespace {
+
+struct CachedChunk
+{
+    std::string m_text;
+    bool m_wrapIntoMain;
+    DataBlockRef m_code;
+    DataBlockRef m_ndb;
+    size_t m_bytes;
+    // Pinned chunks (e.g. event subscribers) are never evicted.
+    uint32_t m_pins = 0;
+};
+
+// Views into CachedChunk::m_text, which doesn't move while the chunk is cached.
+struct ChunkKey
+{
+    std::string_view m_text;
+    bool m_wrapIntoMain;
+
+    bool operator==(const ChunkKey& other) const
+    {
+        return m_wrapIntoMain == other.m_wrapIntoMain && m_text == other.m_text;
+    }
+};
+
+struct ChunkKeyHash
+{
+    size_t operator()(const ChunkKey& key) const
+    {
+        return std::hash<std::string_view>{}(key.m_text) ^ key.m_wrapIntoMain;
+    }
+};
+
+struct Stats
+{
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
+
+}
+
+// Most recently used first.
+static std::list<CachedChunk> s_ChunkLRU;
+static std::unordered_map<ChunkKey, std::list<CachedChunk>::iterator, ChunkKeyHash> s_CachedScriptChunks;
+static size_t s_CachedBytes;
+static size_t s_MaxBytes;
+static size_t s_PinnedChunks;
+static Stats s_Stats;
+static steady_clock::time_point s_LastMetricsReport;
+
+static void EraseChunk(std::list<CachedChunk>::iterator it)
+{
+    s_CachedBytes -= it->m_bytes;
+    if (it->m_pins)
+        s_PinnedChunks--;
+    s_CachedScriptChunks.erase({it->m_text, it->m_wrapIntoMain});
+    s_ChunkLRU.erase(it);
+}
+
+// With bKeepNewest the most recently used chunk stays, its caller is still holding on to it.
+static void EvictChunks(bool bKeepNewest = false)
+{
+    // it is the end of the list or a pinned chunk, neither of which is ever erased here.
+    auto it = s_ChunkLRU.end();
+    while (s_CachedBytes > s_MaxBytes && it != s_ChunkLRU.begin())
+    {
+        auto cur = std::prev(it);
+        if (bKeepNewest && cur == s_ChunkLRU.begin())
+            break;
+
+        if (cur->m_pins)
+        {
+            it = cur;
+            continue;
+        }
+
+        EraseChunk(cur);
+        s_Stats.m_evictions++;
+    }
+}
+
+static CachedChunk* FindChunk(std::string_view text, bool bWrapIntoMain)
+{
+    auto it = s_CachedScriptChunks.find({text, bWrapIntoMain});
+    if (it == s_CachedScriptChunks.end())
+        return nullptr;
+
+    s_ChunkLRU.splice(s_ChunkLRU.begin(), s_ChunkLRU, it->second);
+    return &*it->second;
+}
+
+// Compiles and caches a chunk. Returns nullptr and sets nError on failure. The new chunk can leave the cache over
+// budget, callers that don't pin it run EvictChunks() once they're done with it.
+static CachedChunk* CompileChunk(const CExoString& sScriptChunk, bool bWrapIntoMain, int32_t& nError)
+{
+    auto *pJitCompiler = Globals::VirtualMachine()->m_pJitCompiler;
+
+    nError = pJitCompiler->CompileScriptChunk(sScriptChunk, bWrapIntoMain);
+    if (nError < 0)
+        return nullptr;
+
+    char *pScriptData;
+    int32_t nScriptDataSize;
+    pJitCompiler->GetCompiledScriptCode(&pScriptData, &nScriptDataSize);
+
+    if (nScriptDataSize > 13 &&
+        pScriptData[0] == 'N' && pScriptData[1] == 'C' && pScriptData[2] == 'S' && pScriptData[3] == ' ' &&
+        pScriptData[4] == 'V' && pScriptData[6] == '.' && pScriptData[8] == 'B')
+    {
+        int32_t nVersion = 0;
+        if (pScriptData[5] >= '1' && pScriptData[5] <= '9')
+            nVersion += (pScriptData[5] - '0') * 10;
+        if (pScriptData[7] >= '1' && pScriptData[7] <= '9')
+            nVersion += pScriptData[7] - '0';
+        if (nVersion != 10)
+        {
+            nError = -635;
+            return nullptr;
+        }
+
+        pScriptData += 13;
+        nScriptDataSize -= 13;
+
+        s_ChunkLRU.emplace_front();
+        auto& chunk = s_ChunkLRU.front();
+        chunk.m_text = sScriptChunk.CStr();
+        chunk.m_wrapIntoMain = bWrapIntoMain;
+        chunk.m_code = std::make_shared<DataBlock>();
+        chunk.m_code->Append(pScriptData, nScriptDataSize);
+        chunk.m_ndb = Globals::ExoResMan()->Get("!Chunk", Globals::VirtualMachine()->m_nResTypeDebug);
+        chunk.m_bytes = sizeof(CachedChunk) + 2 * chunk.m_text.size() + nScriptDataSize + (chunk.m_ndb ? chunk.m_ndb->Used() : 0);
 
-static std::unordered_map<int32_t, std::pair<DataBlockRef, DataBlockRef>> s_CachedScriptChunks;
+        s_CachedScriptChunks.emplace(ChunkKey{chunk.m_text, bWrapIntoMain}, s_ChunkLRU.begin());
+        s_CachedBytes += chunk.m_bytes;
+        EvictChunks(true);
+
+        return &chunk;
+    }
+
+    nError = -635;
+    return nullptr;
+}
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_LastMetricsReport < seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Optimizations");
+    if (!pPlugin)
+        return;
+
+    const auto lookups = s_Stats.m_hits + s_Stats.m_misses;
+    pPlugin->GetServices()->m_metrics->Push(
+        "ScriptChunkCache",
+        {
+            { "hits", std::to_string(s_Stats.m_hits) },
+            { "misses", std::to_string(s_Stats.m_misses) },
+            { "hit_rate", std::to_string(lookups ? static_cast<double>(s_Stats.m_hits) / lookups : 0.0) },
+            { "evictions", std::to_string(s_Stats.m_evictions) },
+            { "bytes", std::to_string(s_CachedBytes) },
+            { "entries", std::to_string(s_ChunkLRU.size()) },
+            { "pinned", std::to_string(s_PinnedChunks) },
+        });
+    s_Stats = Stats();
+}
+
+static std::string FormatCompileError(int32_t nError)
+{
+    CExoString retVal;
+    retVal.Format("%s: %s", Globals::TlkTable()->GetSimpleString(-nError).CStr(), Globals::VirtualMachine()->m_pJitCompiler->m_sCapturedError.CStr());
+    return retVal.CStr();
+}
 
 void CacheScriptChunks() __attribute__((constructor));
 void CacheScriptChunks()
 {
     if (Config::Get<bool>("CACHE_SCRIPT_CHUNKS", false))
     {
-        LOG_INFO("Caching script chunks");
+        s_MaxBytes = static_cast<size_t>(Config::Get<int32_t>("CACHE_SCRIPT_CHUNKS_MAX_MEMORY_MB", 64)) * 1024 * 1024;
+
+        LOG_INFO("Caching script chunks, using up to %d MB", s_MaxBytes / (1024 * 1024));
 
         static Hooks::Hook s_SetUpJITCompiledScript = Hooks::HookFunction(&CVirtualMachine::SetUpJITCompiledScript,
         +[](CVirtualMachine *pVirtualMachine, const CExoString& sScriptChunk, BOOL bWrapIntoMain) -> int32_t
@@ -29,63 +211,76 @@ void CacheScriptChunks()
                 return -633;
             }
 
-            int32_t nHash = sScriptChunk.GetHash();
+            ReportMetrics();
 
-            auto cachedScript = s_CachedScriptChunks.find(nHash);
-            if (cachedScript != s_CachedScriptChunks.end())
+            auto *pChunk = FindChunk(sScriptChunk.CStr(), !!bWrapIntoMain);
+            if (pChunk)
             {
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = "!Chunk";
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = 0;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = sScriptChunk;
-                pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], cachedScript->second.first, cachedScript->second.second);
-                return 0;
+                s_Stats.m_hits++;
             }
-
-            int32_t nReturnValue = pVirtualMachine->m_pJitCompiler->CompileScriptChunk(sScriptChunk, bWrapIntoMain);
-            if (nReturnValue < 0)
+            else
             {
-                --pVirtualMachine->m_nRecursionLevel;
-                return nReturnValue;
-            }
-
-            char *pScriptData;
-            int32_t nScriptDataSize;
-            pVirtualMachine->m_pJitCompiler->GetCompiledScriptCode(&pScriptData, &nScriptDataSize);
+                s_Stats.m_misses++;
 
-            if (pScriptData[0] == 'N' && pScriptData[1] == 'C' && pScriptData[2] == 'S' && pScriptData[3] == ' ' &&
-                pScriptData[4] == 'V' && pScriptData[6] == '.' && pScriptData[8] == 'B')
-            {
-                int32_t nVersion = 0;
-                if (pScriptData[5] >= '1' && pScriptData[5] <= '9')
-                    nVersion += (pScriptData[5] - '0') * 10;
-                if (pScriptData[7] >= '1' && pScriptData[7] <= '9')
-                    nVersion += pScriptData[7] - '0';
-                if (nVersion != 10)
+                int32_t nError;
+                pChunk = CompileChunk(sScriptChunk, !!bWrapIntoMain, nError);
+                if (!pChunk)
                 {
                     --pVirtualMachine->m_nRecursionLevel;
-                    return -635;
+                    return nError;
                 }
+            }
 
-                pScriptData += 13;
-                nScriptDataSize -= 13;
+            // Hold on to the code, the chunk can get evicted while it runs.
+            auto pCode = pChunk->m_code;
+            auto pNDB = pChunk->m_ndb;
+            // A chunk too big for the budget only lives for this run.
+            EvictChunks();
+
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = "!Chunk";
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = 0;
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = sScriptChunk;
+            pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], pCode, pNDB);
+            return 0;
+        }, Hooks::Order::Final);
 
-                DataBlockRef pScriptDataBlock = std::make_shared<DataBlock>();
-                pScriptDataBlock->Append(pScriptData, nScriptDataSize);
+        // Chunks subscribed to events are compiled right away and kept for as long as they are subscribed.
+        MessageBus::Subscribe("NWNX_OPTIMIZATIONS_PIN_SCRIPT_CHUNK",
+            [](const std::vector<std::string>& message)
+            {
+                ASSERT(message.size() == 2);
+                const bool bWrapIntoMain = message[1] == "1";
 
-                auto pNDB = Globals::ExoResMan()->Get("!Chunk", pVirtualMachine->m_nResTypeDebug);
+                auto *pChunk = FindChunk(message[0], bWrapIntoMain);
+                if (!pChunk)
+                {
+                    int32_t nError;
+                    pChunk = CompileChunk(message[0], bWrapIntoMain, nError);
+                    if (!pChunk)
+                    {
+                        LOG_WARNING("Failed to compile script chunk '%s': %s", message[0], FormatCompileError(nError));
+                        return;
+                    }
+                }
 
-                s_CachedScriptChunks[nHash] = std::make_pair(pScriptDataBlock, pNDB);
+                if (pChunk->m_pins++ == 0)
+                    s_PinnedChunks++;
+            });
 
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = "!Chunk";
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = 0;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = sScriptChunk;
-                pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], pScriptDataBlock, pNDB);
-                return 0;
-            }
+        MessageBus::Subscribe("NWNX_OPTIMIZATIONS_UNPIN_SCRIPT_CHUNK",
+            [](const std::vector<std::string>& message)
+            {
+                ASSERT(message.size() == 2);
+                auto it = s_CachedScriptChunks.find({message[0], message[1] == "1"});
+                if (it == s_CachedScriptChunks.end() || it->second->m_pins == 0)
+                    return;
 
-            --pVirtualMachine->m_nRecursionLevel;
-            return -635;
-        }, Hooks::Order::Final);
+                if (--it->second->m_pins == 0)
+                {
+                    s_PinnedChunks--;
+                    EvictChunks();
+                }
+            });
     }
 }
 
@@ -94,66 +289,31 @@ extern "C" ArgumentStack FlushCachedChunks(ArgumentStack&& args)
 {
     const auto scriptChunk = args.extract<std::string>();
 
-    if (scriptChunk.empty())
-        s_CachedScriptChunks.clear();
-    else
+    // Pinned chunks stay, their owners still need them.
+    for (auto it = s_ChunkLRU.begin(); it != s_ChunkLRU.end();)
     {
-        s_CachedScriptChunks.erase(CExoString(scriptChunk).GetHash());
+        if (!it->m_pins && (scriptChunk.empty() || it->m_text == scriptChunk))
+            EraseChunk(it++);
+        else
+            ++it;
     }
 
     return {};
 }
 
+// Compiles a chunk ahead of time, so the first run doesn't have to.
 extern "C" ArgumentStack CacheScriptChunk(ArgumentStack&& args)
 {
     const auto scriptChunk = args.extract<std::string>();
     const auto wrapIntoMain = args.extract<int32_t>();
 
-    if (scriptChunk.empty())
+    if (scriptChunk.empty() || FindChunk(scriptChunk, !!wrapIntoMain))
         return "";
 
-    int32_t nHash = CExoString(scriptChunk).GetHash();
-
-    if (s_CachedScriptChunks.find(nHash) != s_CachedScriptChunks.end())
-        return "";
-
-    int32_t nReturnValue = Globals::VirtualMachine()->m_pJitCompiler->CompileScriptChunk(scriptChunk, wrapIntoMain);
-    if (nReturnValue < 0)
-    {
-        CExoString retVal;
-        retVal.Format("%s: %s", Globals::TlkTable()->GetSimpleString(-nReturnValue).CStr(), Globals::VirtualMachine()->m_pJitCompiler->m_sCapturedError.CStr());
-        return retVal.CStr();
-    }
-
-    char *pScriptData;
-    int32_t nScriptDataSize;
-    Globals::VirtualMachine()->m_pJitCompiler->GetCompiledScriptCode(&pScriptData, &nScriptDataSize);
-
-    if (pScriptData[0] == 'N' && pScriptData[1] == 'C' && pScriptData[2] == 'S' && pScriptData[3] == ' ' &&
-        pScriptData[4] == 'V' && pScriptData[6] == '.' && pScriptData[8] == 'B')
-    {
-        int32_t nVersion = 0;
-        if (pScriptData[5] >= '1' && pScriptData[5] <= '9')
-            nVersion += (pScriptData[5] - '0') * 10;
-        if (pScriptData[7] >= '1' && pScriptData[7] <= '9')
-            nVersion += pScriptData[7] - '0';
-        if (nVersion != 10)
-        {
-            CExoString retVal;
-            retVal.Format("%s: %s", Globals::TlkTable()->GetSimpleString(635).CStr(), Globals::VirtualMachine()->m_pJitCompiler->m_sCapturedError.CStr());
-            return retVal.CStr();
-        }
-
-        pScriptData += 13;
-        nScriptDataSize -= 13;
-
-        DataBlockRef pScriptDataBlock = std::make_shared<DataBlock>();
-        pScriptDataBlock->Append(pScriptData, nScriptDataSize);
-
-        auto pNDB = Globals::ExoResMan()->Get("!Chunk", Constants::ResRefType::NDB);
-
-        s_CachedScriptChunks[nHash] = std::make_pair(pScriptDataBlock, pNDB);
-    }
+    int32_t nError;
+    if (!CompileChunk(scriptChunk, !!wrapIntoMain, nError))
+        return FormatCompileError(nError);
+    EvictChunks();
 
     return "";
 }
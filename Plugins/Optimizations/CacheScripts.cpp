@@ -1,15 +1,258 @@
 #include "nwnx.hpp"
+#include "../../Core/NWNXCore.hpp"
 
 #include "API/CVirtualMachine.hpp"
 #include "API/CScriptCompiler.hpp"
 #include "API/CExoResMan.hpp"
+#include "API/CExoBase.hpp"
+#include "API/CExoAliasList.hpp"
+#include "API/CExoStringList.hpp"
+#include "API/CResRef.hpp"
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+namespace Core {
+    extern NWNXCore* g_core;
+}
 
 namespace Optimizations {
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
+using namespace std::chrono;
+
+namespace {
+
+struct CachedScript
+{
+    DataBlockRef m_data;
+    // Set if the script was found in a resource directory the engine watches for changes.
+    std::string m_alias;
+    std::string m_path;
+    int64_t m_mtime = 0;
+};
+
+struct Stats
+{
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_invalidations = 0;
+};
+
+}
+
+// Keyed by the lowercased resref; resrefs are case insensitive.
+static std::unordered_map<std::string, CachedScript> s_CachedScripts;
+static size_t s_CachedBytes;
+static Stats s_Stats;
+static size_t s_WatchedScripts;
+// Alias and path of every resource directory added with change detection.
+static std::vector<std::pair<std::string, std::string>> s_WatchedDirectories;
+static bool s_WatchedDirectoriesResolved;
+static steady_clock::time_point s_LastWatchCheck;
+static steady_clock::time_point s_LastMetricsReport;
+
+static std::string ScriptKey(const CExoString& sScript)
+{
+    std::string key = sScript.CStr();
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return key;
+}
+
+static int64_t GetMTime(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return -1;
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+static void ResolveWatchedDirectories()
+{
+    if (s_WatchedDirectoriesResolved)
+        return;
+    s_WatchedDirectoriesResolved = true;
+
+    auto aliases = Core::g_core->GetCustomResourceDirectoryAliases();
+    aliases.emplace_back("DEVELOPMENT");
 
-static std::unordered_map<int32_t, DataBlockRef> s_CachedScripts;
+    for (auto& alias : aliases)
+    {
+        std::string path = Globals::ExoBase()->m_pcExoAliasList->GetAliasPath(alias).CStr();
+        if (path.empty())
+            continue;
+        if (path.back() != '/')
+            path += '/';
+        s_WatchedDirectories.emplace_back(alias, path);
+    }
+}
+
+static void FlushCache()
+{
+    s_Stats.m_invalidations += s_CachedScripts.size();
+    s_CachedScripts.clear();
+    s_CachedBytes = 0;
+    s_WatchedScripts = 0;
+}
+
+static void EraseCachedScript(std::unordered_map<std::string, CachedScript>::iterator it)
+{
+    s_Stats.m_invalidations++;
+    s_CachedBytes -= it->second.m_data->Used();
+    if (!it->second.m_path.empty())
+        s_WatchedScripts--;
+    s_CachedScripts.erase(it);
+}
+
+// Returns the cached bytecode, loading it through ResMan if needed. nError is set on failure.
+static DataBlockRef GetScript(CVirtualMachine *pVirtualMachine, const CExoString& sScript, int32_t& nError)
+{
+    auto key = ScriptKey(sScript);
+
+    auto cachedScript = s_CachedScripts.find(key);
+    if (cachedScript != s_CachedScripts.end())
+    {
+        s_Stats.m_hits++;
+        return cachedScript->second.m_data;
+    }
+
+    s_Stats.m_misses++;
+
+    auto pVMFile = Globals::ExoResMan()->Get(sScript, pVirtualMachine->m_nResTypeCompiled);
+    if (!pVMFile)
+    {
+        nError = -634;
+        return nullptr;
+    }
+
+    char *pScriptData = (char*)pVMFile->Data();
+    uint32_t nScriptDataSize = pVMFile->Used();
+
+    if (nScriptDataSize > 13 &&
+        pScriptData[0] == 'N' && pScriptData[1] == 'C' && pScriptData[2] == 'S' && pScriptData[3] == ' ' &&
+        pScriptData[4] == 'V' && pScriptData[6] == '.' && pScriptData[8] == 'B')
+    {
+        int32_t nVersion = 0;
+        if (pScriptData[5] >= '1' && pScriptData[5] <= '9')
+            nVersion += (pScriptData[5] - '0') * 10;
+        if (pScriptData[7] >= '1' && pScriptData[7] <= '9')
+            nVersion += pScriptData[7] - '0';
+        if (nVersion != 10)
+        {
+            nError = -635;
+            return nullptr;
+        }
+
+        pScriptData += 13;
+        nScriptDataSize -= 13;
+
+        CachedScript script;
+        script.m_data = std::make_shared<DataBlock>();
+        script.m_data->Append(pScriptData, nScriptDataSize);
+
+        ResolveWatchedDirectories();
+        for (auto& dir : s_WatchedDirectories)
+        {
+            auto path = dir.second + key + ".ncs";
+            auto mtime = GetMTime(path);
+            if (mtime >= 0)
+            {
+                script.m_alias = dir.first;
+                script.m_path = std::move(path);
+                script.m_mtime = mtime;
+                s_WatchedScripts++;
+                break;
+            }
+        }
+
+        s_CachedBytes += script.m_data->Used();
+        return s_CachedScripts.emplace(std::move(key), std::move(script)).first->second.m_data;
+    }
+
+    nError = -635;
+    return nullptr;
+}
+
+// Scripts in watched resource directories can be recompiled while the server runs.
+// Once a second, look for changed files and have ResMan rescan their directory,
+// which in turn flushes the cache.
+static void CheckWatchedScripts()
+{
+    if (s_WatchedScripts == 0)
+        return;
+
+    const auto now = steady_clock::now();
+    if (now - s_LastWatchCheck < seconds(1))
+        return;
+    s_LastWatchCheck = now;
+
+    std::vector<std::string> changed;
+    for (auto& it : s_CachedScripts)
+    {
+        auto& script = it.second;
+        if (script.m_path.empty() || GetMTime(script.m_path) == script.m_mtime)
+            continue;
+
+        LOG_DEBUG("Script '%s' changed on disk.", it.first);
+        if (std::find(changed.begin(), changed.end(), script.m_alias) == changed.end())
+            changed.emplace_back(script.m_alias);
+    }
+
+    for (auto& alias : changed)
+        Globals::ExoResMan()->UpdateResourceDirectory(alias + ":");
+}
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_LastMetricsReport < seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Optimizations");
+    if (!pPlugin)
+        return;
+
+    pPlugin->GetServices()->m_metrics->Push(
+        "ScriptCache",
+        {
+            { "hits", std::to_string(s_Stats.m_hits) },
+            { "misses", std::to_string(s_Stats.m_misses) },
+            { "invalidations", std::to_string(s_Stats.m_invalidations) },
+            { "bytes", std::to_string(s_CachedBytes) },
+            { "entries", std::to_string(s_CachedScripts.size()) },
+        });
+    s_Stats = Stats();
+}
+
+static void PrewarmCache()
+{
+    const auto start = steady_clock::now();
+    auto *pVirtualMachine = Globals::VirtualMachine();
+
+    CExoStringList *pList = Globals::ExoResMan()->GetResOfType(pVirtualMachine->m_nResTypeCompiled, false);
+    if (!pList)
+        return;
+
+    size_t nFailed = 0;
+    for (int i = 0; i < pList->m_nCount; i++)
+    {
+        int32_t nError = 0;
+        if (!GetScript(pVirtualMachine, *pList->m_pStrings[i], nError))
+            nFailed++;
+    }
+    delete pList;
+
+    // Don't report the prewarm as misses.
+    s_Stats = Stats();
+
+    LOG_INFO("Prewarmed the script cache with %d scripts (%d bytes) in %dms, %d failed to load.",
+             s_CachedScripts.size(), s_CachedBytes,
+             duration_cast<milliseconds>(steady_clock::now() - start).count(), nFailed);
+}
 
 void CacheScripts() __attribute__((constructor));
 void CacheScripts()
@@ -32,59 +275,85 @@ void CacheScripts()
             if (psFileName)
                 sScript = *psFileName;
 
-            int32_t nHash = sScript.GetHash();
+            CheckWatchedScripts();
+            ReportMetrics();
 
-            auto cachedScript = s_CachedScripts.find(nHash);
-            if (cachedScript != s_CachedScripts.end())
-            {
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = sScript;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = nScriptEventID;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = "";
-                pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], cachedScript->second);
-                return 0;
-            }
-
-            auto pVMFile = Globals::ExoResMan()->Get(sScript, pVirtualMachine->m_nResTypeCompiled);
-            if (!pVMFile)
+            int32_t nError = 0;
+            auto pScriptDataBlock = GetScript(pVirtualMachine, sScript, nError);
+            if (!pScriptDataBlock)
             {
                 --pVirtualMachine->m_nRecursionLevel;
-                return -634;
+                return nError;
             }
 
-            char *pScriptData = (char*)pVMFile->Data();
-            uint32_t nScriptDataSize = pVMFile->Used();
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = sScript;
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = nScriptEventID;
+            pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = "";
+            pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], pScriptDataBlock);
+            return 0;
+        }, Hooks::Order::Final);
 
-            if (pScriptData[0] == 'N' && pScriptData[1] == 'C' && pScriptData[2] == 'S' && pScriptData[3] == ' ' &&
-                pScriptData[4] == 'V' && pScriptData[6] == '.' && pScriptData[8] == 'B')
-            {
-                int32_t nVersion = 0;
-                if (pScriptData[5] >= '1' && pScriptData[5] <= '9')
-                    nVersion += (pScriptData[5] - '0') * 10;
-                if (pScriptData[7] >= '1' && pScriptData[7] <= '9')
-                    nVersion += pScriptData[7] - '0';
-                if (nVersion != 10)
-                {
-                    --pVirtualMachine->m_nRecursionLevel;
-                    return -635;
-                }
-
-                pScriptData += 13;
-                nScriptDataSize -= 13;
-
-                DataBlockRef pScriptDataBlock = std::make_shared<DataBlock>();
-                pScriptDataBlock->Append(pScriptData, nScriptDataSize);
-                s_CachedScripts[nHash] = pScriptDataBlock;
-
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptName = sScript;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_nScriptEventID = nScriptEventID;
-                pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel].m_sScriptChunk = "";
-                pVirtualMachine->InitializeScript(&pVirtualMachine->m_pVirtualMachineScript[pVirtualMachine->m_nRecursionLevel], pScriptDataBlock);
-                return 0;
-            }
+        // Anything that changes what ResMan serves may change which script a resref resolves to.
+        static Hooks::Hook s_AddKeyTable = Hooks::HookFunction(&CExoResMan::AddKeyTable,
+        +[](CExoResMan *pThis, uint32_t nPriority, const CExoString& sName, uint32_t nTableType, BOOL bDetectChanges) -> BOOL
+        {
+            FlushCache();
+            return s_AddKeyTable->CallOriginal<BOOL>(pThis, nPriority, sName, nTableType, bDetectChanges);
+        }, Hooks::Order::Earliest);
 
-            --pVirtualMachine->m_nRecursionLevel;
-            return -635;
-        }, Hooks::Order::Final);
+        static Hooks::Hook s_RemoveKeyTable = Hooks::HookFunction(&CExoResMan::RemoveKeyTable,
+        +[](CExoResMan *pThis, const CExoString& sName, uint32_t nTableType, BOOL bEmitWarningOnFailure) -> BOOL
+        {
+            FlushCache();
+            return s_RemoveKeyTable->CallOriginal<BOOL>(pThis, sName, nTableType, bEmitWarningOnFailure);
+        }, Hooks::Order::Earliest);
+
+        static Hooks::Hook s_UpdateKeyTable = Hooks::HookFunction(&CExoResMan::UpdateKeyTable,
+        +[](CExoResMan *pThis, const CExoString& sName, uint32_t nTableType) -> BOOL
+        {
+            FlushCache();
+            return s_UpdateKeyTable->CallOriginal<BOOL>(pThis, sName, nTableType);
+        }, Hooks::Order::Earliest);
+
+        static Hooks::Hook s_UpdateResourceDirectory = Hooks::HookFunction(&CExoResMan::UpdateResourceDirectory,
+        +[](CExoResMan *pThis, const CExoString& sName) -> BOOL
+        {
+            FlushCache();
+            return s_UpdateResourceDirectory->CallOriginal<BOOL>(pThis, sName);
+        }, Hooks::Order::Earliest);
+
+        static Hooks::Hook s_AddOverride = Hooks::HookFunction(&CExoResMan::AddOverride,
+        +[](CExoResMan *pThis, const CResRef& oldName, const CResRef& newName, RESTYPE nType) -> void
+        {
+            if (nType == Constants::ResRefType::NCS)
+                FlushCache();
+            s_AddOverride->CallOriginal<void>(pThis, oldName, newName, nType);
+        }, Hooks::Order::Earliest);
+
+        static Hooks::Hook s_RemoveOverride = Hooks::HookFunction(&CExoResMan::RemoveOverride,
+        +[](CExoResMan *pThis, const CResRef& name, RESTYPE nType) -> void
+        {
+            if (nType == Constants::ResRefType::NCS)
+                FlushCache();
+            s_RemoveOverride->CallOriginal<void>(pThis, name, nType);
+        }, Hooks::Order::Earliest);
+
+        static Hooks::Hook s_ClearOverrides = Hooks::HookFunction(&CExoResMan::ClearOverrides,
+        +[](CExoResMan *pThis) -> void
+        {
+            FlushCache();
+            s_ClearOverrides->CallOriginal<void>(pThis);
+        }, Hooks::Order::Earliest);
+
+        if (Config::Get<bool>("CACHE_SCRIPTS_PREWARM", false))
+        {
+            MessageBus::Subscribe("NWNX_CORE_SIGNAL",
+                [](const std::vector<std::string>& message)
+                {
+                    if (message[0] == "ON_MODULE_LOAD_FINISH")
+                        PrewarmCache();
+                });
+        }
     }
 }
 
@@ -94,9 +363,13 @@ extern "C" ArgumentStack FlushCachedScripts(ArgumentStack&& args)
     const auto script = args.extract<std::string>();
 
     if (script.empty())
-        s_CachedScripts.clear();
+        FlushCache();
     else
-        s_CachedScripts.erase(CExoString(script).GetHash());
+    {
+        auto it = s_CachedScripts.find(ScriptKey(script));
+        if (it != s_CachedScripts.end())
+            EraseCachedScript(it);
+    }
 
     return {};
 }
@@ -0,0 +1,446 @@
+#include "nwnx.hpp"
+
+#include "API/CGameEffect.hpp"
+#include "API/CNWSCombatAttackData.hpp"
+#include "API/CNWSCombatRound.hpp"
+#include "API/CNWSCreature.hpp"
+#include "API/CNWSCreatureStats.hpp"
+#include "API/CNWSObject.hpp"
+#include "API/CNWVisibilityNode.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Optimizations {
+
+using namespace NWNXLib;
+using namespace NWNXLib::API;
+using namespace std::chrono;
+
+namespace {
+
+enum MemoFunction : uint8_t
+{
+    AttackModifierVersus,
+    ArmorClassVersus,
+    DamageBonus,
+    TotalEffectBonus,
+};
+
+// What the modifier functions read from the current attack, besides the two creatures.
+struct MemoKey
+{
+    uint8_t m_nFunction;
+    uint8_t m_nParam;
+    uint8_t m_nAttackType;
+    uint8_t m_nOtherAttackType;
+    uint8_t m_nCombatMode;
+    uint16_t m_nSpecialAttack;
+    ObjectID m_oidOther;
+
+    bool operator==(const MemoKey& other) const
+    {
+        return m_nFunction == other.m_nFunction && m_nParam == other.m_nParam && m_nAttackType == other.m_nAttackType &&
+               m_nOtherAttackType == other.m_nOtherAttackType && m_nCombatMode == other.m_nCombatMode &&
+               m_nSpecialAttack == other.m_nSpecialAttack && m_oidOther == other.m_oidOther;
+    }
+};
+
+// Versions of everything an entry was computed from, besides the memoizing creature itself.
+struct MemoVersions
+{
+    uint32_t m_nOther;
+    uint32_t m_nGlobal;
+
+    bool operator==(const MemoVersions& other) const
+    {
+        return m_nOther == other.m_nOther && m_nGlobal == other.m_nGlobal;
+    }
+};
+
+// Where the two creatures stand and face, and whom they attack. Flanking is decided from these,
+// so an entry only holds while neither of the pair moves or turns.
+struct MemoPlacement
+{
+    Vector m_vSelf;
+    Vector m_vSelfFacing;
+    Vector m_vOther;
+    Vector m_vOtherFacing;
+    ObjectID m_oidSelfTarget;
+    ObjectID m_oidOtherTarget;
+
+    bool operator==(const MemoPlacement& other) const
+    {
+        auto same = [](const Vector& a, const Vector& b) { return a.x == b.x && a.y == b.y && a.z == b.z; };
+        return same(m_vSelf, other.m_vSelf) && same(m_vSelfFacing, other.m_vSelfFacing) &&
+               same(m_vOther, other.m_vOther) && same(m_vOtherFacing, other.m_vOtherFacing) &&
+               m_oidSelfTarget == other.m_oidSelfTarget && m_oidOtherTarget == other.m_oidOtherTarget;
+    }
+};
+
+struct MemoEntry
+{
+    MemoKey m_key;
+    MemoVersions m_versions;
+    MemoPlacement m_placement;
+    int32_t m_nValue;
+};
+
+// Modifiers an object computed this round. Objects that are only ever the other side of a
+// calculation just carry the version.
+struct MemoTable
+{
+    // Bumped whenever the object's effects, equipment or stats change.
+    uint32_t m_nVersion = 1;
+    std::vector<MemoEntry> m_entries;
+};
+
+struct Stats
+{
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_invalidations = 0;
+};
+
+}
+
+static Stats s_Stats;
+static steady_clock::time_point s_LastMetricsReport;
+
+// Bumped whenever a plugin changes how modifiers are calculated, e.g. NWNX_Weapon_SetWeaponFocusFeat().
+static uint32_t s_GlobalVersion = 1;
+
+static POS::ExtensionId GetExtensionId()
+{
+    static const auto s_extensionId = POS::RegisterExtension([](void *p) { delete static_cast<MemoTable*>(p); });
+    return s_extensionId;
+}
+
+static MemoTable& GetMemoTable(CNWSObject *pObject)
+{
+    auto *pMemo = static_cast<MemoTable*>(POS::GetExtension(pObject, GetExtensionId()));
+    if (!pMemo)
+    {
+        pMemo = new MemoTable();
+        POS::SetExtension(pObject, GetExtensionId(), pMemo);
+    }
+    return *pMemo;
+}
+
+static void Invalidate(CNWSObject *pObject)
+{
+    if (!pObject)
+        return;
+
+    if (auto *pMemo = static_cast<MemoTable*>(POS::GetExtension(pObject, GetExtensionId())))
+    {
+        pMemo->m_nVersion++;
+        pMemo->m_entries.clear();
+        s_Stats.m_invalidations++;
+    }
+}
+
+// Drops what the two creatures remembered about each other, e.g. when one of them starts or stops seeing the other.
+static void InvalidatePair(CNWSObject *pObject, ObjectID oidOther)
+{
+    auto erase = [](CNWSObject *pSelf, ObjectID oidOther)
+    {
+        if (auto *pMemo = static_cast<MemoTable*>(POS::GetExtension(pSelf, GetExtensionId())))
+        {
+            auto& entries = pMemo->m_entries;
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [&](const MemoEntry& entry) { return entry.m_key.m_oidOther == oidOther; }),
+                          entries.end());
+        }
+    };
+
+    erase(pObject, oidOther);
+    if (auto *pOther = Utils::AsNWSObject(Utils::GetGameObject(oidOther)))
+        erase(pOther, pObject->m_idSelf);
+    s_Stats.m_invalidations++;
+}
+
+// Packs the visibility node the creature has for another one, 0 if there is none.
+static uint8_t GetVisibility(CNWSCreature *pCreature, ObjectID oidCreature)
+{
+    auto *pNode = pCreature->GetVisibleListElement(oidCreature);
+    if (!pNode)
+        return 0;
+    return 0x80 | pNode->m_bSeen | (pNode->m_bHeard << 1) | (pNode->m_nSanctuary << 2) | (pNode->m_bInvisible << 4);
+}
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_LastMetricsReport < seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Optimizations");
+    if (!pPlugin)
+        return;
+
+    pPlugin->GetServices()->m_metrics->Push(
+        "CombatMemo",
+        {
+            { "hits", std::to_string(s_Stats.m_hits) },
+            { "misses", std::to_string(s_Stats.m_misses) },
+            { "invalidations", std::to_string(s_Stats.m_invalidations) },
+        });
+    s_Stats = Stats();
+}
+
+static ObjectID GetAttackTarget(CNWSObject *pObject)
+{
+    auto *pCreature = Utils::AsNWSCreature(pObject);
+    return pCreature ? pCreature->m_oidAttackTarget : Constants::OBJECT_INVALID;
+}
+
+static uint8_t GetCurrentWeaponAttackType(CNWSObject *pObject)
+{
+    auto *pCreature = Utils::AsNWSCreature(pObject);
+    if (!pCreature || !pCreature->m_pcCombatRound || !pCreature->m_pcCombatRound->m_bRoundStarted)
+        return 0;
+    return static_cast<uint8_t>(pCreature->m_pcCombatRound->GetWeaponAttackType());
+}
+
+// Only used while the creature is in a combat round; its memo is emptied when the next round starts.
+// Combat debugging writes to the attack's debug text, so it always runs the full calculation.
+template <typename T, typename Compute>
+static T Memoize(CNWSCreature *pSelf, CNWSObject *pOther, MemoFunction nFunction, uint8_t nParam, Compute&& compute)
+{
+    if (!pSelf || !pSelf->m_pcCombatRound || !pSelf->m_pcCombatRound->m_bRoundStarted || *Globals::EnableCombatDebugging())
+        return compute();
+
+    ReportMetrics();
+
+    auto *pRound = pSelf->m_pcCombatRound;
+    auto *pAttack = pRound->GetAttack(pRound->m_nCurrentAttack);
+
+    MemoKey key;
+    key.m_nFunction = nFunction;
+    key.m_nParam = nParam;
+    key.m_nAttackType = static_cast<uint8_t>(pRound->GetWeaponAttackType());
+    key.m_nOtherAttackType = GetCurrentWeaponAttackType(pOther);
+    key.m_nCombatMode = pSelf->m_nCombatMode;
+    key.m_nSpecialAttack = pAttack ? pAttack->m_nAttackType : 0;
+    key.m_oidOther = pOther ? pOther->m_idSelf : Constants::OBJECT_INVALID;
+
+    MemoVersions versions;
+    versions.m_nOther = pOther ? GetMemoTable(pOther).m_nVersion : 0;
+    versions.m_nGlobal = s_GlobalVersion;
+
+    MemoPlacement placement;
+    placement.m_vSelf = pSelf->m_vPosition;
+    placement.m_vSelfFacing = pSelf->m_vOrientation;
+    placement.m_vOther = pOther ? pOther->m_vPosition : Vector();
+    placement.m_vOtherFacing = pOther ? pOther->m_vOrientation : Vector();
+    placement.m_oidSelfTarget = pSelf->m_oidAttackTarget;
+    placement.m_oidOtherTarget = GetAttackTarget(pOther);
+
+    for (auto& entry : GetMemoTable(pSelf).m_entries)
+    {
+        if (entry.m_key == key && entry.m_versions == versions && entry.m_placement == placement)
+        {
+            s_Stats.m_hits++;
+            return static_cast<T>(entry.m_nValue);
+        }
+    }
+
+    s_Stats.m_misses++;
+
+    // The hook chain below may memoize other modifiers, so look the entry up again afterwards.
+    const T value = compute();
+
+    auto& entries = GetMemoTable(pSelf).m_entries;
+    for (auto& entry : entries)
+    {
+        if (entry.m_key == key)
+        {
+            entry.m_versions = versions;
+            entry.m_placement = placement;
+            entry.m_nValue = value;
+            return value;
+        }
+    }
+    entries.push_back({key, versions, placement, value});
+    return value;
+}
+
+void CombatMemo() __attribute__((constructor));
+void CombatMemo()
+{
+    if (!Config::Get<bool>("COMBAT_MEMO", false))
+        return;
+
+    LOG_INFO("Memoizing combat modifiers for the duration of a combat round.");
+
+    // Hooked first so the memo sits in front of every plugin's modifier hooks.
+    static Hooks::Hook s_GetAttackModifierVersusHook = Hooks::HookFunction(&CNWSCreatureStats::GetAttackModifierVersus,
+    +[](CNWSCreatureStats *pThis, CNWSCreature *pTarget) -> int32_t
+    {
+        return Memoize<int32_t>(pThis->m_pBaseCreature, pTarget, AttackModifierVersus, 0,
+            [&]() { return s_GetAttackModifierVersusHook->CallOriginal<int32_t>(pThis, pTarget); });
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_GetArmorClassVersusHook = Hooks::HookFunction(&CNWSCreatureStats::GetArmorClassVersus,
+    +[](CNWSCreatureStats *pThis, CNWSCreature *pAttacker, BOOL bVsTouchAttack) -> int16_t
+    {
+        return Memoize<int16_t>(pThis->m_pBaseCreature, pAttacker, ArmorClassVersus, !!bVsTouchAttack,
+            [&]() { return s_GetArmorClassVersusHook->CallOriginal<int16_t>(pThis, pAttacker, bVsTouchAttack); });
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_GetDamageBonusHook = Hooks::HookFunction(&CNWSCreatureStats::GetDamageBonus,
+    +[](CNWSCreatureStats *pThis, CNWSCreature *pTarget, BOOL bOffHand) -> int32_t
+    {
+        return Memoize<int32_t>(pThis->m_pBaseCreature, pTarget, DamageBonus, !!bOffHand,
+            [&]() { return s_GetDamageBonusHook->CallOriginal<int32_t>(pThis, pTarget, bOffHand); });
+    }, Hooks::Order::Earliest);
+
+    // Damage effect bonuses are rolled, and the other bonus types aren't asked for once per attack.
+    static Hooks::Hook s_GetTotalEffectBonusHook = Hooks::HookFunction(&CNWSCreature::GetTotalEffectBonus,
+    +[](CNWSCreature *pThis, uint8_t nEffectBonusType, CNWSObject *pObject, BOOL bElementalDamage, BOOL bForceMax,
+        uint8_t nSaveType, uint8_t nSpecificType, uint8_t nSkill, uint8_t nAbilityScore, BOOL bOffHand) -> int32_t
+    {
+        auto compute = [&]()
+        {
+            return s_GetTotalEffectBonusHook->CallOriginal<int32_t>(pThis, nEffectBonusType, pObject, bElementalDamage,
+                bForceMax, nSaveType, nSpecificType, nSkill, nAbilityScore, bOffHand);
+        };
+
+        if (nEffectBonusType != Constants::EffectBonusType::Attack && nEffectBonusType != Constants::EffectBonusType::TouchAttack)
+            return compute();
+
+        return Memoize<int32_t>(pThis, pObject, TotalEffectBonus, nEffectBonusType | (bOffHand ? 0x80 : 0), compute);
+    }, Hooks::Order::Earliest);
+
+    // A new round starts with an empty memo.
+    static Hooks::Hook s_StartCombatRoundHook = Hooks::HookFunction(&CNWSCombatRound::StartCombatRound,
+    +[](CNWSCombatRound *pThis, ObjectID oidTarget) -> void
+    {
+        if (auto *pMemo = static_cast<MemoTable*>(POS::GetExtension(pThis->m_pBaseCreature, GetExtensionId())))
+            pMemo->m_entries.clear();
+        s_StartCombatRoundHook->CallOriginal<void>(pThis, oidTarget);
+    }, Hooks::Order::Earliest);
+
+    // Instant effects such as damage and healing don't change any modifier.
+    static Hooks::Hook s_ApplyEffectHook = Hooks::HookFunction(&CNWSObject::ApplyEffect,
+    +[](CNWSObject *pThis, CGameEffect *pEffect, BOOL bLoadingGame, BOOL bInitialApplication) -> void
+    {
+        const bool bInstant = pEffect->GetDurationType() == Constants::EffectDurationType::Instant;
+        s_ApplyEffectHook->CallOriginal<void>(pThis, pEffect, bLoadingGame, bInitialApplication);
+        if (!bInstant)
+            Invalidate(pThis);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RemoveEffectHook = Hooks::HookFunction(&CNWSObject::RemoveEffect,
+    +[](CNWSObject *pThis, CGameEffect *pEffect) -> void
+    {
+        s_RemoveEffectHook->CallOriginal<void>(pThis, pEffect);
+        Invalidate(pThis);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_EquipItemHook = Hooks::HookFunction(&CNWSCreature::EquipItem,
+    +[](CNWSCreature *pThis, uint32_t nInventorySlot, CNWSItem *pItem, BOOL bApplyPropertyEffects, BOOL bLoadingItem) -> BOOL
+    {
+        auto retVal = s_EquipItemHook->CallOriginal<BOOL>(pThis, nInventorySlot, pItem, bApplyPropertyEffects, bLoadingItem);
+        Invalidate(pThis);
+        return retVal;
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_UnequipItemHook = Hooks::HookFunction(&CNWSCreature::UnequipItem,
+    +[](CNWSCreature *pThis, CNWSItem *pItem, BOOL bUnequipWhilePolymorphed) -> BOOL
+    {
+        auto retVal = s_UnequipItemHook->CallOriginal<BOOL>(pThis, pItem, bUnequipWhilePolymorphed);
+        Invalidate(pThis);
+        return retVal;
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_AddFeatHook = Hooks::HookFunction(&CNWSCreatureStats::AddFeat,
+    +[](CNWSCreatureStats *pThis, uint16_t nFeat) -> void
+    {
+        s_AddFeatHook->CallOriginal<void>(pThis, nFeat);
+        Invalidate(pThis->m_pBaseCreature);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RemoveFeatHook = Hooks::HookFunction(&CNWSCreatureStats::RemoveFeat,
+    +[](CNWSCreatureStats *pThis, uint16_t nFeat) -> void
+    {
+        s_RemoveFeatHook->CallOriginal<void>(pThis, nFeat);
+        Invalidate(pThis->m_pBaseCreature);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_LevelUpHook = Hooks::HookFunction(&CNWSCreatureStats::LevelUp,
+    +[](CNWSCreatureStats *pThis, CNWLevelStats *pLevelUpStats, uint8_t nDomain1, uint8_t nDomain2, uint8_t nSchool, BOOL bAddStatsToList) -> void
+    {
+        s_LevelUpHook->CallOriginal<void>(pThis, pLevelUpStats, nDomain1, nDomain2, nSchool, bAddStatsToList);
+        Invalidate(pThis->m_pBaseCreature);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_LevelDownHook = Hooks::HookFunction(&CNWSCreatureStats::LevelDown,
+    +[](CNWSCreatureStats *pThis, CNWLevelStats *pLevelUpStats) -> void
+    {
+        s_LevelDownHook->CallOriginal<void>(pThis, pLevelUpStats);
+        Invalidate(pThis->m_pBaseCreature);
+    }, Hooks::Order::Earliest);
+
+#define HOOK_SET_ABILITY_BASE(_func) \
+    static Hooks::Hook CAT(s_##_func##Hook, __LINE__) = Hooks::HookFunction(&CNWSCreatureStats::_func, \
+    +[](CNWSCreatureStats *pThis, uint8_t nValue) -> void \
+    { \
+        CAT(s_##_func##Hook, __LINE__)->CallOriginal<void>(pThis, nValue); \
+        Invalidate(pThis->m_pBaseCreature); \
+    }, Hooks::Order::Earliest)
+
+    HOOK_SET_ABILITY_BASE(SetSTRBase);
+    HOOK_SET_ABILITY_BASE(SetDEXBase);
+    HOOK_SET_ABILITY_BASE(SetINTBase);
+    HOOK_SET_ABILITY_BASE(SetWISBase);
+    HOOK_SET_ABILITY_BASE(SetCHABase);
+
+#undef HOOK_SET_ABILITY_BASE
+
+    static Hooks::Hook s_SetCONBaseHook = Hooks::HookFunction(&CNWSCreatureStats::SetCONBase,
+    +[](CNWSCreatureStats *pThis, uint8_t nValue, BOOL bRecalculateHP) -> void
+    {
+        s_SetCONBaseHook->CallOriginal<void>(pThis, nValue, bRecalculateHP);
+        Invalidate(pThis->m_pBaseCreature);
+    }, Hooks::Order::Earliest);
+
+    // Whether the target sees the attacker decides flat footedness and invisibility bonuses.
+    // The visible list is refreshed constantly, so only actual changes count.
+    static Hooks::Hook s_AddToVisibleListHook = Hooks::HookFunction(&CNWSCreature::AddToVisibleList,
+    +[](CNWSCreature *pThis, ObjectID oidCreature, BOOL bSeen, BOOL bHeard, uint8_t nSanctuary, BOOL bInvisible) -> void
+    {
+        const auto nBefore = GetVisibility(pThis, oidCreature);
+        s_AddToVisibleListHook->CallOriginal<void>(pThis, oidCreature, bSeen, bHeard, nSanctuary, bInvisible);
+        if (GetVisibility(pThis, oidCreature) != nBefore)
+            InvalidatePair(pThis, oidCreature);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RemoveFromVisibleListHook = Hooks::HookFunction(&CNWSCreature::RemoveFromVisibleList,
+    +[](CNWSCreature *pThis, ObjectID oidCreature) -> void
+    {
+        const bool bVisible = GetVisibility(pThis, oidCreature);
+        s_RemoveFromVisibleListHook->CallOriginal<void>(pThis, oidCreature);
+        if (bVisible)
+            InvalidatePair(pThis, oidCreature);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_ClearVisibleListHook = Hooks::HookFunction(&CNWSCreature::ClearVisibleList,
+    +[](CNWSCreature *pThis) -> void
+    {
+        s_ClearVisibleListHook->CallOriginal<void>(pThis);
+        Invalidate(pThis);
+    }, Hooks::Order::Earliest);
+
+    // Broadcast by the Weapon, Race and Feat plugins when a script changes their modifiers.
+    MessageBus::Subscribe("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED",
+        [](const std::vector<std::string>&)
+        {
+            s_GlobalVersion++;
+            s_Stats.m_invalidations++;
+        });
+}
+
+}
@@ -7,6 +7,17 @@
 #include "API/CNWSCreature.hpp"
 #include "API/CNWSArea.hpp"
 #include "API/CNWSPlaceable.hpp"
+#include "API/CAppManager.hpp"
+#include "API/CServerExoApp.hpp"
+#include "API/CServerExoAppInternal.hpp"
+#include "API/CExoLinkedListInternal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace Optimizations {
 
@@ -18,6 +29,139 @@ static HashTable32<LuoTable> s_playerluo;
 
 static float s_UpdateDistances[Constants::ObjectType::MAX + 1];
 
+namespace {
+
+// What ShouldUpdateObject() needs to know about an area object, resolved once per area and tick.
+struct AreaObject
+{
+    ObjectID m_oid;
+    float m_x;
+    float m_y;
+    uint8_t m_nObjectType;
+    bool m_bSkip;
+    bool m_bStatic;
+};
+
+struct AreaSnapshot
+{
+    std::vector<AreaObject> m_objects;
+};
+
+// The area objects one player needs to consider this tick, as indices into the area's object list.
+struct PreparedUpdate
+{
+    CNWSPlayer *m_pPlayer;
+    LuoTable *m_pTable;
+    ObjectID m_oidArea;
+    Vector m_vPos;
+    const AreaSnapshot *m_pSnapshot;
+    std::vector<uint32_t> m_candidates;
+    uint64_t m_nCullTime;
+    bool m_bUsed;
+};
+
+struct UpdateStats
+{
+    uint64_t m_ticks = 0;
+    uint64_t m_prepared = 0;
+    uint64_t m_used = 0;
+    uint64_t m_cullWallTime = 0;
+    uint64_t m_cullCpuTime = 0;
+    uint64_t m_updateTime = 0;
+};
+
+class WorkerPool
+{
+public:
+    void Start(uint32_t nThreads)
+    {
+        for (uint32_t i = 0; i < nThreads; i++)
+            std::thread([this]() { WorkerLoop(); }).detach();
+    }
+
+    // Calls fn(0)..fn(count-1) across the workers and the calling thread, returns when all are done.
+    void Run(size_t count, const std::function<void(size_t)>& fn)
+    {
+        {
+            // Workers read the job without holding the lock, so only change it while none are inside Work().
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_finished.wait(lock, [&]() { return m_active == 0; });
+            m_pJob = &fn;
+            m_count = count;
+            m_next = 0;
+            m_done = 0;
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        Work();
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_finished.wait(lock, [&]() { return m_done == m_count && m_active == 0; });
+        m_pJob = nullptr;
+        m_count = 0;
+    }
+
+private:
+    void Work()
+    {
+        size_t nDone = 0;
+        for (size_t i = m_next++; i < m_count; i = m_next++)
+        {
+            (*m_pJob)(i);
+            nDone++;
+        }
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_done += nDone;
+    }
+
+    void WorkerLoop()
+    {
+        uint64_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_wake.wait(lock, [&]() { return m_generation != generation; });
+                generation = m_generation;
+                m_active++;
+            }
+
+            Work();
+
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_active--;
+            }
+            m_finished.notify_all();
+        }
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    const std::function<void(size_t)> *m_pJob = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next = 0;
+    size_t m_done = 0;
+    uint32_t m_active = 0;
+    uint64_t m_generation = 0;
+};
+
+}
+
+static uint32_t s_ParallelThreads;
+// Never destroyed, the workers wait on it until the process exits.
+static WorkerPool *s_pWorkerPool;
+static bool s_bInClientUpdate;
+static bool s_bPrepared;
+static std::unordered_map<ObjectID, AreaSnapshot> s_AreaSnapshots;
+// Keyed by player id.
+static std::unordered_map<PlayerID, PreparedUpdate> s_PreparedUpdates;
+static UpdateStats s_UpdateStats;
+static std::chrono::steady_clock::time_point s_LastMetricsReport;
+
 
 static Hooks::Hook s_GetLastUpdateObject;
 static Hooks::Hook s_CreateNewLastUpdateObject;
@@ -27,6 +171,7 @@ static Hooks::Hook s_DeleteLastUpdateObjectsInOtherAreas;
 static Hooks::Hook s_DestroyPlayer0;
 static Hooks::Hook s_DestroyPlayer1;
 static Hooks::Hook s_SendServerToPlayerGameObjUpdate;
+static Hooks::Hook s_UpdateClientGameObjects;
 static CLastUpdateObject* GetLastUpdateObject(CNWSPlayer*, ObjectID) __attribute__((hot));
 static CLastUpdateObject* CreateNewLastUpdateObject(CNWSMessage*, CNWSPlayer*, CNWSObject*, uint32_t*, uint32_t*);
 static void TestObjectUpdateDifferences(CNWSMessage*, CNWSPlayer*, CNWSObject*, CLastUpdateObject**, uint32_t*, uint32_t*);
@@ -36,6 +181,7 @@ static void DeleteLastUpdateObjectsInOtherAreas(CNWSMessage*, CNWSPlayer*);
 static void DestroyPlayer0(CNWSPlayer* pThis);
 static void DestroyPlayer1(CNWSPlayer* pThis);
 static BOOL SendServerToPlayerGameObjUpdate(CNWSMessage*, CNWSPlayer*, ObjectID);
+static void UpdateClientGameObjects(CServerExoAppInternal*, BOOL);
 
 
 void LuoLookup() __attribute__((constructor));
@@ -65,6 +211,15 @@ void LuoLookup()
 
             for (int32_t i = 0; i <= Constants::ObjectType::MAX; i++)
                 s_UpdateDistances[i] = dist * dist;
+
+            s_ParallelThreads = Config::Get<uint32_t>("PARALLEL_GAME_OBJECT_UPDATE_THREADS", 0);
+            if (s_ParallelThreads)
+            {
+                LOG_INFO("Selecting game object update candidates on %u threads", s_ParallelThreads);
+                s_pWorkerPool = new WorkerPool();
+                s_pWorkerPool->Start(s_ParallelThreads - 1);
+                s_UpdateClientGameObjects = Hooks::HookFunction(&CServerExoAppInternal::UpdateClientGameObjects, UpdateClientGameObjects, Hooks::Order::Early);
+            }
         }
     }
 }
@@ -213,6 +368,190 @@ static void DeleteLastUpdateObjectsInOtherAreas(CNWSMessage* pThis, CNWSPlayer *
     }
 }
 
+static void ReportUpdateMetrics()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - s_LastMetricsReport < std::chrono::seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Optimizations");
+    if (!pPlugin)
+        return;
+
+    pPlugin->GetServices()->m_metrics->Push(
+        "GameObjectUpdate",
+        {
+            { "ticks", std::to_string(s_UpdateStats.m_ticks) },
+            { "players_prepared", std::to_string(s_UpdateStats.m_prepared) },
+            { "players_used", std::to_string(s_UpdateStats.m_used) },
+            { "cull_wall_us", std::to_string(s_UpdateStats.m_cullWallTime / 1000) },
+            { "cull_cpu_us", std::to_string(s_UpdateStats.m_cullCpuTime / 1000) },
+            { "update_us", std::to_string(s_UpdateStats.m_updateTime / 1000) },
+        },
+        {
+            { "threads", std::to_string(s_ParallelThreads) },
+        });
+    s_UpdateStats = UpdateStats();
+}
+
+static bool GetUpdateOrigin(CNWSCreature *pPlayerObj, CNWSArea **ppArea, Vector *pPos)
+{
+    *ppArea = pPlayerObj->GetArea();
+    *pPos = pPlayerObj->m_vPosition;
+    if (!*ppArea)
+    {
+        *ppArea = Utils::AsNWSArea(Utils::GetGameObject(pPlayerObj->m_oidDesiredArea));
+        *pPos = pPlayerObj->m_vDesiredAreaLocation;
+    }
+    return *ppArea != nullptr;
+}
+
+static const AreaSnapshot* GetAreaSnapshot(CNWSArea *pArea)
+{
+    auto it = s_AreaSnapshots.find(pArea->m_idSelf);
+    if (it != s_AreaSnapshots.end())
+        return &it->second;
+
+    auto& snapshot = s_AreaSnapshots[pArea->m_idSelf];
+    snapshot.m_objects.resize(pArea->m_aGameObjects.num);
+    for (int32_t i = 0; i < pArea->m_aGameObjects.num; i++)
+    {
+        auto& object = snapshot.m_objects[i];
+        object.m_oid = pArea->m_aGameObjects[i];
+        auto *obj = Utils::AsNWSObject(Utils::GetGameObject(object.m_oid));
+        object.m_bSkip = obj == nullptr;
+        if (!obj)
+            continue;
+
+        auto *plc = Utils::AsNWSPlaceable(obj);
+        object.m_bStatic = plc && plc->m_bStaticObject;
+        object.m_x = obj->m_vPosition.x;
+        object.m_y = obj->m_vPosition.y;
+        object.m_nObjectType = obj->m_nObjectType;
+    }
+    return &snapshot;
+}
+
+// Runs on the worker threads. Only reads the snapshot and the player's own LUO table.
+static void SelectCandidates(PreparedUpdate& prepared)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto& objects = prepared.m_pSnapshot->m_objects;
+    for (uint32_t i = 0; i < objects.size(); i++)
+    {
+        const auto& object = objects[i];
+        if (object.m_bSkip)
+            continue;
+
+        bool bUpdate = prepared.m_pTable->Get(object.m_oid) != nullptr;
+        if (!bUpdate && !object.m_bStatic)
+        {
+            float x = object.m_x - prepared.m_vPos.x;
+            float y = object.m_y - prepared.m_vPos.y;
+            bUpdate = (x*x + y*y) <= s_UpdateDistances[object.m_nObjectType];
+        }
+
+        if (bUpdate)
+            prepared.m_candidates.push_back(i);
+    }
+
+    prepared.m_nCullTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Selects the candidates of all players at once, the first time an update is sent in a tick.
+// Everything the workers touch is resolved here on the main thread.
+static void PrepareUpdates()
+{
+    s_bPrepared = true;
+
+    auto *pPlayerList = Globals::AppManager()->m_pServerExoApp->m_pcExoAppInternal->m_pNWSPlayerList->m_pcExoLinkedListInternal;
+    std::vector<PreparedUpdate*> work;
+    for (auto *pNode = pPlayerList->pHead; pNode; pNode = pNode->pNext)
+    {
+        auto *pPlayer = static_cast<CNWSPlayer*>(static_cast<CNWSClient*>(pNode->pObject));
+        auto *pPlayerObj = Utils::AsNWSCreature(pPlayer->GetGameObject());
+        CNWSArea *pArea;
+        Vector vPos;
+        if (!pPlayerObj || !GetUpdateOrigin(pPlayerObj, &pArea, &vPos))
+            continue;
+
+        auto& prepared = s_PreparedUpdates[pPlayer->m_nPlayerID];
+        prepared.m_pPlayer = pPlayer;
+        prepared.m_pTable = &GetLuoTable(pPlayer);
+        prepared.m_oidArea = pArea->m_idSelf;
+        prepared.m_vPos = vPos;
+        prepared.m_pSnapshot = GetAreaSnapshot(pArea);
+        prepared.m_candidates.clear();
+        prepared.m_nCullTime = 0;
+        prepared.m_bUsed = false;
+        work.push_back(&prepared);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    s_pWorkerPool->Run(work.size(), [&](size_t i) { SelectCandidates(*work[i]); });
+    s_UpdateStats.m_cullWallTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto *pPrepared : work)
+        s_UpdateStats.m_cullCpuTime += pPrepared->m_nCullTime;
+    s_UpdateStats.m_prepared += work.size();
+}
+
+static PreparedUpdate* GetPreparedUpdate(CNWSPlayer *pPlayer, CNWSArea *pArea)
+{
+    if (!s_bInClientUpdate)
+        return nullptr;
+    if (!s_bPrepared)
+        PrepareUpdates();
+
+    auto it = s_PreparedUpdates.find(pPlayer->m_nPlayerID);
+    if (it == s_PreparedUpdates.end())
+        return nullptr;
+
+    auto& prepared = it->second;
+    if (prepared.m_bUsed || prepared.m_pPlayer != pPlayer || prepared.m_oidArea != pArea->m_idSelf ||
+        prepared.m_pSnapshot->m_objects.size() != (size_t)pArea->m_aGameObjects.num)
+    {
+        return nullptr;
+    }
+
+    prepared.m_bUsed = true;
+    s_UpdateStats.m_used++;
+    return &prepared;
+}
+
+static void UpdateClientGameObjects(CServerExoAppInternal *pThis, BOOL bForce)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    s_bInClientUpdate = true;
+    s_UpdateClientGameObjects->CallOriginal<void>(pThis, bForce);
+    s_bInClientUpdate = false;
+
+    if (s_bPrepared)
+    {
+        s_bPrepared = false;
+        s_AreaSnapshots.clear();
+        for (auto it = s_PreparedUpdates.begin(); it != s_PreparedUpdates.end();)
+        {
+            // Drop players that weren't around this tick, they may have left.
+            if (it->second.m_pSnapshot == nullptr)
+                it = s_PreparedUpdates.erase(it);
+            else
+            {
+                it->second.m_pSnapshot = nullptr;
+                ++it;
+            }
+        }
+
+        s_UpdateStats.m_ticks++;
+        s_UpdateStats.m_updateTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ReportUpdateMetrics();
+}
+
 static inline void UpdateSingleObject(CNWSMessage* msg, CNWSPlayer* player, CNWSObject* pPlayerObj, CNWSObject *obj)
 {
     if (msg->TestObjectVisible(obj, pPlayerObj))
@@ -244,18 +583,17 @@ static BOOL SendServerToPlayerGameObjUpdate(CNWSMessage* msg, CNWSPlayer *pPlaye
     DeleteLastUpdateObjectsInOtherAreas(msg, pPlayer);
     auto& tbl = GetLuoTable(pPlayer);
 
-    CNWSArea* area = pPlayerObj->GetArea();
-    Vector vPos = pPlayerObj->m_vPosition;
-    if (!area)
-    {
-        area = Utils::AsNWSArea(Utils::GetGameObject(pPlayerObj->m_oidDesiredArea));
-        vPos = pPlayerObj->m_vDesiredAreaLocation;
-    }
+    CNWSArea* area;
+    Vector vPos;
+    GetUpdateOrigin(pPlayerObj, &area, &vPos);
 
     const uint32_t specialStages = 40;
     const uint32_t objectCount = area ? area->m_aGameObjects.num : 0;
     const uint32_t totalStages = specialStages + objectCount;
 
+    auto* pPrepared = area ? GetPreparedUpdate(pPlayer, area) : nullptr;
+    uint32_t nextCandidate = 0;
+
     uint32_t stage = 0;
     while (msg->PeekAtWriteMessageSize() < msgLimit && stage != totalStages)
     {
@@ -290,6 +628,21 @@ static BOOL SendServerToPlayerGameObjUpdate(CNWSMessage* msg, CNWSPlayer *pPlaye
             }
             default:
             {
+                if (pPrepared)
+                {
+                    const auto& candidates = pPrepared->m_candidates;
+                    if (nextCandidate < candidates.size())
+                    {
+                        const auto index = candidates[nextCandidate++];
+                        if (auto* obj = Utils::AsNWSObject(Utils::GetGameObject(area->m_aGameObjects[index])))
+                            UpdateSingleObject(msg, pPlayer, pPlayerObj, obj);
+                        stage = specialStages + index + 1;
+                    }
+                    if (nextCandidate == candidates.size())
+                        stage = totalStages;
+                    break;
+                }
+
                 // ASSERT(area); // This really should not be possible.
                 auto ShouldUpdateObject = [&](CNWSObject* obj) -> bool
                 {
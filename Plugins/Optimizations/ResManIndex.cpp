@@ -0,0 +1,313 @@
+#include "nwnx.hpp"
+
+#include "API/CExoResMan.hpp"
+#include "API/CExoKeyTable.hpp"
+#include "API/CExoBase.hpp"
+#include "API/CExoAliasList.hpp"
+#include "API/CResRef.hpp"
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+namespace Optimizations {
+
+using namespace NWNXLib;
+using namespace NWNXLib::API;
+using namespace std::chrono;
+
+namespace {
+
+struct IndexKey
+{
+    uint64_t m_resRef[2];
+    RESTYPE m_nType;
+
+    bool operator==(const IndexKey& other) const
+    {
+        return m_resRef[0] == other.m_resRef[0] && m_resRef[1] == other.m_resRef[1] && m_nType == other.m_nType;
+    }
+};
+
+struct IndexKeyHash
+{
+    size_t operator()(const IndexKey& key) const
+    {
+        uint64_t h = key.m_resRef[0] * 0x9E3779B97F4A7C15ull;
+        h ^= (key.m_resRef[1] + key.m_nType) * 0xC2B2AE3D27D4EB4Full;
+        return h ^ (h >> 29);
+    }
+};
+
+// A null table means the resource doesn't exist.
+struct IndexEntry
+{
+    CExoKeyTable *m_pTable;
+    CKeyTableEntry *m_pKey;
+};
+
+struct WatchedDirectory
+{
+    std::string m_name;
+    std::string m_path;
+    int64_t m_mtime;
+};
+
+struct Stats
+{
+    uint64_t m_hits = 0;
+    uint64_t m_negativeHits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_flushes = 0;
+};
+
+}
+
+// Results of CExoResMan::GetKeyEntry(). Key table entries live in arrays owned by
+// their table, so every change to any table drops the whole index.
+static std::unordered_map<IndexKey, IndexEntry, IndexKeyHash> s_Index;
+static size_t s_MaxEntries;
+// Resource directories added with change detection; files appearing in them don't go through ResMan.
+static std::vector<WatchedDirectory> s_WatchedDirectories;
+static Stats s_Stats;
+static steady_clock::time_point s_LastWatchCheck;
+static steady_clock::time_point s_LastMetricsReport;
+
+static IndexKey MakeKey(const CResRef& cResRef, RESTYPE nType)
+{
+    char resRef[16];
+    for (int i = 0; i < 16; i++)
+        resRef[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(cResRef.m_resRef[i])));
+
+    IndexKey key;
+    std::memcpy(key.m_resRef, resRef, sizeof(resRef));
+    key.m_nType = nType;
+    return key;
+}
+
+static int64_t GetMTime(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return -1;
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+static void FlushIndex()
+{
+    if (s_Index.empty())
+        return;
+
+    s_Stats.m_flushes++;
+    s_Index.clear();
+}
+
+static void WatchDirectory(const CExoString& sName)
+{
+    std::string name = sName.CStr();
+    std::string path = name;
+    if (!name.empty() && name.back() == ':')
+        path = Globals::ExoBase()->m_pcExoAliasList->GetAliasPath(name.substr(0, name.size() - 1)).CStr();
+    if (path.empty())
+        return;
+
+    s_WatchedDirectories.push_back({name, path, GetMTime(path)});
+}
+
+// Once a second, drop the index if a file was added to or removed from a watched directory.
+// The next lookup goes through ResMan, which picks the change up as usual.
+static void CheckWatchedDirectories()
+{
+    if (s_WatchedDirectories.empty())
+        return;
+
+    const auto now = steady_clock::now();
+    if (now - s_LastWatchCheck < seconds(1))
+        return;
+    s_LastWatchCheck = now;
+
+    for (auto& directory : s_WatchedDirectories)
+    {
+        const auto mtime = GetMTime(directory.m_path);
+        if (mtime != directory.m_mtime)
+        {
+            LOG_DEBUG("Resource directory '%s' changed on disk.", directory.m_name);
+            directory.m_mtime = mtime;
+            FlushIndex();
+        }
+    }
+}
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_LastMetricsReport < seconds(1))
+        return;
+    s_LastMetricsReport = now;
+
+    static auto *pPlugin = Plugin::Find("NWNX_Optimizations");
+    if (!pPlugin)
+        return;
+
+    pPlugin->GetServices()->m_metrics->Push(
+        "ResManIndex",
+        {
+            { "hits", std::to_string(s_Stats.m_hits) },
+            { "negative_hits", std::to_string(s_Stats.m_negativeHits) },
+            { "misses", std::to_string(s_Stats.m_misses) },
+            { "flushes", std::to_string(s_Stats.m_flushes) },
+            { "entries", std::to_string(s_Index.size()) },
+        });
+    s_Stats = Stats();
+}
+
+void ResManIndex() __attribute__((constructor));
+void ResManIndex()
+{
+    if (!Config::Get<bool>("RESMAN_INDEX", false))
+        return;
+
+    s_MaxEntries = Config::Get<uint32_t>("RESMAN_INDEX_MAX_ENTRIES", 262144);
+
+    LOG_INFO("Indexing resource lookups, up to %d entries.", s_MaxEntries);
+
+    static Hooks::Hook s_GetKeyEntry = Hooks::HookFunction(&CExoResMan::GetKeyEntry,
+    +[](CExoResMan *pThis, const CResRef& cResRef, RESTYPE nType, CExoKeyTable **pNewTable, CKeyTableEntry **pNewKey, bool bLogFailure) -> BOOL
+    {
+        CheckWatchedDirectories();
+        ReportMetrics();
+
+        const auto key = MakeKey(cResRef, nType);
+        auto it = s_Index.find(key);
+        if (it != s_Index.end())
+        {
+            const auto& entry = it->second;
+            if (entry.m_pTable)
+            {
+                s_Stats.m_hits++;
+                if (pNewTable)
+                    *pNewTable = entry.m_pTable;
+                if (pNewKey)
+                    *pNewKey = entry.m_pKey;
+                return true;
+            }
+
+            // Let ResMan write its failure log if that's turned on.
+            if (!(bLogFailure && pThis->m_bLogLookupFailures))
+            {
+                s_Stats.m_negativeHits++;
+                if (bLogFailure)
+                {
+                    pThis->m_nTotalLookupFailures++;
+                    pThis->m_cLastFailedLookup = cResRef;
+                    pThis->m_nLastFailedLookupType = nType;
+                }
+                if (pNewTable)
+                    *pNewTable = nullptr;
+                if (pNewKey)
+                    *pNewKey = nullptr;
+                return false;
+            }
+        }
+
+        s_Stats.m_misses++;
+
+        CExoKeyTable *pTable = nullptr;
+        CKeyTableEntry *pKey = nullptr;
+        const BOOL bFound = s_GetKeyEntry->CallOriginal<BOOL>(pThis, cResRef, nType, &pTable, &pKey, bLogFailure);
+
+        if (s_Index.size() >= s_MaxEntries)
+            FlushIndex();
+        s_Index[key] = bFound ? IndexEntry{pTable, pKey} : IndexEntry{nullptr, nullptr};
+
+        if (pNewTable)
+            *pNewTable = pTable;
+        if (pNewKey)
+            *pNewKey = pKey;
+        return bFound;
+    }, Hooks::Order::Late);
+
+    // Changes to the set of key tables, or to the priority they are searched in.
+    static Hooks::Hook s_AddKeyTable = Hooks::HookFunction(&CExoResMan::AddKeyTable,
+    +[](CExoResMan *pThis, uint32_t nPriority, const CExoString& sName, uint32_t nTableType, BOOL bDetectChanges) -> BOOL
+    {
+        auto retVal = s_AddKeyTable->CallOriginal<BOOL>(pThis, nPriority, sName, nTableType, bDetectChanges);
+        FlushIndex();
+        if (retVal && bDetectChanges)
+            WatchDirectory(sName);
+        return retVal;
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RemoveKeyTable = Hooks::HookFunction(&CExoResMan::RemoveKeyTable,
+    +[](CExoResMan *pThis, const CExoString& sName, uint32_t nTableType, BOOL bEmitWarningOnFailure) -> BOOL
+    {
+        FlushIndex();
+        s_WatchedDirectories.erase(std::remove_if(s_WatchedDirectories.begin(), s_WatchedDirectories.end(),
+            [&](const WatchedDirectory& directory) { return directory.m_name == sName.CStr(); }), s_WatchedDirectories.end());
+        return s_RemoveKeyTable->CallOriginal<BOOL>(pThis, sName, nTableType, bEmitWarningOnFailure);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_UpdateKeyTable = Hooks::HookFunction(&CExoResMan::UpdateKeyTable,
+    +[](CExoResMan *pThis, const CExoString& sName, uint32_t nTableType) -> BOOL
+    {
+        FlushIndex();
+        auto retVal = s_UpdateKeyTable->CallOriginal<BOOL>(pThis, sName, nTableType);
+        FlushIndex();
+        return retVal;
+    }, Hooks::Order::Earliest);
+
+    // Changes to the contents of a single table, including the ones ResMan makes on its own.
+    static Hooks::Hook s_AddKey = Hooks::HookFunction(&CExoKeyTable::AddKey,
+    +[](CExoKeyTable *pThis, const CResRef& cNewResRef, RESTYPE nType, RESID nNewResID, BOOL bPopulateEntry) -> CKeyTableEntry*
+    {
+        FlushIndex();
+        return s_AddKey->CallOriginal<CKeyTableEntry*>(pThis, cNewResRef, nType, nNewResID, bPopulateEntry);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RebuildTable = Hooks::HookFunction(&CExoKeyTable::RebuildTable,
+    +[](CExoKeyTable *pThis) -> void
+    {
+        FlushIndex();
+        s_RebuildTable->CallOriginal<void>(pThis);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_DestroyTable = Hooks::HookFunction(&CExoKeyTable::DestroyTable,
+    +[](CExoKeyTable *pThis) -> void
+    {
+        FlushIndex();
+        s_DestroyTable->CallOriginal<void>(pThis);
+    }, Hooks::Order::Earliest);
+
+    // GetKeyEntry() resolves resref overrides.
+    static Hooks::Hook s_AddOverride = Hooks::HookFunction(&CExoResMan::AddOverride,
+    +[](CExoResMan *pThis, const CResRef& oldName, const CResRef& newName, RESTYPE nType) -> void
+    {
+        FlushIndex();
+        s_AddOverride->CallOriginal<void>(pThis, oldName, newName, nType);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_RemoveOverride = Hooks::HookFunction(&CExoResMan::RemoveOverride,
+    +[](CExoResMan *pThis, const CResRef& name, RESTYPE nType) -> void
+    {
+        FlushIndex();
+        s_RemoveOverride->CallOriginal<void>(pThis, name, nType);
+    }, Hooks::Order::Earliest);
+
+    static Hooks::Hook s_ClearOverrides = Hooks::HookFunction(&CExoResMan::ClearOverrides,
+    +[](CExoResMan *pThis) -> void
+    {
+        FlushIndex();
+        s_ClearOverrides->CallOriginal<void>(pThis);
+    }, Hooks::Order::Earliest);
+}
+
+// No nwscript export, call it manually.
+extern "C" ArgumentStack FlushResManIndex(ArgumentStack&&)
+{
+    FlushIndex();
+    return {};
+}
+
+}
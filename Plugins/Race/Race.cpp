@@ -154,262 +154,295 @@ Race::~Race()
 {
 }
 
-void Race::DoEffect(CNWSCreature *pCreature,
-                    uint16_t nType,
-                    int32_t param0,
-                    int32_t param1,
-                    int32_t param2,
-                    int32_t param3,
-                    int32_t param4,
-                    int32_t param5)
+void Race::DoEffect(CNWSCreature *pCreature, const EffectTemplate& effect)
 {
     auto *eff = new CGameEffect(true);
     eff->m_oidCreator         = MODULE_OID;
-    eff->m_nType              = nType;
+    eff->m_nType              = effect.m_nType;
     eff->m_nSubType           = EffectSubType::Supernatural | EffectDurationType::Innate;
     eff->m_bShowIcon          = g_plugin->m_ShowEffectIcon;
-    eff->m_nParamInteger[0]   = param0;
-    eff->m_nParamInteger[1]   = param1;
-    eff->m_nParamInteger[2]   = param2;
-    eff->m_nParamInteger[3]   = param3;
-    eff->m_nParamInteger[4]   = param4;
-    eff->m_nParamInteger[5]   = param5;
+    for (int i = 0; i < 6; i++)
+        eff->m_nParamInteger[i] = effect.m_nParams[i];
     eff->m_sCustomTag         = "NWNX_Race_RacialMod";
     pCreature->ApplyEffect(eff, true, true);
 }
 
-void Race::ApplyRaceEffects(CNWSCreature *pCreature)
+int32_t Race::RaceEffectBundle::GetSpellResistance(int32_t nLevel) const
 {
-    auto effectsLevelAdded = *pCreature->nwnxGet<int>("RACEMODS_ADDED_LEVEL");
+    auto mod_SRPerLevelCalc = 0;
+    if (m_nSRLevel > 0)
+        mod_SRPerLevelCalc = int32_t(std::floor(((nLevel - m_nSRStart + 1) / m_nSRLevel) * m_nSRInc));
+    int32_t mod_SR = m_nSRCharGen + (mod_SRPerLevelCalc > 0 ? mod_SRPerLevelCalc : 0);
+    return (mod_SR > m_nSRMax && m_nSRMax > 0) ? m_nSRMax : mod_SR;
+}
 
-    if (pCreature->m_pStats == nullptr || pCreature->m_pStats->GetLevel(true) == effectsLevelAdded)
-        return;
+const Race::RaceEffectBundle& Race::GetRaceEffectBundle(uint16_t nRace)
+{
+    auto& bundles = g_plugin->m_RaceEffectBundles;
+    if (nRace >= bundles.size())
+        bundles.resize(nRace + 1);
 
-    auto nLevel = pCreature->m_pStats->GetLevel(true);
-    auto nRace = pCreature->m_pStats->m_nRace;
+    auto& bundle = bundles[nRace];
+    if (bundle.m_bBuilt)
+        return bundle;
+
+    bundle = RaceEffectBundle();
+    bundle.m_bBuilt = true;
+    bundle.m_nVersion = ++g_plugin->m_nRaceEffectBundleVersion;
 
-    // Remove any existing racial effects, this is done when the player levels up and we reapply
-    // the racial modifiers.
-    if (effectsLevelAdded)
+    auto Find = [nRace](auto& map) -> decltype(&map.begin()->second)
     {
-        std::vector<uint64_t> remove(128);
-        for (int i = 0; i < pCreature->m_appliedEffects.num; i++)
-        {
-            auto eff = (CGameEffect*)pCreature->m_appliedEffects.element[i];
-            if (eff->m_sCustomTag == "NWNX_Race_RacialMod")
-            {
-                remove.push_back(eff->m_nID);
-            }
-        }
-        for (auto id: remove)
-            pCreature->RemoveEffectById(id);
-    }
+        auto it = map.find(nRace);
+        return it == map.end() ? nullptr : &it->second;
+    };
+    auto Add = [&bundle](uint16_t nType, int32_t param0 = 0, int32_t param1 = 0, int32_t param2 = 0,
+                         int32_t param3 = 0, int32_t param4 = 0, int32_t param5 = 0)
+    {
+        bundle.m_Effects.push_back({nType, {param0, param1, param2, param3, param4, param5}});
+    };
 
     // AB
-    auto modAB = g_plugin->m_RaceAB[nRace];
-    if (modAB != 0)
-    {
-        g_plugin->DoEffect(pCreature,
-                           modAB > 0 ? EffectTrueType::AttackIncrease : EffectTrueType::AttackDecrease,
-                           abs(modAB), 0, RacialType::Invalid);
-    }
+    if (auto *pAB = Find(g_plugin->m_RaceAB); pAB && *pAB != 0)
+        Add(*pAB > 0 ? EffectTrueType::AttackIncrease : EffectTrueType::AttackDecrease, abs(*pAB), 0, RacialType::Invalid);
 
     // ABVSRACE
-    for (auto &ABVsRaceMod : g_plugin->m_RaceABVsRace[nRace])
+    if (auto *pABVsRace = Find(g_plugin->m_RaceABVsRace))
     {
-        auto vsRace = ABVsRaceMod.first;
-        auto modVsRace = ABVsRaceMod.second;
-        if (modVsRace != 0)
+        for (auto &ABVsRaceMod : *pABVsRace)
         {
-            g_plugin->DoEffect(pCreature,
-                               modVsRace > 0 ? EffectTrueType::AttackIncrease : EffectTrueType::AttackDecrease,
-                               abs(modVsRace), 0, vsRace);
+            auto vsRace = ABVsRaceMod.first;
+            auto modVsRace = ABVsRaceMod.second;
+            if (modVsRace != 0)
+                Add(modVsRace > 0 ? EffectTrueType::AttackIncrease : EffectTrueType::AttackDecrease, abs(modVsRace), 0, vsRace);
         }
     }
 
     // AC
-    auto modAC = g_plugin->m_RaceAC[nRace].first;
-    auto typeAC = g_plugin->m_RaceAC[nRace].second;
-    if (modAC != 0)
-    {
-        g_plugin->DoEffect(pCreature,
-                           modAC > 0 ? EffectTrueType::ACIncrease : EffectTrueType::ACDecrease,
-                           typeAC, abs(modAC), RacialType::Invalid, 0, 0, 4103);
-    }
+    if (auto *pAC = Find(g_plugin->m_RaceAC); pAC && pAC->first != 0)
+        Add(pAC->first > 0 ? EffectTrueType::ACIncrease : EffectTrueType::ACDecrease, pAC->second, abs(pAC->first), RacialType::Invalid, 0, 0, 4103);
 
     // ACVSRACE
-    for (auto &ACVsRaceMod : g_plugin->m_RaceACVsRace[nRace])
+    if (auto *pACVsRace = Find(g_plugin->m_RaceACVsRace))
     {
-        auto vsRace = ACVsRaceMod.first;
-        auto modVsRace = ACVsRaceMod.second;
-        if (modVsRace != 0)
+        for (auto &ACVsRaceMod : *pACVsRace)
         {
-            g_plugin->DoEffect(pCreature,
-                               modVsRace > 0 ? EffectTrueType::ACIncrease : EffectTrueType::ACDecrease,
-                               ACBonus::Dodge, abs(modVsRace), vsRace, 0, 0, 4103);
+            auto vsRace = ACVsRaceMod.first;
+            auto modVsRace = ACVsRaceMod.second;
+            if (modVsRace != 0)
+                Add(modVsRace > 0 ? EffectTrueType::ACIncrease : EffectTrueType::ACDecrease, ACBonus::Dodge, abs(modVsRace), vsRace, 0, 0, 4103);
         }
     }
 
     // CONCEALMENT
-    auto modConceal = g_plugin->m_RaceConcealment[nRace];
-    if (modConceal != 0)
-    {
-        g_plugin->DoEffect(pCreature, EffectTrueType::Concealment, modConceal, RacialType::Invalid);
-    }
+    if (auto *pConceal = Find(g_plugin->m_RaceConcealment); pConceal && *pConceal != 0)
+        Add(EffectTrueType::Concealment, *pConceal, RacialType::Invalid);
 
     // DMGIMMUNITY
-    for (auto &dmgImmunityMod : g_plugin->m_RaceDmgImmunity[nRace])
+    if (auto *pDmgImmunity = Find(g_plugin->m_RaceDmgImmunity))
     {
-        auto modDmgImmunityType = dmgImmunityMod.first;
-        auto modDmgImmunityValue = dmgImmunityMod.second;
-        if (modDmgImmunityValue != 0)
+        for (auto &dmgImmunityMod : *pDmgImmunity)
         {
-            g_plugin->DoEffect(pCreature, modDmgImmunityValue > 0 ? EffectTrueType::DamageImmunityIncrease
-                                                                  : EffectTrueType::DamageImmunityDecrease,
-                               modDmgImmunityType, abs(modDmgImmunityValue));
+            auto modDmgImmunityType = dmgImmunityMod.first;
+            auto modDmgImmunityValue = dmgImmunityMod.second;
+            if (modDmgImmunityValue != 0)
+                Add(modDmgImmunityValue > 0 ? EffectTrueType::DamageImmunityIncrease : EffectTrueType::DamageImmunityDecrease,
+                    modDmgImmunityType, abs(modDmgImmunityValue));
         }
     }
 
     // DMGREDUCTION
-    for (auto &dmgResistMod : g_plugin->m_RaceDmgReduction[nRace])
+    if (auto *pDmgReduction = Find(g_plugin->m_RaceDmgReduction))
     {
-        auto modDmgReductionType = dmgResistMod.first;
-        auto modDmgReductionValue = dmgResistMod.second;
-        if (modDmgReductionValue != 0)
+        for (auto &dmgReductionMod : *pDmgReduction)
         {
-            g_plugin->DoEffect(pCreature, EffectTrueType::DamageReduction, modDmgReductionType, modDmgReductionValue);
+            if (dmgReductionMod.second != 0)
+                Add(EffectTrueType::DamageReduction, dmgReductionMod.first, dmgReductionMod.second);
         }
     }
 
     // DMGRESIST
-    for (auto &dmgResistMod : g_plugin->m_RaceDmgResist[nRace])
+    if (auto *pDmgResist = Find(g_plugin->m_RaceDmgResist))
     {
-        auto modDmgResistType = dmgResistMod.first;
-        auto modDmgResistValue = dmgResistMod.second;
-        if (modDmgResistValue != 0)
+        for (auto &dmgResistMod : *pDmgResist)
         {
-            g_plugin->DoEffect(pCreature, EffectTrueType::DamageResistance, modDmgResistType, modDmgResistValue);
+            if (dmgResistMod.second != 0)
+                Add(EffectTrueType::DamageResistance, dmgResistMod.first, dmgResistMod.second);
         }
     }
 
     // FEAT
-    for (auto &featDetails : g_plugin->m_RaceFeat[nRace])
+    if (auto *pFeats = Find(g_plugin->m_RaceFeat))
     {
-        auto featId = featDetails.first;
-        auto featLevel = featDetails.second;
-        if (featLevel <= nLevel && !pCreature->m_pStats->HasFeat(featId))
-        {
-            auto *pLevelStats = pCreature->m_pStats->m_lstLevelStats.element[featLevel-1];
-            pLevelStats->AddFeat(featId);
-            pCreature->m_pStats->AddFeat(featId);
-        }
+        for (auto &featDetails : *pFeats)
+            bundle.m_Feats.emplace_back(featDetails.first, featDetails.second);
     }
 
     // FEATUSAGE
-    for (auto &raceFeatUsage : g_plugin->m_RaceFeatUsage[nRace])
+    if (auto *pFeatUsages = Find(g_plugin->m_RaceFeatUsage))
     {
-        auto featId = raceFeatUsage.first;
-        auto fuChargen = raceFeatUsage.second.first;
-        auto fuLevel = raceFeatUsage.second.second;
-        auto levelMod = std::floor(pCreature->m_pStats->GetLevel(true) / fuLevel);
-        auto totalMod = int32_t(fuChargen + levelMod);
-        auto featRemainingUses = pCreature->m_pStats->GetFeatRemainingUses(featId);
-        if (totalMod < featRemainingUses)
-            pCreature->m_pStats->SetFeatRemainingUses(featId, totalMod);
+        for (auto &raceFeatUsage : *pFeatUsages)
+            bundle.m_FeatUsages.emplace_back(raceFeatUsage.first, raceFeatUsage.second.first, raceFeatUsage.second.second);
     }
 
     // IMMUNITY
-    for (auto &immunity : g_plugin->m_RaceImmunities[pCreature->m_pStats->m_nRace])
+    if (auto *pImmunities = Find(g_plugin->m_RaceImmunities))
     {
-        g_plugin->DoEffect(pCreature, EffectTrueType::Immunity, immunity, RacialType::Invalid);
+        for (auto &immunity : *pImmunities)
+            Add(EffectTrueType::Immunity, immunity, RacialType::Invalid);
     }
 
     // MOVEMENTSPEED
-    auto modSpeed = g_plugin->m_RaceMovementSpeed[nRace];
-    if (modSpeed != 0)
-    {
-        g_plugin->DoEffect(pCreature, EffectTrueType::MovementSpeedIncrease, modSpeed);
-    }
+    if (auto *pSpeed = Find(g_plugin->m_RaceMovementSpeed); pSpeed && *pSpeed != 0)
+        Add(EffectTrueType::MovementSpeedIncrease, *pSpeed);
 
     // REGENERATION
-    auto modRegenAmount = g_plugin->m_RaceRegeneration[nRace].first;
-    auto modRegenInterval = g_plugin->m_RaceRegeneration[nRace].second;
-    if (modRegenAmount != 0)
-    {
-        g_plugin->DoEffect(pCreature, EffectTrueType::Regenerate, modRegenAmount,
-                           modRegenInterval > 0 ? modRegenInterval * 1000 : 6000);
-    }
+    if (auto *pRegen = Find(g_plugin->m_RaceRegeneration); pRegen && pRegen->first != 0)
+        Add(EffectTrueType::Regenerate, pRegen->first, pRegen->second > 0 ? pRegen->second * 1000 : 6000);
 
     // SAVE
-    for (auto &saveMod : g_plugin->m_RaceSave[nRace])
+    if (auto *pSave = Find(g_plugin->m_RaceSave))
     {
-        auto saveType = saveMod.first;
-        auto mod = saveMod.second;
-        if (mod != 0)
+        for (auto &saveMod : *pSave)
         {
-            g_plugin->DoEffect(pCreature,
-                               mod > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
-                               abs(mod), saveType, SavingThrowType::All, RacialType::Invalid);
+            auto saveType = saveMod.first;
+            auto mod = saveMod.second;
+            if (mod != 0)
+                Add(mod > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
+                    abs(mod), saveType, SavingThrowType::All, RacialType::Invalid);
         }
     }
 
     // SAVEVSRACE
-    for (auto &saveMod : g_plugin->m_RaceSaveVsRace[nRace])
+    if (auto *pSaveVsRace = Find(g_plugin->m_RaceSaveVsRace))
     {
-        auto saveType = saveMod.first;
-        for (auto &saveVsRaceMod : g_plugin->m_RaceSaveVsRace[nRace][saveType])
+        for (auto &saveMod : *pSaveVsRace)
         {
-            auto saveVsRace = saveVsRaceMod.first;
-            auto modVsRace = saveVsRaceMod.second;
-            if (modVsRace != 0)
+            auto saveType = saveMod.first;
+            for (auto &saveVsRaceMod : saveMod.second)
             {
-                g_plugin->DoEffect(pCreature,
-                                   modVsRace > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
-                                   abs(modVsRace), saveType, SavingThrowType::All, saveVsRace);
+                auto saveVsRace = saveVsRaceMod.first;
+                auto modVsRace = saveVsRaceMod.second;
+                if (modVsRace != 0)
+                    Add(modVsRace > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
+                        abs(modVsRace), saveType, SavingThrowType::All, saveVsRace);
             }
         }
     }
 
     // SAVEVSTYPE
-    for (auto &saveMod : g_plugin->m_RaceSaveVsType[nRace])
+    if (auto *pSaveVsType = Find(g_plugin->m_RaceSaveVsType))
     {
-        auto saveType = saveMod.first;
-        for (auto &saveVsTypeMod : g_plugin->m_RaceSaveVsType[nRace][saveType])
+        for (auto &saveMod : *pSaveVsType)
         {
-            auto saveVsType = saveVsTypeMod.first;
-            auto modVsType = saveVsTypeMod.second;
-            if (modVsType != 0)
+            auto saveType = saveMod.first;
+            for (auto &saveVsTypeMod : saveMod.second)
             {
-                g_plugin->DoEffect(pCreature,
-                                   modVsType > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
-                                   abs(modVsType), saveType, saveVsType, RacialType::Invalid);
+                auto saveVsType = saveVsTypeMod.first;
+                auto modVsType = saveVsTypeMod.second;
+                if (modVsType != 0)
+                    Add(modVsType > 0 ? EffectTrueType::SavingThrowIncrease : EffectTrueType::SavingThrowDecrease,
+                        abs(modVsType), saveType, saveVsType, RacialType::Invalid);
             }
         }
     }
 
     // SPELLIMMUNITY
-    for (auto &spellImmunity : g_plugin->m_RaceSpellImmunities[pCreature->m_pStats->m_nRace])
+    if (auto *pSpellImmunities = Find(g_plugin->m_RaceSpellImmunities))
     {
-        g_plugin->DoEffect(pCreature, EffectTrueType::SpellImmunity, spellImmunity);
+        for (auto &spellImmunity : *pSpellImmunities)
+            Add(EffectTrueType::SpellImmunity, spellImmunity);
     }
 
     // SR
-    auto mod_SRCharGen = g_plugin->m_RaceSRCharGen[nRace].first;
-    auto mod_SRMax = g_plugin->m_RaceSRCharGen[nRace].second;
-    auto mod_SRInc = std::get<0>(g_plugin->m_RaceSR[nRace]);
-    auto mod_SRLevel = std::get<1>(g_plugin->m_RaceSR[nRace]);
-    auto mod_SRStart = std::get<2>(g_plugin->m_RaceSR[nRace]);
-    auto mod_SRPerLevelCalc = 0;
-    if (mod_SRLevel > 0)
-        mod_SRPerLevelCalc = int32_t(std::floor(((nLevel - mod_SRStart + 1) / mod_SRLevel) * mod_SRInc));
-    int32_t mod_SR = mod_SRCharGen + (mod_SRPerLevelCalc > 0 ? mod_SRPerLevelCalc : 0);
-    mod_SR = (mod_SR > mod_SRMax && mod_SRMax > 0) ? mod_SRMax : mod_SR;
-    if (mod_SR != 0)
+    if (auto *pSRCharGen = Find(g_plugin->m_RaceSRCharGen))
+    {
+        bundle.m_nSRCharGen = pSRCharGen->first;
+        bundle.m_nSRMax = pSRCharGen->second;
+    }
+    if (auto *pSR = Find(g_plugin->m_RaceSR))
     {
-        g_plugin->DoEffect(pCreature, EffectTrueType::SpellResistanceIncrease, mod_SR);
+        bundle.m_nSRInc = std::get<0>(*pSR);
+        bundle.m_nSRLevel = std::get<1>(*pSR);
+        bundle.m_nSRStart = std::get<2>(*pSR);
+    }
+
+    return bundle;
+}
+
+void Race::ApplyRaceEffects(CNWSCreature *pCreature)
+{
+    auto effectsLevelAdded = pCreature->nwnxGet<int>("RACEMODS_ADDED_LEVEL").value_or(0);
+
+    if (pCreature->m_pStats == nullptr || pCreature->m_pStats->GetLevel(true) == effectsLevelAdded)
+        return;
+
+    auto nLevel = pCreature->m_pStats->GetLevel(true);
+    auto& bundle = GetRaceEffectBundle(pCreature->m_pStats->m_nRace);
+    auto mod_SR = bundle.GetSpellResistance(nLevel);
+
+    // On level up only the level based effects change, unless the creature's race or its modifiers have
+    // changed since the racial effects were applied.
+    bool bReapplyAll = !effectsLevelAdded ||
+                       pCreature->nwnxGet<int>("RACEMODS_ADDED_VERSION").value_or(0) != static_cast<int>(bundle.m_nVersion);
+    auto appliedSR = bReapplyAll ? 0 : pCreature->nwnxGet<int>("RACEMODS_ADDED_SR").value_or(0);
+
+    if (effectsLevelAdded && (bReapplyAll || appliedSR != mod_SR))
+    {
+        std::vector<uint64_t> remove;
+        for (int i = 0; i < pCreature->m_appliedEffects.num; i++)
+        {
+            auto eff = (CGameEffect*)pCreature->m_appliedEffects.element[i];
+            if (eff->m_sCustomTag == "NWNX_Race_RacialMod" &&
+                (bReapplyAll || eff->m_nType == EffectTrueType::SpellResistanceIncrease))
+            {
+                remove.push_back(eff->m_nID);
+            }
+        }
+        for (auto id: remove)
+            pCreature->RemoveEffectById(id);
+    }
+
+    if (bReapplyAll)
+    {
+        for (auto &effect : bundle.m_Effects)
+            g_plugin->DoEffect(pCreature, effect);
+    }
+
+    // FEAT
+    for (auto &featDetails : bundle.m_Feats)
+    {
+        auto featId = featDetails.first;
+        auto featLevel = featDetails.second;
+        if (featLevel <= nLevel && !pCreature->m_pStats->HasFeat(featId))
+        {
+            auto *pLevelStats = pCreature->m_pStats->m_lstLevelStats.element[featLevel-1];
+            pLevelStats->AddFeat(featId);
+            pCreature->m_pStats->AddFeat(featId);
+        }
+    }
+
+    // FEATUSAGE
+    for (auto &raceFeatUsage : bundle.m_FeatUsages)
+    {
+        auto featId = std::get<0>(raceFeatUsage);
+        auto fuChargen = std::get<1>(raceFeatUsage);
+        auto fuLevel = std::get<2>(raceFeatUsage);
+        auto levelMod = std::floor(nLevel / fuLevel);
+        auto totalMod = int32_t(fuChargen + levelMod);
+        auto featRemainingUses = pCreature->m_pStats->GetFeatRemainingUses(featId);
+        if (totalMod < featRemainingUses)
+            pCreature->m_pStats->SetFeatRemainingUses(featId, totalMod);
+    }
+
+    // SR
+    if (mod_SR != 0 && (bReapplyAll || appliedSR != mod_SR))
+    {
+        g_plugin->DoEffect(pCreature, {EffectTrueType::SpellResistanceIncrease, {mod_SR, 0, 0, 0, 0, 0}});
     }
 
     pCreature->nwnxSet("RACEMODS_ADDED_LEVEL", nLevel);
+    pCreature->nwnxSet("RACEMODS_ADDED_VERSION", static_cast<int>(bundle.m_nVersion));
+    pCreature->nwnxSet("RACEMODS_ADDED_SR", mod_SR);
 }
 
 int32_t Race::LoadCharacterFinishHook(CServerExoAppInternal *pServerExoAppInternal, CNWSPlayer *pPlayer, int32_t bUseSaveGameCharacter, int32_t bUseStateDataInSaveGame)
@@ -900,6 +933,10 @@ void Race::SetRaceModifier(int32_t raceId, RaceModifier raceMod, int32_t param1,
     auto raceNameText = Globals::Rules()->m_lstRaces[raceId].GetNameText();
     auto raceName = raceNameText.CStr();
     std::string sRace = std::to_string(raceId);
+
+    if (static_cast<size_t>(raceId) < g_plugin->m_RaceEffectBundles.size())
+        g_plugin->m_RaceEffectBundles[raceId].m_bBuilt = false;
+
     switch (raceMod)
     {
         case AB:
@@ -1164,6 +1201,7 @@ ArgumentStack Race::SetRacialModifier(ArgumentStack&& args)
     auto param3 = ScriptAPI::ExtractArgument<int>(args);
 
     SetRaceModifier(raceId, raceMod, param1, param2, param3);
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
 
     return ScriptAPI::Arguments();
 }
@@ -1184,6 +1222,7 @@ ArgumentStack Race::SetFavoredEnemyFeat(ArgumentStack&& args)
     ASSERT_OR_THROW(pFeat);
 
     g_plugin->m_RaceFavoredEnemyFeat[raceId].push_back(featId);
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
 
     LOG_INFO("%s: Setting Favored Enemy Feat to %s.", Globals::Rules()->m_lstRaces[raceId].GetNameText().CStr(), pFeat->GetNameText().CStr());
 
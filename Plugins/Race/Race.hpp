@@ -79,7 +79,36 @@ private:
     unordered_map<uint16_t, vector<uint16_t>>                                         m_RaceFavoredEnemyFeat;
 
 
-    static void DoEffect(CNWSCreature*, uint16_t, int32_t, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0);
+    struct EffectTemplate
+    {
+        uint16_t m_nType;
+        int32_t m_nParams[6];
+    };
+
+    // The modifiers of a race resolved into what applying them does, built on first use.
+    struct RaceEffectBundle
+    {
+        bool m_bBuilt = false;
+        // Unique per build, so creatures can tell their racial effects are out of date.
+        uint32_t m_nVersion = 0;
+        vector<EffectTemplate> m_Effects;
+        vector<pair<uint16_t, uint8_t>> m_Feats;
+        vector<tuple<uint32_t, uint8_t, uint8_t>> m_FeatUsages;
+        uint8_t m_nSRCharGen = 0;
+        uint8_t m_nSRMax = 0;
+        uint8_t m_nSRInc = 0;
+        uint8_t m_nSRLevel = 0;
+        uint8_t m_nSRStart = 0;
+
+        int32_t GetSpellResistance(int32_t nLevel) const;
+    };
+
+    // Indexed by race id.
+    vector<RaceEffectBundle> m_RaceEffectBundles;
+    uint32_t m_nRaceEffectBundleVersion = 0;
+
+    static const RaceEffectBundle& GetRaceEffectBundle(uint16_t);
+    static void DoEffect(CNWSCreature*, const EffectTemplate&);
     static void ApplyRaceEffects(CNWSCreature*);
     static void SetOrRestoreRace(bool, CNWSCreatureStats*, CNWSCreatureStats* = nullptr);
     static void SetRaceModifier(int32_t, RaceModifier, int32_t, int32_t, int32_t);
@@ -0,0 +1,254 @@
+#include "Cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace Redis
+{
+
+using namespace std::chrono;
+
+static std::string CommandName(const std::vector<std::string>& cmd)
+{
+    std::string name = cmd[0];
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    return name;
+}
+
+// Rough estimate of how much memory a cached reply holds on to.
+static size_t ReplySize(const cpp_redis::reply& r)
+{
+    size_t size = sizeof(cpp_redis::reply);
+    if (r.is_string())
+        size += r.as_string().size();
+    else if (r.is_array())
+    {
+        for (auto& e : r.as_array())
+            size += ReplySize(e);
+    }
+    return size;
+}
+
+void Cache::Configure(bool enabled, size_t maxBytes, std::chrono::seconds ttl)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    m_maxBytes = maxBytes;
+    m_ttl = ttl;
+    m_enabled = enabled;
+    ClearLocked();
+}
+
+void Cache::SetTracking(bool tracking)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // Whatever we have might have changed while nobody was listening.
+    if (tracking != m_tracking)
+        ClearLocked();
+
+    m_tracking = tracking;
+}
+
+bool Cache::IsCacheableRead(const std::vector<std::string>& cmd)
+{
+    if (cmd.size() < 2 || cmd.size() > 3)
+        return false;
+
+    const auto name = CommandName(cmd);
+    return (cmd.size() == 2 && (name == "GET" || name == "HGETALL")) ||
+           (cmd.size() == 3 && name == "HGET");
+}
+
+std::optional<cpp_redis::reply> Cache::Lookup(const std::vector<std::string>& cmd)
+{
+    if (!m_enabled || !m_tracking)
+        return {};
+
+    const auto name = CommandName(cmd);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto it = m_entries.find(cmd[1]);
+    if (it == m_entries.end())
+    {
+        m_stats.m_misses++;
+        return {};
+    }
+
+    auto& entry = it->second;
+    if (entry.m_expires <= steady_clock::now())
+    {
+        EraseLocked(it);
+        m_stats.m_misses++;
+        return {};
+    }
+
+    const cpp_redis::reply* found = nullptr;
+    if (name == "GET" && entry.m_get)
+        found = &*entry.m_get;
+    else if (name == "HGETALL" && entry.m_hgetall)
+        found = &*entry.m_hgetall;
+    else if (name == "HGET")
+    {
+        auto field = entry.m_hget.find(cmd[2]);
+        if (field != entry.m_hget.end())
+            found = &field->second;
+    }
+
+    if (!found)
+    {
+        m_stats.m_misses++;
+        return {};
+    }
+
+    m_stats.m_hits++;
+    m_lru.splice(m_lru.begin(), m_lru, entry.m_lru);
+    return *found;
+}
+
+void Cache::Store(const std::vector<std::string>& cmd, const cpp_redis::reply& reply, uint64_t epoch)
+{
+    if (!m_enabled || !m_tracking || reply.is_error())
+        return;
+
+    const auto name = CommandName(cmd);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // Something was invalidated while the read was in flight; the reply may be stale.
+    if (epoch != m_epoch)
+        return;
+
+    auto it = m_entries.find(cmd[1]);
+    if (it == m_entries.end())
+    {
+        m_lru.push_front(cmd[1]);
+        it = m_entries.emplace(cmd[1], Entry()).first;
+
+        auto& entry = it->second;
+        entry.m_lru = m_lru.begin();
+        entry.m_expires = steady_clock::now() + m_ttl;
+        entry.m_bytes = sizeof(Entry) + 2 * cmd[1].size();
+        m_bytes += entry.m_bytes;
+    }
+
+    auto& entry = it->second;
+    size_t added = ReplySize(reply);
+
+    if (name == "GET" && !entry.m_get)
+        entry.m_get = reply;
+    else if (name == "HGETALL" && !entry.m_hgetall)
+        entry.m_hgetall = reply;
+    else if (name == "HGET" && entry.m_hget.find(cmd[2]) == entry.m_hget.end())
+    {
+        entry.m_hget.emplace(cmd[2], reply);
+        added += cmd[2].size();
+    }
+    else
+        return;
+
+    entry.m_bytes += added;
+    m_bytes += added;
+
+    while (m_bytes > m_maxBytes && !m_lru.empty())
+    {
+        EraseLocked(m_entries.find(m_lru.back()));
+        m_stats.m_evictions++;
+    }
+}
+
+void Cache::Invalidate(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    m_epoch++;
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        EraseLocked(it);
+        m_stats.m_invalidations++;
+    }
+}
+
+void Cache::InvalidateAll()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    m_stats.m_invalidations += m_entries.size();
+    ClearLocked();
+}
+
+void Cache::InvalidateFromCommand(const std::vector<std::string>& cmd)
+{
+    // Reads that never modify their keys, so there is no need to drop them.
+    static const std::unordered_set<std::string> s_readOnly =
+    {
+        "GET", "HGET", "HGETALL", "MGET", "HMGET", "EXISTS", "STRLEN", "GETRANGE",
+        "HEXISTS", "HLEN", "HKEYS", "HVALS", "HSTRLEN", "TTL", "PTTL", "TYPE",
+        "LLEN", "LRANGE", "LINDEX", "SCARD", "SMEMBERS", "SISMEMBER",
+        "ZCARD", "ZSCORE", "ZRANGE", "ZRANK", "ZCOUNT", "PING", "ECHO", "PUBLISH",
+    };
+
+    if (!m_enabled || cmd.size() < 2)
+        return;
+
+    const auto name = CommandName(cmd);
+    if (s_readOnly.count(name))
+        return;
+
+    if (name == "FLUSHDB" || name == "FLUSHALL")
+    {
+        InvalidateAll();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    m_epoch++;
+
+    if (m_entries.empty())
+        return;
+
+    // We don't know which arguments are keys, so try all of them.
+    for (size_t i = 1; i < cmd.size(); i++)
+    {
+        auto it = m_entries.find(cmd[i]);
+        if (it != m_entries.end())
+        {
+            EraseLocked(it);
+            m_stats.m_invalidations++;
+        }
+    }
+}
+
+Cache::Stats Cache::TakeStats()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    Stats stats = m_stats;
+    stats.m_bytes = m_bytes;
+    stats.m_entries = m_entries.size();
+
+    m_stats = Stats();
+    return stats;
+}
+
+void Cache::EraseLocked(EntryMap::iterator it)
+{
+    m_bytes -= it->second.m_bytes;
+    m_lru.erase(it->second.m_lru);
+    m_entries.erase(it);
+}
+
+void Cache::ClearLocked()
+{
+    m_epoch++;
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cpp_redis/cpp_redis>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Redis
+{
+
+// A client-side cache for the replies of plain reads (GET, HGET, HGETALL).
+//
+// Entries are keyed by the redis key they were read from and are dropped when:
+// - redis tells us the key changed (CLIENT TRACKING invalidation messages),
+// - we write to the key ourselves (so a script sees its own writes at once),
+// - they are older than the configured TTL,
+// - the cache runs over its memory budget (least recently used goes first).
+//
+// Nothing is served from the cache while the invalidation listener is down.
+//
+// All calls are threadsafe.
+class Cache
+{
+public:
+    struct Stats
+    {
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+        uint64_t m_invalidations = 0;
+        uint64_t m_evictions = 0;
+        size_t m_bytes = 0;
+        size_t m_entries = 0;
+    };
+
+    void Configure(bool enabled, size_t maxBytes, std::chrono::seconds ttl);
+    bool IsEnabled() const { return m_enabled; }
+
+    // Set by the invalidation listener. When not tracking, lookups always miss
+    // and nothing is stored.
+    void SetTracking(bool tracking);
+    bool IsTracking() const { return m_tracking; }
+
+    // True for the commands whose replies we are willing to cache.
+    static bool IsCacheableRead(const std::vector<std::string>& cmd);
+
+    // Returns the cached reply for a cacheable read, if any.
+    std::optional<cpp_redis::reply> Lookup(const std::vector<std::string>& cmd);
+
+    // Grab this before sending a read and hand it to Store(); the reply is only
+    // kept if nothing got invalidated in the meantime.
+    uint64_t GetEpoch() const { return m_epoch; }
+    void Store(const std::vector<std::string>& cmd, const cpp_redis::reply& reply, uint64_t epoch);
+
+    void Invalidate(const std::string& key);
+    void InvalidateAll();
+    // Drops every key a (potentially) writing command could have touched.
+    void InvalidateFromCommand(const std::vector<std::string>& cmd);
+
+    // Returns the counters gathered since the last call and resets them.
+    Stats TakeStats();
+
+private:
+    struct Entry
+    {
+        std::optional<cpp_redis::reply> m_get;
+        std::optional<cpp_redis::reply> m_hgetall;
+        std::unordered_map<std::string, cpp_redis::reply> m_hget;
+
+        std::chrono::steady_clock::time_point m_expires;
+        size_t m_bytes;
+        std::list<std::string>::iterator m_lru;
+    };
+
+    using EntryMap = std::unordered_map<std::string, Entry>;
+
+    void EraseLocked(EntryMap::iterator it);
+    void ClearLocked();
+
+    std::mutex m_mtx;
+    EntryMap m_entries;
+    // Most recently used keys first.
+    std::list<std::string> m_lru;
+    size_t m_bytes = 0;
+
+    size_t m_maxBytes = 0;
+    std::chrono::seconds m_ttl{0};
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_tracking{false};
+    std::atomic<uint64_t> m_epoch{0};
+
+    Stats m_stats;
+};
+
+}
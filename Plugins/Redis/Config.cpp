@@ -17,6 +17,10 @@ std::unique_ptr<cpp_redis::redis_client> Redis::PoolMakeFunc()
 
     auto p = std::make_unique<cpp_redis::redis_client>();
     (*p).connect(m_internal->m_config.m_host, static_cast<size_t>(m_internal->m_config.m_port));
+
+    if (m_internal->m_config.m_cache)
+        EnableTracking(*p);
+
     return p;
 }
 
@@ -61,10 +65,31 @@ void Redis::Reconfigure()
         }
         m_internal->m_connection_pubsub.commit();
 
+        // Client-side cache.
+        m_internal->m_config.m_cache = Config::Get<bool>("CACHE", false);
+        m_internal->m_config.m_cache_max_memory_mb = Config::Get<int>("CACHE_MAX_MEMORY_MB", 32);
+        m_internal->m_config.m_cache_ttl = Config::Get<int>("CACHE_TTL", 300);
+        m_internal->m_config.m_cache_prefixes = String::Split(
+            Config::Get<std::string>("CACHE_PREFIXES", ""), ',');
+
+        m_internal->m_cache.Configure(m_internal->m_config.m_cache,
+            static_cast<size_t>(m_internal->m_config.m_cache_max_memory_mb) * 1024 * 1024,
+            std::chrono::seconds(m_internal->m_config.m_cache_ttl));
+
+        if (m_internal->m_config.m_cache)
+        {
+            LOG_INFO("Cache: Enabled with %dMB and a TTL of %ds",
+                m_internal->m_config.m_cache_max_memory_mb, m_internal->m_config.m_cache_ttl);
+        }
+
         LOG_INFO("%s", "Connected!");
     }
 
     m_internal->m_redis_pool.Clean();
+
+    // Outside the config lock, pool connections made meanwhile get tracking enabled once the id is known.
+    if (m_internal->m_config.m_cache)
+        ConnectTracking(m_internal->m_config.m_host, m_internal->m_config.m_port);
 }
 
 }
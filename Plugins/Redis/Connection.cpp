@@ -3,6 +3,7 @@
 
 #include "Services/Metrics/MetricData.hpp"
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <chrono>
@@ -84,22 +85,118 @@ void Redis::RawAsync(const std::vector<std::string>& v,
 {
     const auto start = steady_clock::now();
 
+    // The reply comes in after we returned, so everything the callback
+    // touches has to be captured by value.
     m_internal->m_redis_pool.Borrow<void>([&](auto & c) {
-        c.send(v, [&](auto & r) {
+        c.send(v, [this, v, start, results](auto & r) {
             const auto end = steady_clock::now();
             const auto diff = duration_cast<nanoseconds>(end - start).count();
             this->LogQuery(v, r, static_cast<uint64_t>(diff));
+            m_internal->m_cache.InvalidateFromCommand(v);
 
             results(r);
         }).commit();
     });
 }
 
+std::vector<cpp_redis::reply> Redis::RawSyncPipeline(const std::vector<std::vector<std::string>>& cmds)
+{
+    if (cmds.empty())
+        return {};
+
+    const auto start = steady_clock::now();
+
+    return m_internal->m_redis_pool.Borrow<std::vector<cpp_redis::reply>>([&](auto & c) {
+        std::vector<cpp_redis::reply> rt(cmds.size());
+
+        // send() only buffers; the whole batch goes out with the commit.
+        for (size_t i = 0; i < cmds.size(); i++)
+        {
+            c.send(cmds[i], [&rt, i](auto & r) {
+                rt[i] = r;
+            });
+        }
+        c.sync_commit();
+
+        const auto end = steady_clock::now();
+        const auto diff = duration_cast<nanoseconds>(end - start).count();
+        for (size_t i = 0; i < cmds.size(); i++)
+        {
+            this->LogQuery(cmds[i], rt[i], static_cast<uint64_t>(diff));
+            m_internal->m_cache.InvalidateFromCommand(cmds[i]);
+        }
+
+        return rt;
+    });
+}
+
+void Redis::RawAsyncPipeline(std::vector<std::vector<std::string>> cmds,
+                             std::function<void(std::vector<cpp_redis::reply>&)> results)
+{
+    struct Batch
+    {
+        std::vector<std::vector<std::string>> m_commands;
+        std::vector<cpp_redis::reply> m_replies;
+        std::atomic<size_t> m_pending;
+        steady_clock::time_point m_start;
+        std::function<void(std::vector<cpp_redis::reply>&)> m_callback;
+    };
+
+    if (cmds.empty())
+    {
+        std::vector<cpp_redis::reply> none;
+        results(none);
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->m_replies.resize(cmds.size());
+    batch->m_pending = cmds.size();
+    batch->m_commands = std::move(cmds);
+    batch->m_start = steady_clock::now();
+    batch->m_callback = std::move(results);
+
+    m_internal->m_redis_pool.Borrow<void>([&](auto & c) {
+        for (size_t i = 0; i < batch->m_commands.size(); i++)
+        {
+            c.send(batch->m_commands[i], [this, batch, i](auto & r) {
+                batch->m_replies[i] = r;
+
+                if (--batch->m_pending == 0)
+                {
+                    const auto end = steady_clock::now();
+                    const auto diff = duration_cast<nanoseconds>(end - batch->m_start).count();
+                    for (size_t j = 0; j < batch->m_commands.size(); j++)
+                    {
+                        this->LogQuery(batch->m_commands[j], batch->m_replies[j], static_cast<uint64_t>(diff));
+                        m_internal->m_cache.InvalidateFromCommand(batch->m_commands[j]);
+                    }
+
+                    batch->m_callback(batch->m_replies);
+                }
+            });
+        }
+        c.commit();
+    });
+}
+
 cpp_redis::reply Redis::RawSync(const std::vector<std::string>& v)
 {
+    auto& cache = m_internal->m_cache;
+    const bool cacheable = cache.IsEnabled() && Cache::IsCacheableRead(v);
+
+    uint64_t epoch = 0;
+    if (cacheable)
+    {
+        if (auto hit = cache.Lookup(v))
+            return *hit;
+
+        epoch = cache.GetEpoch();
+    }
+
     const auto start = steady_clock::now();
 
-    return m_internal->m_redis_pool.Borrow<cpp_redis::reply>([&](auto & c) {
+    auto reply = m_internal->m_redis_pool.Borrow<cpp_redis::reply>([&](auto & c) {
         cpp_redis::reply rt;
         c.send(v, [&](auto & r) {
             const auto end = steady_clock::now();
@@ -110,6 +207,13 @@ cpp_redis::reply Redis::RawSync(const std::vector<std::string>& v)
         }).sync_commit();
         return rt;
     });
+
+    if (cacheable)
+        cache.Store(v, reply, epoch);
+    else
+        cache.InvalidateFromCommand(v);
+
+    return reply;
 }
 
 std::string Redis::Sync(const std::vector<std::string>& v)
@@ -3,6 +3,9 @@
 #include <cpp_redis/cpp_redis>
 #include "Redis.hpp"
 #include "Pool.hpp"
+#include "Cache.hpp"
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <sstream>
 
@@ -22,6 +25,19 @@ struct Internal {
     std::string m_last_pubsub_channel;
     std::string m_last_pubsub_message;
 
+    // Client-side cache for reads, and the connection redis sends
+    // the invalidation messages for it to.
+    Cache m_cache;
+    cpp_redis::network::redis_connection m_connection_tracking;
+    std::atomic<int64_t> m_tracking_id{0};
+    // Bumped whenever the tracking connection is replaced, so the old one's disconnect is ignored.
+    std::atomic<uint32_t> m_tracking_generation{0};
+    // Set when (re)connecting failed, the next command after m_tracking_retry_at tries again.
+    std::atomic<bool> m_tracking_retry{false};
+    std::atomic<std::chrono::steady_clock::time_point> m_tracking_retry_at{};
+    std::mutex m_tracking_mtx;
+    std::chrono::steady_clock::time_point m_cache_last_report;
+
     // Config update mutex. Pool could run into this!
     std::mutex m_config_mtx;
 
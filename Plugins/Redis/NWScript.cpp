@@ -6,6 +6,8 @@
 #include "API/Functions.hpp"
 #include "API/CVirtualMachine.hpp"
 #include "API/CExoString.hpp"
+#include "API/CAppManager.hpp"
+#include "API/CServerExoApp.hpp"
 
 namespace Redis
 {
@@ -17,6 +19,40 @@ using namespace NWNXLib::API;
 // We cache all results until the end of the current script invocation.
 static std::vector<cpp_redis::reply> s_results;
 
+// Commands queued up between BeginPipeline and ExecutePipeline(Async).
+static bool s_pipelineOpen;
+static std::vector<std::vector<std::string>> s_pipeline;
+// The result id the first queued command will have its reply stored under.
+static size_t s_pipelineFirstResult;
+
+// Batch ids for async pipelines, and the one currently being delivered.
+static int32_t s_nextAsyncBatchId = 1;
+static int32_t s_currentAsyncBatchId;
+
+// Turns the raw nwscript arguments into a redis command without the
+// pop-and-reverse dance: the stack already is in the order it was pushed.
+static std::vector<std::string> ExtractCommand(ArgumentStack& arg)
+{
+    std::vector<std::string> v;
+    v.reserve(arg.size());
+
+    // be ignorant about type and just strip it, since we take
+    // raw values (integers, strings) and shove them as strings straight
+    // to redis. Strings get moved out, not copied.
+    for (auto& a : arg.m_stack)
+    {
+        if (a.Holds<std::string>())
+            v.emplace_back(std::move(a.Get<std::string>()));
+        else if (a.Holds<int32_t>())
+            v.emplace_back(std::to_string(a.Get<int32_t>()));
+        else
+            v.emplace_back(a.toString());
+    }
+    arg.m_stack.clear();
+
+    return v;
+}
+
 void Redis::CleanState(CVirtualMachineStack *pVirtualMachineStack)
 {
     m_ClearStackHook->CallOriginal<void>(pVirtualMachineStack);
@@ -25,9 +61,37 @@ void Redis::CleanState(CVirtualMachineStack *pVirtualMachineStack)
     {
         LOG_DEBUG("Clearing all results after script exit.");
         s_results.clear();
+
+        if (s_pipelineOpen)
+        {
+            LOG_WARNING("Discarding %d pipelined commands that were never executed.", s_pipeline.size());
+            s_pipeline.clear();
+            s_pipelineOpen = false;
+        }
     }
 }
 
+void Redis::OnAsyncPipeline(int32_t batchId, const std::string& script, ObjectID oidOwner,
+                            std::vector<cpp_redis::reply>& replies)
+{
+    Tasks::QueueOnMainThread([this, batchId, script, oidOwner, replies = std::move(replies)]() mutable {
+        // Only ever deliver script events when a module is running.
+        if (Globals::AppManager()->m_pServerExoApp->GetServerMode() != 2) {
+            LOG_DEBUG("Async pipeline %d dropped because no module is running.", batchId);
+            return;
+        }
+
+        // Replies of the batch are result ids 0..n-1 inside the script.
+        std::swap(s_results, replies);
+        s_currentAsyncBatchId = batchId;
+
+        Utils::ExecuteScript(script, oidOwner);
+
+        s_currentAsyncBatchId = 0;
+        std::swap(s_results, replies);
+    });
+}
+
 void Redis::RegisterWithNWScript()
 {
     // NWScript: Executes a raw redis command with a variable argument list.
@@ -35,25 +99,103 @@ void Redis::RegisterWithNWScript()
     ScriptAPI::RegisterEvent(PLUGIN_NAME, "Deferred",
             [&](ArgumentStack && arg)
             {
-                std::vector<std::string> v;
-                while (!arg.empty())
+                auto v = ExtractCommand(arg);
+
+                if (s_pipelineOpen)
                 {
-                    // be ignorant about type and just strip it, since we take
-                    // raw values (integers, strings) and shove them as strings straight
-                    // to redis.
-                    v.push_back(arg.top().toString());
-                    arg.pop();
+                    // Reserve the result slot; it gets filled in once the pipeline executes.
+                    s_pipeline.emplace_back(std::move(v));
+                    s_results.emplace_back();
+                }
+                else
+                {
+                    s_results.emplace_back(RawSync(v));
+                    ReportCacheMetrics();
+                    RetryTracking();
                 }
-                reverse(v.begin(), v.end());
-
-                auto ret = RawSync(v);
-
-                s_results.emplace_back(ret);
 
                 // We return the assigned opaque value. Ignore that this is an array index.
                 return ScriptAPI::Arguments(static_cast<int32_t>(s_results.size() - 1));
             });
 
+    // NWScript: Start queueing up commands instead of executing them.
+    ScriptAPI::RegisterEvent(PLUGIN_NAME, "BeginPipeline",
+            [&](ArgumentStack &&)
+            {
+                if (s_pipelineOpen)
+                {
+                    LOG_WARNING("BeginPipeline called while a pipeline is already open; keeping %d queued commands.",
+                                s_pipeline.size());
+                }
+                else
+                {
+                    s_pipelineOpen = true;
+                    s_pipeline.clear();
+                    s_pipelineFirstResult = s_results.size();
+                }
+
+                return ScriptAPI::Arguments();
+            });
+
+    // NWScript: Send all queued commands in one write and wait for the replies.
+    // Returns the number of commands executed.
+    ScriptAPI::RegisterEvent(PLUGIN_NAME, "ExecutePipeline",
+            [&](ArgumentStack &&)
+            {
+                if (!s_pipelineOpen)
+                {
+                    LOG_ERROR("ExecutePipeline called without BeginPipeline. This is a error on your side.");
+                    return ScriptAPI::Arguments(0);
+                }
+
+                auto cmds = std::move(s_pipeline);
+                s_pipeline.clear();
+                s_pipelineOpen = false;
+
+                auto replies = RawSyncPipeline(cmds);
+                for (size_t i = 0; i < replies.size(); i++)
+                    s_results[s_pipelineFirstResult + i] = std::move(replies[i]);
+
+                return ScriptAPI::Arguments(static_cast<int32_t>(cmds.size()));
+            });
+
+    // NWScript: Send all queued commands in one write without waiting.
+    // Runs the given script on the given object once all replies are in.
+    // Returns the batch id.
+    ScriptAPI::RegisterEvent(PLUGIN_NAME, "ExecutePipelineAsync",
+            [&](ArgumentStack && arg)
+            {
+                const auto oidOwner = ScriptAPI::ExtractArgument<ObjectID>(arg);
+                const auto script = ScriptAPI::ExtractArgument<std::string>(arg);
+
+                if (!s_pipelineOpen)
+                {
+                    LOG_ERROR("ExecutePipelineAsync called without BeginPipeline. This is a error on your side.");
+                    return ScriptAPI::Arguments(0);
+                }
+
+                auto cmds = std::move(s_pipeline);
+                s_pipeline.clear();
+                s_pipelineOpen = false;
+
+                const int32_t batchId = s_nextAsyncBatchId++;
+                RawAsyncPipeline(std::move(cmds),
+                    [this, batchId, script, oidOwner](std::vector<cpp_redis::reply>& replies)
+                    {
+                        if (!script.empty())
+                            OnAsyncPipeline(batchId, script, oidOwner, replies);
+                    });
+
+                return ScriptAPI::Arguments(batchId);
+            });
+
+    // NWScript: Returns the batch id of the async pipeline whose replies are being delivered, or 0.
+    ScriptAPI::RegisterEvent(PLUGIN_NAME, "GetAsyncBatchId",
+            [&](ArgumentStack &&)
+            {
+                return ScriptAPI::Arguments(s_currentAsyncBatchId);
+            });
+
     // NWScript: Returns the last query result type as a int.
     ScriptAPI::RegisterEvent(PLUGIN_NAME, "GetResultType",
             [&](ArgumentStack && arg)
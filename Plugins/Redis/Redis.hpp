@@ -40,6 +40,15 @@ public:
         std::string m_pubsub_script;
         // PUBSUB_CHANNELS
         std::vector<std::string> m_pubsub_channels;
+
+        // CACHE
+        bool m_cache;
+        // CACHE_MAX_MEMORY_MB
+        int m_cache_max_memory_mb;
+        // CACHE_TTL
+        int m_cache_ttl;
+        // CACHE_PREFIXES
+        std::vector<std::string> m_cache_prefixes;
     };
 
     Redis(NWNXLib::Services::ProxyServiceList* services);
@@ -62,6 +71,18 @@ public:
     void RawAsync(const std::vector<std::string>&,
                   std::function<void(cpp_redis::reply&)>);
 
+    // Executes a batch of raw redis commands on a single connection. All
+    // commands are written out in one go and the replies are returned in
+    // the same order as the commands.
+    // This call is fully threadsafe.
+    std::vector<cpp_redis::reply> RawSyncPipeline(const std::vector<std::vector<std::string>>&);
+
+    // Same as RawSyncPipeline, but does not block. You get called with all
+    // replies once the last one came in. The callback runs on the redis
+    // network thread, so queue anything touching the game on the main thread.
+    void RawAsyncPipeline(std::vector<std::vector<std::string>>,
+                          std::function<void(std::vector<cpp_redis::reply>&)>);
+
     // Some simple helpers below.
     // These will not require you to pull in cpp_redis.
     // HOWEVER, they are rather lacking in error-handling; for all but the
@@ -86,9 +107,18 @@ private:
     void RegisterWithNWScript();
     void HookSCORCO();
     void OnPubsub(const std::string& channel, const std::string& message);
+    void OnAsyncPipeline(int32_t batchId, const std::string& script, ObjectID oidOwner,
+                         std::vector<cpp_redis::reply>& replies);
     void LogQuery(const std::vector<std::string>&, const cpp_redis::reply&,
                   const uint64_t ns);
     std::unique_ptr<cpp_redis::redis_client> PoolMakeFunc();
+    void ConnectTracking(const std::string& host, int port);
+    void ReconnectTracking();
+    void RetryTracking();
+    void OnTrackingConnected();
+    void EnableTracking(cpp_redis::redis_client&);
+    void OnTrackingReply(cpp_redis::reply&);
+    void ReportCacheMetrics();
 
     static inline NWNXLib::Hooks::Hook m_ClearStackHook;
     static void CleanState(CVirtualMachineStack*);
@@ -0,0 +1,208 @@
+#include "Redis.hpp"
+#include "Internal.hpp"
+
+#include "Services/Metrics/MetricData.hpp"
+
+#include <chrono>
+
+namespace Redis
+{
+
+using namespace NWNXLib;
+using namespace NWNXLib::Services;
+using namespace std::chrono;
+
+static constexpr seconds TrackingRetryInterval = seconds(5);
+
+// Runs on the main thread when configuring, on the async thread when reconnecting. Doesn't wait for the
+// connection's client id, OnTrackingReply() enables tracking once it arrives.
+void Redis::ConnectTracking(const std::string& host, int port)
+{
+    std::lock_guard<std::mutex> lock(m_internal->m_tracking_mtx);
+    auto& conn = m_internal->m_connection_tracking;
+
+    // The disconnect callback of a connection we replace must not schedule a reconnect.
+    const auto generation = ++m_internal->m_tracking_generation;
+    m_internal->m_tracking_id = 0;
+    m_internal->m_cache.SetTracking(false);
+
+    try
+    {
+        if (conn.is_connected())
+            conn.disconnect(true);
+    }
+    catch (cpp_redis::redis_error& e)
+    {
+        LOG_NOTICE("Error while reconfiguring cache invalidation client: %s", e.what());
+    }
+
+    try
+    {
+        conn.connect(host, static_cast<size_t>(port),
+            [this, generation](auto &)
+            {
+                if (generation != m_internal->m_tracking_generation)
+                    return;
+
+                LOG_WARNING("Cache: Lost the invalidation connection, caching is suspended until it reconnects.");
+                m_internal->m_tracking_id = 0;
+                m_internal->m_cache.SetTracking(false);
+                Tasks::QueueOnAsyncThread([this]() { ReconnectTracking(); });
+            },
+            [this](auto &, auto & r)
+            {
+                OnTrackingReply(r);
+            });
+
+        // Pool connections redirect their invalidation messages here, so ask for our id and
+        // subscribe to the channel redis uses to deliver them over RESP2.
+        conn.send({"CLIENT", "ID"});
+        conn.send({"SUBSCRIBE", "__redis__:invalidate"});
+        conn.commit();
+    }
+    catch (cpp_redis::redis_error& e)
+    {
+        LOG_WARNING("Cache: Could not connect the invalidation client, retrying in %d seconds: %s",
+                    static_cast<int>(TrackingRetryInterval.count()), e.what());
+        m_internal->m_tracking_retry_at = steady_clock::now() + TrackingRetryInterval;
+        m_internal->m_tracking_retry = true;
+    }
+}
+
+void Redis::ReconnectTracking()
+{
+    std::string host;
+    int port;
+    {
+        std::lock_guard<std::mutex> lock(m_internal->m_config_mtx);
+        if (!m_internal->m_config.m_cache)
+            return;
+        host = m_internal->m_config.m_host;
+        port = m_internal->m_config.m_port;
+    }
+
+    ConnectTracking(host, port);
+}
+
+void Redis::RetryTracking()
+{
+    if (!m_internal->m_tracking_retry || steady_clock::now() < m_internal->m_tracking_retry_at.load())
+        return;
+
+    m_internal->m_tracking_retry = false;
+    Tasks::QueueOnAsyncThread([this]() { ReconnectTracking(); });
+}
+
+// Runs on the async thread once the invalidation connection knows its client id.
+void Redis::OnTrackingConnected()
+{
+    LOG_INFO("Cache: Invalidations are delivered to client %lld", static_cast<long long>(m_internal->m_tracking_id));
+
+    // Pooled connections still redirect to the previous client, replace them.
+    m_internal->m_redis_pool.Clean();
+    m_internal->m_redis_pool.Borrow<void>([this](auto & c)
+    {
+        std::lock_guard<std::mutex> lock(m_internal->m_config_mtx);
+        EnableTracking(c);
+    });
+}
+
+// Called with the config mutex held.
+void Redis::EnableTracking(cpp_redis::redis_client& c)
+{
+    const auto id = m_internal->m_tracking_id.load();
+    if (id == 0)
+        return;
+
+    // BCAST tracks writes to every key (under the prefixes) regardless of which
+    // connection read it, so it survives the pool dropping connections.
+    std::vector<std::string> cmd = {"CLIENT", "TRACKING", "ON", "REDIRECT", std::to_string(id), "BCAST"};
+    for (auto& prefix : m_internal->m_config.m_cache_prefixes)
+    {
+        cmd.push_back("PREFIX");
+        cmd.push_back(prefix);
+    }
+
+    cpp_redis::reply rt;
+    c.send(cmd, [&](auto & r) {
+        rt = r;
+    }).sync_commit();
+
+    if (rt.is_error())
+    {
+        LOG_ERROR("Cache: CLIENT TRACKING failed, caching is disabled (redis 6 or newer is required): %s",
+                  rt.as_string());
+        m_internal->m_cache.SetTracking(false);
+    }
+    else
+    {
+        m_internal->m_cache.SetTracking(true);
+    }
+}
+
+void Redis::OnTrackingReply(cpp_redis::reply& r)
+{
+    // Reply to CLIENT ID.
+    if (r.is_integer())
+    {
+        m_internal->m_tracking_id = r.as_integer();
+        Tasks::QueueOnAsyncThread([this]() { OnTrackingConnected(); });
+        return;
+    }
+
+    if (!r.is_array())
+        return;
+
+    // Invalidations come in as: message, __redis__:invalidate, [keys...]
+    const auto& msg = r.as_array();
+    if (msg.size() != 3 || !msg[0].is_string() || msg[0].as_string() != "message")
+        return;
+
+    const auto& payload = msg[2];
+    if (payload.is_null())
+    {
+        // The whole database got flushed.
+        m_internal->m_cache.InvalidateAll();
+    }
+    else if (payload.is_array())
+    {
+        for (auto& key : payload.as_array())
+        {
+            if (key.is_string())
+                m_internal->m_cache.Invalidate(key.as_string());
+        }
+    }
+    else if (payload.is_string())
+    {
+        m_internal->m_cache.Invalidate(payload.as_string());
+    }
+}
+
+void Redis::ReportCacheMetrics()
+{
+    if (!m_internal->m_cache.IsEnabled())
+        return;
+
+    const auto now = steady_clock::now();
+    if (now - m_internal->m_cache_last_report < seconds(1))
+        return;
+    m_internal->m_cache_last_report = now;
+
+    const auto stats = m_internal->m_cache.TakeStats();
+    const auto lookups = stats.m_hits + stats.m_misses;
+    const double hitRate = lookups ? static_cast<double>(stats.m_hits) / static_cast<double>(lookups) : 0.0;
+
+    GetServices()->m_metrics->Push(
+        "Cache",
+        {
+            { "hits", std::to_string(stats.m_hits) },
+            { "misses", std::to_string(stats.m_misses) },
+            { "hit_rate", std::to_string(hitRate) },
+            { "invalidations", std::to_string(stats.m_invalidations) },
+            { "evictions", std::to_string(stats.m_evictions) },
+            { "bytes", std::to_string(stats.m_bytes) },
+            { "entries", std::to_string(stats.m_entries) },
+        });
+}
+
+}
@@ -43,6 +43,102 @@ NWNX_PLUGIN_ENTRY Plugin* PluginLoad(Services::ProxyServiceList* services)
 
 namespace Rename {
 
+static uint64_t OverrideKey(ObjectID observerOid, ObjectID targetOid)
+{
+    return (static_cast<uint64_t>(observerOid) << 32) | targetOid;
+}
+
+static std::string NameOverrideKey(const char *displayName, const char *overrideName, int32_t playerNameState)
+{
+    std::string key = displayName;
+    key += '\0';
+    key += overrideName;
+    key += '\0';
+    key += std::to_string(playerNameState);
+    return key;
+}
+
+uint32_t FlatMap::Slot(uint64_t key) const
+{
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+}
+
+uint32_t FlatMap::Get(uint64_t key) const
+{
+    if (m_count == 0)
+        return NONE;
+
+    for (uint32_t i = Slot(key);; i = (i + 1) & m_mask)
+    {
+        if (m_keys[i] == key)
+            return m_values[i];
+        if (m_keys[i] == EMPTY)
+            return NONE;
+    }
+}
+
+void FlatMap::Set(uint64_t key, uint32_t value)
+{
+    if ((m_count + 1) * 4 > m_keys.size() * 3)
+        Grow();
+
+    uint32_t i = Slot(key);
+    while (m_keys[i] != EMPTY && m_keys[i] != key)
+        i = (i + 1) & m_mask;
+
+    if (m_keys[i] == EMPTY)
+        m_count++;
+    m_keys[i] = key;
+    m_values[i] = value;
+}
+
+uint32_t FlatMap::Remove(uint64_t key)
+{
+    if (m_count == 0)
+        return NONE;
+
+    uint32_t i = Slot(key);
+    while (m_keys[i] != key)
+    {
+        if (m_keys[i] == EMPTY)
+            return NONE;
+        i = (i + 1) & m_mask;
+    }
+    const uint32_t value = m_values[i];
+
+    // Shift the following entries of the probe sequence back, so no tombstones are needed.
+    for (uint32_t j = (i + 1) & m_mask; m_keys[j] != EMPTY; j = (j + 1) & m_mask)
+    {
+        const uint32_t home = Slot(m_keys[j]);
+        if (((j - home) & m_mask) >= ((j - i) & m_mask))
+        {
+            m_keys[i] = m_keys[j];
+            m_values[i] = m_values[j];
+            i = j;
+        }
+    }
+    m_keys[i] = EMPTY;
+    m_count--;
+
+    return value;
+}
+
+void FlatMap::Grow()
+{
+    std::vector<uint64_t> keys(std::max<size_t>(16, m_keys.size() * 2), EMPTY);
+    std::vector<uint32_t> values(keys.size());
+    std::swap(keys, m_keys);
+    std::swap(values, m_values);
+    m_mask = static_cast<uint32_t>(m_keys.size() - 1);
+    m_count = 0;
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] != EMPTY)
+            Set(keys[i], values[i]);
+    }
+}
+
 static Hooks::Hook s_WriteGameObjUpdate_UpdateObjectHook;
 static Hooks::Hook s_SendServerToPlayerExamineGui_CreatureDataHook;
 static Hooks::Hook s_SendServerToPlayerPlayModuleCharacterListResponseHook;
@@ -143,10 +239,10 @@ Rename::Rename(Services::ProxyServiceList* services)
               auto *pPlayerInfo = Globals::AppManager()->m_pServerExoApp->GetNetLayer()->GetPlayerInfo(pPlayer->m_nPlayerID);
               if (pPlayerInfo)
               {
-                  g_plugin->m_RenameOriginalNames[objectID] = std::make_tuple(
+                  g_plugin->SetOriginalNames(objectID, std::make_tuple(
                           pPlayerInfo->m_sPlayerName,
                           pCreature->m_pStats->m_lsFirstName,
-                          pCreature->m_pStats->m_lsLastName);
+                          pCreature->m_pStats->m_lsLastName));
                   g_plugin->SendNameUpdate(pCreature, Constants::PLAYERID_ALL_CLIENTS);
               }
           }
@@ -173,9 +269,109 @@ CNWSPlayer *Rename::player(ObjectID playerId)
     return pPlayer;
 }
 
+bool Rename::IsRenamed(ObjectID targetOid) const
+{
+    return m_RenamedTargets.Get(targetOid) != FlatMap::NONE;
+}
+
+void Rename::SetOriginalNames(ObjectID targetOid, std::tuple<CExoString, CExoLocString, CExoLocString>&& originalNames)
+{
+    m_RenameOriginalNames[targetOid] = std::move(originalNames);
+    m_RenamedTargets.Set(targetOid, 1);
+}
+
+// Once the last global and personal override of a target is gone the hooks can skip it again.
+void Rename::ForgetTargetIfNotRenamed(ObjectID targetOid)
+{
+    if (!IsRenamed(targetOid) || FindNameOverride(Constants::OBJECT_INVALID, targetOid))
+        return;
+
+    bool bHasOverride = false;
+    m_RenamePlayerNames.ForEach([&](uint64_t key, uint32_t)
+    {
+        if (static_cast<ObjectID>(key) == targetOid)
+            bHasOverride = true;
+    });
+    if (bHasOverride)
+        return;
+
+    m_RenamedTargets.Remove(targetOid);
+    m_RenameOriginalNames.erase(targetOid);
+}
+
+const Rename::NameOverride* Rename::FindNameOverride(ObjectID observerOid, ObjectID targetOid) const
+{
+    auto index = m_RenamePlayerNames.Get(OverrideKey(observerOid, targetOid));
+    return index == FlatMap::NONE ? nullptr : &m_NameOverrides[index];
+}
+
+const Rename::NameOverride* Rename::GetNameOverride(ObjectID observerOid, ObjectID targetOid) const
+{
+    if (auto *pNameOverride = FindNameOverride(observerOid, targetOid))
+        return pNameOverride;
+    return FindNameOverride(Constants::OBJECT_INVALID, targetOid);
+}
+
+void Rename::SetNameOverride(ObjectID observerOid, ObjectID targetOid, const std::string& displayName,
+                             const std::string& overrideName, int32_t playerNameState)
+{
+    auto key = NameOverrideKey(displayName.c_str(), overrideName.c_str(), playerNameState);
+    uint32_t index;
+
+    auto it = m_NameOverrideIndices.find(key);
+    if (it != m_NameOverrideIndices.end())
+    {
+        index = it->second;
+    }
+    else
+    {
+        if (m_FreeNameOverrides.empty())
+        {
+            index = static_cast<uint32_t>(m_NameOverrides.size());
+            m_NameOverrides.emplace_back();
+        }
+        else
+        {
+            index = m_FreeNameOverrides.back();
+            m_FreeNameOverrides.pop_back();
+        }
+
+        auto &nameOverride = m_NameOverrides[index];
+        nameOverride.m_sDisplayName = displayName.c_str();
+        nameOverride.m_sOverrideName = overrideName.c_str();
+        nameOverride.m_nPlayerNameState = playerNameState;
+        nameOverride.m_nRefs = 0;
+        m_NameOverrideIndices.emplace(std::move(key), index);
+    }
+
+    // Take the reference before dropping the previous one, they may be the same name.
+    m_NameOverrides[index].m_nRefs++;
+    ClearNameOverride(observerOid, targetOid);
+    m_RenamePlayerNames.Set(OverrideKey(observerOid, targetOid), index);
+}
+
+bool Rename::ClearNameOverride(ObjectID observerOid, ObjectID targetOid)
+{
+    auto index = m_RenamePlayerNames.Remove(OverrideKey(observerOid, targetOid));
+    if (index == FlatMap::NONE)
+        return false;
+
+    auto &nameOverride = m_NameOverrides[index];
+    if (--nameOverride.m_nRefs == 0)
+    {
+        m_NameOverrideIndices.erase(NameOverrideKey(nameOverride.m_sDisplayName.CStr(),
+                                                    nameOverride.m_sOverrideName.CStr(),
+                                                    nameOverride.m_nPlayerNameState));
+        nameOverride.m_sDisplayName = "";
+        nameOverride.m_sOverrideName = "";
+        m_FreeNameOverrides.push_back(index);
+    }
+    return true;
+}
+
 void Rename::SetOrRestorePlayerName(bool before, CNWSPlayer *targetPlayer, CNWSPlayer *observerPlayer, bool playerList)
 {
-    if (targetPlayer == nullptr || observerPlayer == nullptr)
+    if (targetPlayer == nullptr || observerPlayer == nullptr || !g_plugin->IsRenamed(targetPlayer->m_oidNWSObject))
         return;
 
     auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(targetPlayer->m_oidNWSObject);
@@ -207,65 +403,65 @@ void Rename::SetOrRestorePlayerName(bool before, CNWSPlayer *targetPlayer, CNWSP
 
 }
 
+// Object updates set and restore the name around every update, only write it when it actually changes.
+static void SetDisplayName(CNWSCreature *targetCreature, const CExoString& displayName)
+{
+    if (!(targetCreature->m_sDisplayName == displayName))
+        targetCreature->m_sDisplayName = displayName;
+}
+
 void Rename::SetPlayerNameAsObservedBy(CNWSCreature *targetCreature, ObjectID observerOid, bool playerList)
 {
     auto targetOid = targetCreature->m_idSelf;
-    if (!g_plugin->m_RenamePlayerNames.count(targetOid))
+    auto *pNameOverride = g_plugin->FindNameOverride(observerOid, targetOid);
+    const bool bPersonal = pNameOverride != nullptr;
+    if (!pNameOverride)
+        pNameOverride = g_plugin->FindNameOverride(Constants::OBJECT_INVALID, targetOid);
+    if (!pNameOverride)
         return;
-    if (g_plugin->m_RenamePlayerNames[targetOid].count(observerOid))
-    {
-        auto displayName = std::get<0>(g_plugin->m_RenamePlayerNames[targetOid][observerOid]);
-        auto overrideName = std::get<1>(g_plugin->m_RenamePlayerNames[targetOid][observerOid]);
-        if (playerList)
-        {
-            targetCreature->m_pStats->m_lsFirstName = Utils::CreateLocString(overrideName.CStr());
-            targetCreature->m_pStats->m_lsLastName = Utils::CreateLocString("");
-        }
-        targetCreature->m_sDisplayName = displayName;
-        LOG_DEBUG("Observer %x will see %x as %s due to personal override", observerOid, targetOid, overrideName.m_sString);
-    }
-    else if (g_plugin->m_RenamePlayerNames[targetOid].count(Constants::OBJECT_INVALID))
+
+    if (playerList)
     {
-        auto displayName = std::get<0>(g_plugin->m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]);
-        auto overrideName = std::get<1>(g_plugin->m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]);
-        if (playerList)
-        {
-            targetCreature->m_pStats->m_lsFirstName = Utils::CreateLocString(overrideName.CStr());
-            targetCreature->m_pStats->m_lsLastName = Utils::CreateLocString("");
-        }
-        targetCreature->m_sDisplayName = displayName;
-        LOG_DEBUG("Observer %x will see %x as %s due to global override", observerOid, targetOid, overrideName.m_sString);
+        targetCreature->m_pStats->m_lsFirstName = Utils::CreateLocString(pNameOverride->m_sOverrideName.CStr());
+        targetCreature->m_pStats->m_lsLastName = Utils::CreateLocString("");
     }
+    SetDisplayName(targetCreature, pNameOverride->m_sDisplayName);
+    LOG_DEBUG("Observer %x will see %x as %s due to %s override", observerOid, targetOid,
+              pNameOverride->m_sOverrideName.m_sString, bPersonal ? "personal" : "global");
 }
 
 void Rename::RestorePlayerName(CNWSCreature *targetCreature, bool playerList)
 {
-    if (g_plugin->m_RenameOriginalNames.count(targetCreature->m_idSelf))
-    {
-        auto lsFirstName = std::get<1>(g_plugin->m_RenameOriginalNames[targetCreature->m_idSelf]);
-        auto lsLastName = std::get<2>(g_plugin->m_RenameOriginalNames[targetCreature->m_idSelf]);
-        if (playerList)
-        {
-            targetCreature->m_pStats->m_lsFirstName = lsFirstName;
-            targetCreature->m_pStats->m_lsLastName = lsLastName;
-        }
+    auto originalNames = g_plugin->m_RenameOriginalNames.find(targetCreature->m_idSelf);
+    if (originalNames == g_plugin->m_RenameOriginalNames.end())
+        return;
 
-        if (g_plugin->m_RenameOverwriteDisplayName &&
-            g_plugin->m_RenamePlayerNames[targetCreature->m_idSelf].count(Constants::OBJECT_INVALID))
-        {
-            targetCreature->m_sDisplayName = std::get<0>(g_plugin->m_RenamePlayerNames[targetCreature->m_idSelf][Constants::OBJECT_INVALID]);
-        }
-        else
-        {
-            targetCreature->m_sDisplayName = "";
-        }
+    if (playerList)
+    {
+        targetCreature->m_pStats->m_lsFirstName = std::get<1>(originalNames->second);
+        targetCreature->m_pStats->m_lsLastName = std::get<2>(originalNames->second);
     }
+
+    auto *pGlobalOverride = g_plugin->m_RenameOverwriteDisplayName ?
+                            g_plugin->FindNameOverride(Constants::OBJECT_INVALID, targetCreature->m_idSelf) : nullptr;
+    if (pGlobalOverride)
+        SetDisplayName(targetCreature, pGlobalOverride->m_sDisplayName);
+    else if (!targetCreature->m_sDisplayName.IsEmpty())
+        targetCreature->m_sDisplayName = "";
 }
 
 void Rename::WriteGameObjUpdate_UpdateObjectHook(CNWSMessage *pMessage, CNWSPlayer *pPlayer, CNWSObject *pAreaObject,
                                                  CLastUpdateObject *pLastUpdateObject, uint32_t nObjectUpdatesRequired,
                                                  uint32_t nObjectAppearanceUpdatesRequired)
 {
+    // Called for every object in view of every player, most of them aren't renamed players.
+    if (!g_plugin->IsRenamed(pAreaObject->m_idSelf))
+    {
+        s_WriteGameObjUpdate_UpdateObjectHook->CallOriginal<void>(pMessage, pPlayer, pAreaObject, pLastUpdateObject,
+                                                                  nObjectUpdatesRequired, nObjectAppearanceUpdatesRequired);
+        return;
+    }
+
     auto *pTargetPlayer = Globals::AppManager()->m_pServerExoApp->GetClientObjectByObjectId(pAreaObject->m_idSelf);
     SetOrRestorePlayerName(true, pTargetPlayer, pPlayer);
     s_WriteGameObjUpdate_UpdateObjectHook->CallOriginal<void>(pMessage, pPlayer, pAreaObject, pLastUpdateObject,
@@ -348,14 +544,9 @@ int32_t Rename::SendServerToPlayerPopUpGUIPanelHook(
         auto *server = Globals::AppManager()->m_pServerExoApp;
         auto *observerCreature = server->GetCreatureByGameObjectID(observerOid);
         auto targetOid = observerCreature->m_oidInvitedToPartyBy;
-        if (g_plugin->m_RenamePlayerNames.count(targetOid) && g_plugin->m_RenamePlayerNames[targetOid].count(observerOid))
-        {
-            *p_sStringReference = std::get<0>(g_plugin->m_RenamePlayerNames[targetOid][observerOid]);
-        }
-        else if (g_plugin->m_RenamePlayerNames.count(targetOid) &&
-                 g_plugin->m_RenamePlayerNames[targetOid].count(Constants::OBJECT_INVALID))
+        if (auto *pNameOverride = g_plugin->GetNameOverride(observerOid, targetOid))
         {
-            *p_sStringReference = std::get<0>(g_plugin->m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]);
+            *p_sStringReference = pNameOverride->m_sDisplayName;
         }
     }
     return s_SendServerToPlayerPopUpGUIPanelHook->CallOriginal<int32_t>(pMessage, observerOid, nGuiPanel, bGUIOption1,
@@ -366,6 +557,9 @@ void Rename::GlobalNameChange(
         PlayerID observerPlayerId,
         PlayerID targetPlayerId)
 {
+    if (m_RenamedTargets.Size() == 0)
+        return;
+
     auto *server = Globals::AppManager()->m_pServerExoApp;
     auto *playerList = server->m_pcExoAppInternal->m_pNWSPlayerList->m_pcExoLinkedListInternal;
     std::vector<PlayerID> observersToNotify;
@@ -395,6 +589,9 @@ void Rename::GlobalNameChange(
         for (auto *head = playerList->pHead; head; head = head->pNext)
         {
             auto *targetPlayer = static_cast<CNWSPlayer *>(static_cast<CNWSClient *>(head->pObject));
+            // Nothing is changed for players that aren't renamed, don't visit them for every observer.
+            if (!IsRenamed(targetPlayer->m_oidNWSObject))
+                continue;
             if ((targetPlayerId == Constants::PLAYERID_ALL_GAMEMASTERS &&
                  targetPlayer->m_nCharacterType == Constants::CharacterType::DM) ||
                 (targetPlayerId == Constants::PLAYERID_ALL_PLAYERS &&
@@ -418,10 +615,10 @@ void Rename::GlobalNameChange(
             auto *targetPlayer = static_cast<CNWSPlayer*>(server->GetClientObjectByPlayerId(targetPid, 0));
             auto targetOid = targetPlayer->m_oidNWSObject;
             auto *targetCreature = server->GetCreatureByGameObjectID(targetOid);
-            if (targetCreature && g_plugin->m_RenamePlayerNames.count(targetOid) &&
-                g_plugin->m_RenamePlayerNames[targetOid].count(Constants::OBJECT_INVALID))
+            auto *pGlobalOverride = FindNameOverride(Constants::OBJECT_INVALID, targetOid);
+            if (targetCreature && pGlobalOverride)
             {
-                auto playerNameOverrideState = std::get<2>(g_plugin->m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]);
+                auto playerNameOverrideState = pGlobalOverride->m_nPlayerNameState;
                 if (playerNameOverrideState)
                 {
                     auto playerInfo = pNetLayer->GetPlayerInfo(targetPid);
@@ -437,7 +634,7 @@ void Rename::GlobalNameChange(
                                 playerInfo->m_sPlayerName = CExoString(GenerateRandomPlayerName(7, targetOid).c_str());
                                 break;
                             case NWNX_RENAME_PLAYERNAME_OVERRIDE:
-                                playerInfo->m_sPlayerName = std::get<1>(g_plugin->m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]);
+                                playerInfo->m_sPlayerName = pGlobalOverride->m_sOverrideName;
                                 break;
                             case NWNX_RENAME_PLAYERNAME_ANONYMOUS:
                                 playerInfo->m_sPlayerName = CExoString(m_RenameAnonymousPlayerName.c_str());
@@ -500,10 +697,10 @@ void Rename::SendNameUpdate(CNWSCreature *targetCreature, PlayerID observerPlaye
         auto *observerPlayerObject = static_cast<CNWSPlayer*>(server->GetClientObjectByPlayerId(pid, 0));
         if (observerPlayerObject == nullptr)
             continue;
-        auto targets = g_plugin->m_RenamePlayerNames[targetCreature->m_idSelf];
 
         // If the update is to all clients but the observer has a personal override of the target's name then skip
-        if (observerPlayerId == Constants::PLAYERID_ALL_CLIENTS && targets.count(observerPlayerObject->m_oidNWSObject))
+        if (observerPlayerId == Constants::PLAYERID_ALL_CLIENTS &&
+            FindNameOverride(observerPlayerObject->m_oidNWSObject, targetCreature->m_idSelf))
             continue;
 
         // The client may crash if we send an object update for a creature that does not exist in its
@@ -603,15 +800,14 @@ ArgumentStack Rename::SetPCNameOverride(ArgumentStack&& args)
         fullDisplayName = std::regex_replace(fullDisplayName, std::regex("^ +| +$|( ) +"), "$1"); //remove trailing and leading spaces
 
         // Store our override values
-        m_RenamePlayerNames[targetOid][observerOid] = std::make_tuple(CExoString(fullDisplayName.c_str()),
-                                                                      CExoString(newName.c_str()), bPlayerNameState);
+        SetNameOverride(observerOid, targetOid, fullDisplayName, newName, bPlayerNameState);
 
         // Store the original values
         auto *pPlayerInfo = server->GetNetLayer()->GetPlayerInfo(targetPlayer->m_nPlayerID);
-        m_RenameOriginalNames[targetOid] = std::make_tuple(
+        SetOriginalNames(targetOid, std::make_tuple(
                 pPlayerInfo->m_sPlayerName,
                 targetCreature->m_pStats->m_lsFirstName,
-                targetCreature->m_pStats->m_lsLastName);
+                targetCreature->m_pStats->m_lsLastName));
 
         // If we've ran this before the PC has even been added to the other clients' player list then there's
         // nothing else we need to do, the hooks will take care of doing the renames. If we don't skip this
@@ -641,10 +837,8 @@ ArgumentStack Rename::GetPCNameOverride(ArgumentStack &&args)
             return ScriptAPI::Arguments();
         }
         auto observerOid = ScriptAPI::ExtractArgument<ObjectID>(args);
-        if(m_RenamePlayerNames[targetOid].find(observerOid) != m_RenamePlayerNames[targetOid].end())
-            retVal = std::get<0>(m_RenamePlayerNames[targetOid][observerOid]).CStr();
-        else if(m_RenamePlayerNames[targetOid].find(Constants::OBJECT_INVALID) != m_RenamePlayerNames[targetOid].end())
-            retVal = std::get<0>(m_RenamePlayerNames[targetOid][Constants::OBJECT_INVALID]).CStr();
+        if (auto *pNameOverride = GetNameOverride(observerOid, targetOid))
+            retVal = pNameOverride->m_sDisplayName.CStr();
     }
     return ScriptAPI::Arguments(retVal);
 }
@@ -670,36 +864,50 @@ ArgumentStack Rename::ClearPCNameOverride(ArgumentStack &&args)
     if (observerOid == Constants::OBJECT_INVALID && !bClearAll)
     {
         auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(playerOid);
-        m_RenamePlayerNames[playerOid].erase(Constants::OBJECT_INVALID);
+        ClearNameOverride(Constants::OBJECT_INVALID, playerOid);
         SendNameUpdate(targetCreature, Constants::PLAYERID_ALL_CLIENTS);
+        ForgetTargetIfNotRenamed(playerOid);
     }
     // clears global override and all personal overrides for that target PC
     else if (observerOid == Constants::OBJECT_INVALID)
     {
         auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(playerOid);
-        m_RenamePlayerNames.erase(playerOid);
+        std::vector<ObjectID> observers;
+        m_RenamePlayerNames.ForEach([&](uint64_t key, uint32_t)
+        {
+            if (static_cast<ObjectID>(key) == playerOid)
+                observers.push_back(static_cast<ObjectID>(key >> 32));
+        });
+        for (auto oid : observers)
+            ClearNameOverride(oid, playerOid);
         SendNameUpdate(targetCreature, Constants::PLAYERID_ALL_CLIENTS);
+        ForgetTargetIfNotRenamed(playerOid);
     }
     // clears all personal overrides for the observer for any targets
     else if (playerOid == Constants::OBJECT_INVALID)
     {
-        for (auto tgt = m_RenamePlayerNames.cbegin(), next_tgt = tgt; tgt != m_RenamePlayerNames.cend(); tgt = next_tgt)
+        std::vector<ObjectID> targets;
+        m_RenamePlayerNames.ForEach([&](uint64_t key, uint32_t)
         {
-            ++next_tgt;
-            if (m_RenamePlayerNames[tgt->first].erase(observerOid))
-            {
-                auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(tgt->first);
-                if (targetCreature)
-                    SendNameUpdate(targetCreature, observerPlayerId);
-            }
+            if (static_cast<ObjectID>(key >> 32) == observerOid)
+                targets.push_back(static_cast<ObjectID>(key));
+        });
+        for (auto oid : targets)
+        {
+            ClearNameOverride(observerOid, oid);
+            auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(oid);
+            if (targetCreature)
+                SendNameUpdate(targetCreature, observerPlayerId);
+            ForgetTargetIfNotRenamed(oid);
         }
     }
     // clears personal override for that observer for target oPC
     else
     {
         auto *targetCreature = Globals::AppManager()->m_pServerExoApp->GetCreatureByGameObjectID(playerOid);
-        m_RenamePlayerNames[playerOid].erase(observerOid);
+        ClearNameOverride(observerOid, playerOid);
         SendNameUpdate(targetCreature, observerPlayerId);
+        ForgetTargetIfNotRenamed(playerOid);
     }
     return ScriptAPI::Arguments();
 }
@@ -10,6 +10,38 @@ using ArgumentStack = NWNXLib::ArgumentStack;
 
 namespace Rename {
 
+// Open addressing map of 64 bit keys to 32 bit values. Lookups don't allocate and usually touch a single cache line.
+class FlatMap
+{
+public:
+    static constexpr uint64_t EMPTY = ~0ull;
+    static constexpr uint32_t NONE = ~0u;
+
+    uint32_t Get(uint64_t key) const;
+    void Set(uint64_t key, uint32_t value);
+    uint32_t Remove(uint64_t key);
+    size_t Size() const { return m_count; }
+
+    template <typename Func>
+    void ForEach(Func&& func) const
+    {
+        for (size_t i = 0; i < m_keys.size(); i++)
+        {
+            if (m_keys[i] != EMPTY)
+                func(m_keys[i], m_values[i]);
+        }
+    }
+
+private:
+    uint32_t Slot(uint64_t key) const;
+    void Grow();
+
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_values;
+    uint32_t m_mask = 0;
+    size_t m_count = 0;
+};
+
 class Rename : public NWNXLib::Plugin
 {
 public:
@@ -17,8 +49,23 @@ public:
     virtual ~Rename();
 
 private:
-    std::unordered_map<ObjectID, std::unordered_map<ObjectID, std::tuple<CExoString, CExoString, int32_t>>> m_RenamePlayerNames;
+    struct NameOverride
+    {
+        CExoString m_sDisplayName;
+        CExoString m_sOverrideName;
+        int32_t m_nPlayerNameState;
+        uint32_t m_nRefs;
+    };
+
+    // (observer, target) -> index into m_NameOverrides, global overrides have OBJECT_INVALID as the observer.
+    FlatMap m_RenamePlayerNames;
+    // Interned override names, shared by every observer that sees a target by the same name.
+    std::vector<NameOverride> m_NameOverrides;
+    std::vector<uint32_t> m_FreeNameOverrides;
+    std::unordered_map<std::string, uint32_t> m_NameOverrideIndices;
     std::unordered_map<ObjectID, std::tuple<CExoString, CExoLocString, CExoLocString>> m_RenameOriginalNames;
+    // The targets in m_RenameOriginalNames, the hooks leave every other object alone.
+    FlatMap m_RenamedTargets;
     std::unordered_map<ObjectID, std::string> m_ObfuscatedNames;
     bool m_RenameOnModuleCharList;
     std::unordered_set<PlayerID> m_RenameAddedToPlayerList;
@@ -40,6 +87,14 @@ private:
     static void RestorePlayerName(CNWSCreature *targetCreature, bool playerList=false);
     void GlobalNameChange(bool, PlayerID, PlayerID);
 
+    bool IsRenamed(ObjectID targetOid) const;
+    void SetOriginalNames(ObjectID targetOid, std::tuple<CExoString, CExoLocString, CExoLocString>&& originalNames);
+    void ForgetTargetIfNotRenamed(ObjectID targetOid);
+    const NameOverride* FindNameOverride(ObjectID observerOid, ObjectID targetOid) const;
+    const NameOverride* GetNameOverride(ObjectID observerOid, ObjectID targetOid) const;
+    void SetNameOverride(ObjectID observerOid, ObjectID targetOid, const std::string& displayName, const std::string& overrideName, int32_t playerNameState);
+    bool ClearNameOverride(ObjectID observerOid, ObjectID targetOid);
+
     std::string GenerateRandomPlayerName(size_t length, ObjectID targetOid);
     bool IsCreatureInLastUpdateObjectList(CNWSPlayer *player, ObjectID creatureId);
 
@@ -92,6 +92,7 @@ SQL::SQL(Services::ProxyServiceList* services)
     }
 
     m_utf8 = Config::Get<bool>("USE_UTF8", false);
+    m_compressObjects = Config::Get<bool>("COMPRESS_OBJECTS", false);
 
     Reconnect(19);
 }
@@ -336,11 +337,11 @@ ArgumentStack SQL::PreparedObjectFull(ArgumentStack&& args)
     {
         CGameObject *pObject = API::Globals::AppManager()->m_pServerExoApp->GetGameObject(value);
         if (base64) {
-            std::string serializedObject = Utils::SerializeGameObjectB64(pObject);
-            m_target->PrepareString(position, serializedObject);
+            Utils::SerializeGameObjectB64(pObject, m_serializedB64, true, m_compressObjects);
+            m_target->PrepareString(position, m_serializedB64);
         } else {
-            std::vector<uint8_t> serializedObjectVec = Utils::SerializeGameObject(pObject);
-            m_target->PrepareBinary(position, serializedObjectVec);
+            Utils::SerializeGameObject(pObject, m_serialized, true, m_compressObjects);
+            m_target->PrepareBinary(position, m_serialized);
         }
     }
     return {};
@@ -376,7 +377,7 @@ ArgumentStack SQL::ReadFullObjectInActiveRow(ArgumentStack&& args)
 
     std::string serialized = m_activeRow[column];
     ObjectID retval = API::Constants::OBJECT_INVALID;
-    CGameObject *pObject = base64 ? Utils::DeserializeGameObjectB64(serialized) : Utils::DeserializeGameObject(std::vector<uint8_t>(serialized.begin(), serialized.end()));
+    CGameObject *pObject = base64 ? Utils::DeserializeGameObjectB64(serialized) : Utils::DeserializeGameObject(reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
     if (pObject)
     {
         retval = static_cast<ObjectID>(pObject->m_idSelf);
@@ -46,7 +46,11 @@ private:
     bool m_queryMetrics;
     bool m_queryPrepared;
     bool m_utf8;
+    bool m_compressObjects;
     std::string m_databaseType;
+    // Reused between PreparedObjectFull calls so we don't allocate for every object.
+    std::vector<uint8_t> m_serialized;
+    std::string m_serializedB64;
 };
 
 }
@@ -4,18 +4,23 @@
 #include "API/CNWSArea.hpp"
 #include "API/CNWSCreature.hpp"
 #include "API/CNWSCreatureStats.hpp"
+#include "API/CNWSCreatureStats_ClassInfo.hpp"
 #include "API/CNWSkill.hpp"
 #include "API/CAppManager.hpp"
 #include "API/CServerExoApp.hpp"
 #include "API/Constants.hpp"
 #include "API/Globals.hpp"
 #include "API/Functions.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <list>
 #include <numeric>
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
+using namespace std::chrono;
 
 static SkillRanks::SkillRanks* g_plugin;
 
@@ -39,7 +44,183 @@ NWNX_PLUGIN_ENTRY Plugin* PluginLoad(Services::ProxyServiceList* services)
 
 namespace SkillRanks {
 
+namespace {
+
+// Everything a cached rank depends on that can change without going through a hook we see.
+// Only fields read straight off the creature, anything more expensive would eat the saving.
+struct CreatureSnapshot
+{
+    ObjectID m_oidArea;
+    uint16_t m_nRace;
+    std::array<int8_t, 8> m_modifiers;
+    std::array<uint8_t, 6> m_classLevels;
+
+    bool operator==(const CreatureSnapshot& other) const
+    {
+        return m_oidArea == other.m_oidArea && m_nRace == other.m_nRace && m_modifiers == other.m_modifiers &&
+               m_classLevels == other.m_classLevels;
+    }
+    bool operator!=(const CreatureSnapshot& other) const { return !(*this == other); }
+};
+
+// The area's flags and the time of day, only looked at for creatures with a skill feat that depends on them.
+struct EnvironmentSnapshot
+{
+    uint32_t m_nAreaFlags;
+    uint8_t m_nDayNight;
+
+    bool operator!=(const EnvironmentSnapshot& other) const
+    {
+        return m_nAreaFlags != other.m_nAreaFlags || m_nDayNight != other.m_nDayNight;
+    }
+};
+
+struct CachedRank
+{
+    uint32_t m_nGeneration = 0;
+    int32_t m_nModifiers;
+    bool m_bHasEffectBonus;
+    int32_t m_nEffectBonus;
+};
+
+struct SkillRankCache
+{
+    // Bumped on every invalidation, ranks from an older generation are recomputed on next use.
+    uint32_t m_nGeneration = 1;
+    uint32_t m_nGlobalGeneration = 0;
+    CreatureSnapshot m_snapshot{};
+    // Set once a rank was computed from a skill feat with area or day/night conditions.
+    bool m_bEnvironmentDependent = false;
+    EnvironmentSnapshot m_environment{};
+    std::vector<CachedRank> m_ranks;
+};
+
+struct Stats
+{
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_invalidations = 0;
+    uint64_t m_mismatches = 0;
+};
+
+}
+
 static Hooks::Hook s_LoadRulesetInfoHook;
+static POS::ExtensionId s_cacheExtensionId;
+// Bumped when a skill feat, area modifier or any other rule shared by all creatures changes.
+static uint32_t s_globalGeneration = 1;
+static Stats s_stats;
+static steady_clock::time_point s_lastMetricsReport;
+// Set by GetSkillModifiers() when a feat's area or day/night conditions were checked.
+static bool s_environmentChecked;
+
+static char ClampRank(int32_t rank)
+{
+    return static_cast<char>(std::clamp(rank, -127, 127));
+}
+
+static int32_t GetEffectBonus(CNWSCreatureStats* pStats, uint8_t nSkill, CNWSObject* pVersus)
+{
+    return pStats->m_pBaseCreature->GetTotalEffectBonus(5, pVersus, 0, 0, 0, 0, nSkill, -1, 0);
+}
+
+static CreatureSnapshot TakeSnapshot(CNWSCreatureStats* pStats)
+{
+    CreatureSnapshot snapshot{};
+    snapshot.m_oidArea = pStats->m_pBaseCreature->m_oidArea;
+    snapshot.m_nRace = pStats->m_nRace;
+    snapshot.m_modifiers = {pStats->m_nStrengthModifier, pStats->m_nDexterityModifier, pStats->m_nConstitutionModifier,
+                            pStats->m_nIntelligenceModifier, pStats->m_nWisdomModifier, pStats->m_nCharismaModifier,
+                            pStats->m_nArmorCheckPenalty, pStats->m_nShieldCheckPenalty};
+    for (int i = 0; i < 3; i++)
+    {
+        snapshot.m_classLevels[i * 2] = pStats->GetClass(i);
+        snapshot.m_classLevels[i * 2 + 1] = pStats->m_ClassInfo[i].m_nLevel;
+    }
+    return snapshot;
+}
+
+static EnvironmentSnapshot TakeEnvironmentSnapshot(CNWSCreatureStats* pStats)
+{
+    EnvironmentSnapshot snapshot{};
+    if (auto *pArea = Globals::AppManager()->m_pServerExoApp->GetAreaByGameObjectID(pStats->m_pBaseCreature->m_oidArea))
+    {
+        auto *pModule = Utils::GetModule();
+        auto currentHour = pModule->m_nCurrentHour;
+        auto isDay = currentHour >= pModule->m_nDawnHour && currentHour <= pModule->m_nDuskHour;
+        snapshot.m_nAreaFlags = pArea->m_nFlags;
+        snapshot.m_nDayNight = (isDay ? 1 : 0) | (pArea->GetIsNight() ? 2 : 0);
+    }
+    return snapshot;
+}
+
+static SkillRankCache& GetSkillRankCache(CNWSCreatureStats* pStats)
+{
+    auto *pCache = static_cast<SkillRankCache*>(POS::GetExtension(pStats->m_pBaseCreature, s_cacheExtensionId));
+    if (!pCache)
+    {
+        pCache = new SkillRankCache();
+        POS::SetExtension(pStats->m_pBaseCreature, s_cacheExtensionId, pCache);
+    }
+    return *pCache;
+}
+
+static void ValidateSkillRankCache(SkillRankCache& cache, CNWSCreatureStats* pStats)
+{
+    auto snapshot = TakeSnapshot(pStats);
+    if (cache.m_nGlobalGeneration != s_globalGeneration || cache.m_snapshot != snapshot)
+    {
+        // The number of skills can change with the ruleset.
+        cache.m_ranks.resize(Globals::Rules()->m_nNumSkills);
+        cache.m_nGlobalGeneration = s_globalGeneration;
+        cache.m_snapshot = snapshot;
+        cache.m_bEnvironmentDependent = false;
+        cache.m_nGeneration++;
+        s_stats.m_invalidations++;
+    }
+    else if (cache.m_bEnvironmentDependent)
+    {
+        auto environment = TakeEnvironmentSnapshot(pStats);
+        if (cache.m_environment != environment)
+        {
+            cache.m_bEnvironmentDependent = false;
+            cache.m_nGeneration++;
+            s_stats.m_invalidations++;
+        }
+    }
+}
+
+static void InvalidateSkillRankCache(CGameObject* pObject)
+{
+    if (auto *pCache = static_cast<SkillRankCache*>(POS::GetExtension(pObject, s_cacheExtensionId)))
+    {
+        pCache->m_nGeneration++;
+        s_stats.m_invalidations++;
+    }
+}
+
+static void InvalidateAllSkillRankCaches()
+{
+    s_globalGeneration++;
+}
+
+static void ReportMetrics()
+{
+    const auto now = steady_clock::now();
+    if (now - s_lastMetricsReport < seconds(1))
+        return;
+    s_lastMetricsReport = now;
+
+    g_plugin->GetServices()->m_metrics->Push(
+        "SkillRankCache",
+        {
+            { "hits", std::to_string(s_stats.m_hits) },
+            { "misses", std::to_string(s_stats.m_misses) },
+            { "invalidations", std::to_string(s_stats.m_invalidations) },
+            { "mismatches", std::to_string(s_stats.m_mismatches) },
+        });
+    s_stats = Stats();
+}
 
 SkillRanks::SkillRanks(Services::ProxyServiceList* services)
     : Plugin(services)
@@ -63,6 +244,80 @@ SkillRanks::SkillRanks(Services::ProxyServiceList* services)
 
     s_LoadRulesetInfoHook = Hooks::HookFunction(&CNWRules::LoadRulesetInfo, (void*)&LoadRulesetInfoHook, Hooks::Order::Earliest);
     static auto s_GetSkillRank = Hooks::HookFunction(&CNWSCreatureStats::GetSkillRank, (void*)&GetSkillRankHook, Hooks::Order::Final);
+
+    m_bCacheEnabled = Config::Get<bool>("CACHE", false);
+    m_bVerifyCache = Config::Get<bool>("VERIFY_CACHE", false);
+    if (m_bCacheEnabled)
+    {
+        if (m_bVerifyCache)
+            LOG_INFO("Verifying cached skill ranks against the full calculation.");
+
+        s_cacheExtensionId = POS::RegisterExtension([](void *p) { delete static_cast<SkillRankCache*>(p); });
+        InitCacheInvalidationHooks();
+    }
+}
+
+// Changes to a creature that a snapshot can't catch cheaply. Ability modifiers, armor check penalties,
+// class levels, the area and the time of day are compared on every lookup instead.
+void SkillRanks::InitCacheInvalidationHooks()
+{
+    static Hooks::Hook s_AddFeatHook = Hooks::HookFunction(&CNWSCreatureStats::AddFeat,
+    +[](CNWSCreatureStats *pThis, uint16_t nFeat) -> void
+    {
+        s_AddFeatHook->CallOriginal<void>(pThis, nFeat);
+        InvalidateSkillRankCache(pThis->m_pBaseCreature);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_RemoveFeatHook = Hooks::HookFunction(&CNWSCreatureStats::RemoveFeat,
+    +[](CNWSCreatureStats *pThis, uint16_t nFeat) -> void
+    {
+        s_RemoveFeatHook->CallOriginal<void>(pThis, nFeat);
+        InvalidateSkillRankCache(pThis->m_pBaseCreature);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_LevelUpHook = Hooks::HookFunction(&CNWSCreatureStats::LevelUp,
+    +[](CNWSCreatureStats *pThis, CNWLevelStats *pLevelUpStats, uint8_t nDomain1, uint8_t nDomain2, uint8_t nSchool, BOOL bAddStatsToList) -> void
+    {
+        s_LevelUpHook->CallOriginal<void>(pThis, pLevelUpStats, nDomain1, nDomain2, nSchool, bAddStatsToList);
+        InvalidateSkillRankCache(pThis->m_pBaseCreature);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_LevelDownHook = Hooks::HookFunction(&CNWSCreatureStats::LevelDown,
+    +[](CNWSCreatureStats *pThis, CNWLevelStats *pLevelUpStats) -> void
+    {
+        s_LevelDownHook->CallOriginal<void>(pThis, pLevelUpStats);
+        InvalidateSkillRankCache(pThis->m_pBaseCreature);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_ApplyEffectHook = Hooks::HookFunction(&CNWSObject::ApplyEffect,
+    +[](CNWSObject *pThis, CGameEffect *pEffect, BOOL bLoadingGame, BOOL bInitialApplication) -> void
+    {
+        s_ApplyEffectHook->CallOriginal<void>(pThis, pEffect, bLoadingGame, bInitialApplication);
+        InvalidateSkillRankCache(pThis);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_RemoveEffectHook = Hooks::HookFunction(&CNWSObject::RemoveEffect,
+    +[](CNWSObject *pThis, CGameEffect *pEffect) -> void
+    {
+        s_RemoveEffectHook->CallOriginal<void>(pThis, pEffect);
+        InvalidateSkillRankCache(pThis);
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_EquipItemHook = Hooks::HookFunction(&CNWSCreature::EquipItem,
+    +[](CNWSCreature *pThis, uint32_t nInventorySlot, CNWSItem *pItem, BOOL bApplyPropertyEffects, BOOL bLoadingItem) -> BOOL
+    {
+        auto retVal = s_EquipItemHook->CallOriginal<BOOL>(pThis, nInventorySlot, pItem, bApplyPropertyEffects, bLoadingItem);
+        InvalidateSkillRankCache(pThis);
+        return retVal;
+    }, Hooks::Order::VeryEarly);
+
+    static Hooks::Hook s_UnequipItemHook = Hooks::HookFunction(&CNWSCreature::UnequipItem,
+    +[](CNWSCreature *pThis, CNWSItem *pItem, BOOL bUnequipWhilePolymorphed) -> BOOL
+    {
+        auto retVal = s_UnequipItemHook->CallOriginal<BOOL>(pThis, pItem, bUnequipWhilePolymorphed);
+        InvalidateSkillRankCache(pThis);
+        return retVal;
+    }, Hooks::Order::VeryEarly);
 }
 
 SkillRanks::~SkillRanks()
@@ -82,6 +337,7 @@ void SkillRanks::LoadRulesetInfoHook(CNWRules* pRules)
                                      auto nRace = std::stoi(message[1]);
                                      auto nMod = std::stoi(message[2]);
                                      g_plugin->m_skillRaceMod[nSkill][nRace] = nMod;
+                                     InvalidateAllSkillRankCaches();
                                  });
 
     for (int featId = 0; featId < pRules->m_nNumFeats; featId++)
@@ -540,6 +796,8 @@ void SkillRanks::LoadRulesetInfoHook(CNWRules* pRules)
                 break;
         }
     }
+
+    InvalidateAllSkillRankCaches();
 }
 
 char SkillRanks::GetSkillRankHook(CNWSCreatureStats* thisPtr, uint8_t nSkill, CNWSObject* pVersus, int32_t bBaseOnly)
@@ -557,10 +815,71 @@ char SkillRanks::GetSkillRankHook(CNWSCreatureStats* thisPtr, uint8_t nSkill, CN
     if (!Globals::Rules()->m_lstSkills[nSkill].m_bUntrained && !thisPtr->m_lstSkillRanks[nSkill])
         return 0;
 
-    int32_t retVal = baseRank + thisPtr->m_pBaseCreature->GetTotalEffectBonus(5, pVersus, 0, 0, 0, 0, nSkill, -1, 0);
+    if (!g_plugin->m_bCacheEnabled)
+        return ClampRank(baseRank + GetEffectBonus(thisPtr, nSkill, pVersus) + GetSkillModifiers(thisPtr, nSkill));
+
+    ReportMetrics();
+
+    auto& cache = GetSkillRankCache(thisPtr);
+    ValidateSkillRankCache(cache, thisPtr);
 
+    auto& entry = cache.m_ranks[nSkill];
+    if (entry.m_nGeneration != cache.m_nGeneration)
+    {
+        entry.m_nGeneration = cache.m_nGeneration;
+        s_environmentChecked = false;
+        entry.m_nModifiers = GetSkillModifiers(thisPtr, nSkill);
+        entry.m_bHasEffectBonus = false;
+        if (s_environmentChecked && !cache.m_bEnvironmentDependent)
+        {
+            cache.m_bEnvironmentDependent = true;
+            cache.m_environment = TakeEnvironmentSnapshot(thisPtr);
+        }
+        s_stats.m_misses++;
+    }
+    else
+    {
+        s_stats.m_hits++;
+    }
+
+    // Effects can be conditional on the opponent, so only the bonus against no one in particular is kept.
+    int32_t effectBonus;
+    if (pVersus)
+    {
+        effectBonus = GetEffectBonus(thisPtr, nSkill, pVersus);
+    }
+    else
+    {
+        if (!entry.m_bHasEffectBonus)
+        {
+            entry.m_nEffectBonus = GetEffectBonus(thisPtr, nSkill, nullptr);
+            entry.m_bHasEffectBonus = true;
+        }
+        effectBonus = entry.m_nEffectBonus;
+    }
+
+    auto retVal = ClampRank(baseRank + effectBonus + entry.m_nModifiers);
+
+    if (g_plugin->m_bVerifyCache)
+    {
+        auto slowVal = ClampRank(baseRank + GetEffectBonus(thisPtr, nSkill, pVersus) + GetSkillModifiers(thisPtr, nSkill));
+        if (slowVal != retVal)
+        {
+            LOG_WARNING("Cached rank %d of skill %d for creature %x doesn't match the computed rank %d.",
+                        retVal, nSkill, thisPtr->m_pBaseCreature->m_idSelf, slowVal);
+            s_stats.m_mismatches++;
+            cache.m_nGeneration++;
+            return slowVal;
+        }
+    }
+
+    return retVal;
+}
+
+int32_t SkillRanks::GetSkillModifiers(CNWSCreatureStats* thisPtr, uint8_t nSkill)
+{
     // Add any racial modifiers broadcasted from the Race plugin
-    retVal += g_plugin->m_skillRaceMod[nSkill][thisPtr->m_nRace];
+    int32_t retVal = g_plugin->m_skillRaceMod[nSkill][thisPtr->m_nRace];
 
     auto *pArea = Globals::AppManager()->m_pServerExoApp->GetAreaByGameObjectID(thisPtr->m_pBaseCreature->m_oidArea);
 
@@ -647,6 +966,9 @@ char SkillRanks::GetSkillRankHook(CNWSCreatureStats* thisPtr, uint8_t nSkill, CN
                 }
             }
 
+            if (bAreaCheckRequired || bDayNightCheckRequired)
+                s_environmentChecked = true;
+
             if ((!bAreaCheckRequired || (bAreaCheckRequired && bAreaCheckPassed)) &&
                 (!bDayNightCheckRequired || (bDayNightCheckRequired && bDayNightCheckPassed)))
             {
@@ -714,11 +1036,6 @@ char SkillRanks::GetSkillRankHook(CNWSCreatureStats* thisPtr, uint8_t nSkill, CN
 
     retVal -= thisPtr->GetTotalNegativeLevels();
 
-    if (retVal <= -127)
-        retVal = -127;
-    else if (retVal > 127)
-        retVal = 127;
-
     return retVal;
 }
 
@@ -850,6 +1167,7 @@ ArgumentStack SkillRanks::SetSkillFeat(ArgumentStack&& args)
     else
     {
         g_plugin->m_skillFeatMap[skillId][featId] = skillFeats;
+        InvalidateAllSkillRankCaches();
     }
 
     return ScriptAPI::Arguments();
@@ -873,6 +1191,7 @@ ArgumentStack SkillRanks::SetSkillFeatFocusModifier(ArgumentStack&& args)
             }
         }
     }
+    InvalidateAllSkillRankCaches();
 
     return ScriptAPI::Arguments();
 }
@@ -912,6 +1231,7 @@ ArgumentStack SkillRanks::SetAreaModifier(ArgumentStack&& args)
     ASSERT_OR_THROW(modifier < 127);
 
     pArea->nwnxSet(areaModPOSKey + std::to_string(skillId), modifier, true);
+    InvalidateAllSkillRankCaches();
 
     return ScriptAPI::Arguments();
 }
@@ -927,6 +1247,7 @@ ArgumentStack SkillRanks::SetBlindnessPenalty(ArgumentStack &&args)
     ASSERT_OR_THROW(mod >= -255);
     ASSERT_OR_THROW(mod < 255);
     g_plugin->m_blindnessMod = mod;
+    InvalidateAllSkillRankCaches();
 
     return ScriptAPI::Arguments();
 }
@@ -27,8 +27,13 @@ private:
 
     static void LoadRulesetInfoHook(CNWRules*);
     static char GetSkillRankHook(CNWSCreatureStats*, uint8_t, CNWSObject*, int32_t);
+    // Everything but the base rank and effect bonuses, unclamped.
+    static int32_t GetSkillModifiers(CNWSCreatureStats*, uint8_t);
+    static void InitCacheInvalidationHooks();
 
     uint8_t m_blindnessMod;
+    bool m_bCacheEnabled;
+    bool m_bVerifyCache;
 
     struct SkillFeats {
         int8_t nModifier;
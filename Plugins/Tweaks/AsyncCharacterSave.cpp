@@ -0,0 +1,339 @@
+#include "nwnx.hpp"
+
+#include "API/CExoAliasList.hpp"
+#include "API/CExoBase.hpp"
+#include "API/CNWSModule.hpp"
+#include "API/CNWSPlayer.hpp"
+#include "API/CResGFF.hpp"
+#include "API/CServerExoAppInternal.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+
+namespace Core {
+extern bool g_CoreShuttingDown;
+}
+
+namespace Tweaks {
+
+using namespace NWNXLib;
+using namespace NWNXLib::API;
+
+namespace {
+
+struct Snapshot
+{
+    ObjectID m_oidCreature;
+    // Allocated by CResGFF::WriteGFFToPointer.
+    std::unique_ptr<uint8_t[]> m_data;
+    size_t m_length;
+    // How many older snapshots of the same file this one replaced before they got written.
+    uint32_t m_coalesced = 0;
+};
+
+// Writes character files on a worker thread. Saves of a file that is still waiting
+// to be written replace the waiting snapshot, so only the newest one hits the disk.
+class CharacterWriter
+{
+public:
+    CharacterWriter() : m_thread(&CharacterWriter::Worker, this) {}
+    ~CharacterWriter() { Shutdown(); }
+
+    void Enqueue(std::string&& path, Snapshot&& snapshot);
+    // Blocks until no file the predicate matches is waiting to be written or being written.
+    void Wait(const std::function<bool(const std::string& path, ObjectID oidCreature)>& match);
+    // Writes everything still queued and stops the worker.
+    void Shutdown();
+
+private:
+    void Worker();
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::condition_variable m_writtenCv;
+    bool m_stop = false;
+    bool m_stopped = false;
+    // The file the worker is writing right now, if any.
+    std::string m_writingPath;
+    ObjectID m_writingCreature = Constants::OBJECT_INVALID;
+    std::deque<std::string> m_order;
+    std::unordered_map<std::string, Snapshot> m_pending;
+    std::thread m_thread;
+};
+
+}
+
+static std::unique_ptr<CharacterWriter> s_writer;
+static CNWSPlayer *s_pSavingPlayer;
+
+// Write to a temporary file and rename it over the old one, so a crash halfway
+// through never leaves a truncated .bic behind. Returns an error message on failure.
+static std::string WriteFileAtomic(const std::string& path, const uint8_t *data, size_t length)
+{
+    const auto tmpPath = path + ".tmp";
+
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 && errno == ENOENT)
+    {
+        // First save of a new character, the vault directory may not exist yet.
+        const auto dir = path.substr(0, path.find_last_of('/'));
+        mkdir(dir.c_str(), 0755);
+        fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (fd < 0)
+        return std::string("open: ") + std::strerror(errno);
+
+    auto Fail = [&](const char *what)
+    {
+        const auto error = std::string(what) + ": " + std::strerror(errno);
+        close(fd);
+        unlink(tmpPath.c_str());
+        return error;
+    };
+
+    while (length > 0)
+    {
+        const auto written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return Fail("write");
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+
+    if (fsync(fd) != 0)
+        return Fail("fsync");
+    close(fd);
+
+    if (rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        const auto error = std::string("rename: ") + std::strerror(errno);
+        unlink(tmpPath.c_str());
+        return error;
+    }
+
+    // Make the rename itself durable.
+    const auto dir = path.substr(0, path.find_last_of('/'));
+    const int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+
+    return "";
+}
+
+void CharacterWriter::Enqueue(std::string&& path, Snapshot&& snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        auto it = m_pending.find(path);
+        if (it != m_pending.end())
+        {
+            snapshot.m_coalesced = it->second.m_coalesced + 1;
+            it->second = std::move(snapshot);
+            return;
+        }
+
+        m_pending.emplace(path, std::move(snapshot));
+        m_order.emplace_back(std::move(path));
+    }
+    m_cv.notify_one();
+}
+
+void CharacterWriter::Wait(const std::function<bool(const std::string& path, ObjectID oidCreature)>& match)
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_writtenCv.wait(lock, [&]
+    {
+        // Nothing queued after the worker stopped will be written.
+        if (m_stopped)
+            return true;
+        if (!m_writingPath.empty() && match(m_writingPath, m_writingCreature))
+            return false;
+        for (auto& [path, snapshot] : m_pending)
+        {
+            if (match(path, snapshot.m_oidCreature))
+                return false;
+        }
+        return true;
+    });
+}
+
+void CharacterWriter::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_stop)
+            return;
+        m_stop = true;
+
+        if (!m_order.empty())
+            LOG_INFO("Waiting for %d character files to be written.", m_order.size());
+    }
+    m_cv.notify_one();
+    m_thread.join();
+}
+
+void CharacterWriter::Worker()
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_stop || !m_order.empty(); });
+        if (m_order.empty())
+        {
+            m_stopped = true;
+            m_writtenCv.notify_all();
+            break;
+        }
+
+        auto path = std::move(m_order.front());
+        m_order.pop_front();
+        auto it = m_pending.find(path);
+        auto snapshot = std::move(it->second);
+        m_pending.erase(it);
+        m_writingPath = path;
+        m_writingCreature = snapshot.m_oidCreature;
+
+        lock.unlock();
+
+        const auto error = WriteFileAtomic(path, snapshot.m_data.get(), snapshot.m_length);
+        if (error.empty())
+            LOG_DEBUG("Wrote '%s' (%d bytes, replaced %d older saves).", path, snapshot.m_length, snapshot.m_coalesced);
+        else
+            LOG_ERROR("Failed to write '%s': %s", path, error);
+
+        Tasks::QueueOnMainThread([path, error, oid = snapshot.m_oidCreature, coalesced = snapshot.m_coalesced]()
+        {
+            if (Core::g_CoreShuttingDown)
+                return;
+
+            // The character may have logged out by the time the file is on disk.
+            const auto oidSelf = Utils::GetGameObject(oid) ? oid : Utils::GetModule()->m_idSelf;
+            MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT",
+            {
+                "NWNX_ON_CHARACTER_FILE_WRITTEN", Utils::ObjectIDToString(oidSelf),
+                "FILE_PATH", path,
+                "SUCCESS", error.empty() ? "1" : "0",
+                "ERROR", error,
+                "COALESCED", std::to_string(coalesced),
+            });
+        });
+
+        lock.lock();
+        m_writingPath.clear();
+        m_writingCreature = Constants::OBJECT_INVALID;
+        m_writtenCv.notify_all();
+    }
+}
+
+void AsyncCharacterSave() __attribute__((constructor));
+void AsyncCharacterSave()
+{
+    if (!Config::Get<bool>("ASYNC_CHARACTER_SAVE", false))
+        return;
+
+    LOG_INFO("Character files will be written on a background thread.");
+
+    s_writer = std::make_unique<CharacterWriter>();
+
+    static Hooks::Hook s_SaveServerCharacterHook = Hooks::HookFunction(&CNWSPlayer::SaveServerCharacter,
+        +[](CNWSPlayer *pPlayer, BOOL bBackupPlayer) -> BOOL
+        {
+            s_pSavingPlayer = pPlayer;
+            auto retVal = s_SaveServerCharacterHook->CallOriginal<BOOL>(pPlayer, bBackupPlayer);
+            s_pSavingPlayer = nullptr;
+            return retVal;
+        }, Hooks::Order::Latest);
+
+    static Hooks::Hook s_WriteGFFFileHook = Hooks::HookFunction(
+        static_cast<BOOL (CResGFF::*)(const CExoString&, RESTYPE)>(&CResGFF::WriteGFFFile),
+        +[](CResGFF *pThis, const CExoString& sFileName, RESTYPE nType) -> BOOL
+        {
+            if (!s_pSavingPlayer || nType != Constants::ResRefType::BIC || !s_writer)
+                return s_WriteGFFFileHook->CallOriginal<BOOL>(pThis, sFileName, nType);
+
+            // Resolve the alias now; the alias list isn't safe to touch from the worker.
+            std::string path = Globals::ExoBase()->m_pcExoAliasList->ResolveFileName(sFileName, nType).CStr();
+
+            // Serializing to memory is the cheap part, the disk write is what we move off the main thread.
+            uint8_t *pData = nullptr;
+            int32_t dataLength = 0;
+            if (path.empty() || !pThis->WriteGFFToPointer((void**)&pData, dataLength) || !pData)
+            {
+                delete[] pData;
+                return s_WriteGFFFileHook->CallOriginal<BOOL>(pThis, sFileName, nType);
+            }
+
+            Snapshot snapshot;
+            snapshot.m_oidCreature = s_pSavingPlayer->m_oidNWSObject;
+            snapshot.m_data.reset(pData);
+            snapshot.m_length = static_cast<size_t>(dataLength);
+            s_writer->Enqueue(std::move(path), std::move(snapshot));
+
+            return true;
+        }, Hooks::Order::Late);
+
+    // Engine paths that read or move character files on disk have to see the pending writes first:
+    // - the backup made when a character is saved with bBackupPlayer copies the file that was just saved,
+    // - a character logging back in is read from the file that was saved when they logged out,
+    // - the old servervault migration moves every character file of a player.
+    static Hooks::Hook s_BackupServerCharacterHook = Hooks::HookFunction(&CNWSPlayer::BackupServerCharacter,
+        +[](CNWSPlayer *pPlayer, const CExoString& sFilename) -> BOOL
+        {
+            const auto oidCreature = pPlayer->m_oidNWSObject;
+            s_writer->Wait([oidCreature](const std::string&, ObjectID oid) { return oid == oidCreature; });
+            return s_BackupServerCharacterHook->CallOriginal<BOOL>(pPlayer, sFilename);
+        }, Hooks::Order::Early);
+
+    static Hooks::Hook s_LoadCharacterStartHook = Hooks::HookFunction(&CServerExoAppInternal::LoadCharacterStart,
+        +[](CServerExoAppInternal *pThis, uint8_t nType, CNWSPlayer *pPlayer, CResRef cResRef, void *pCharData, uint32_t nSize) -> BOOL
+        {
+            auto fileName = "/" + std::string(cResRef.GetResRef(), cResRef.GetLength()) + ".bic";
+            std::transform(fileName.begin(), fileName.end(), fileName.begin(), [](unsigned char c) { return std::tolower(c); });
+            s_writer->Wait([&fileName](const std::string& path, ObjectID)
+            {
+                if (path.size() < fileName.size())
+                    return false;
+                return std::equal(fileName.begin(), fileName.end(), path.end() - fileName.size(),
+                                  [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+            });
+            return s_LoadCharacterStartHook->CallOriginal<BOOL>(pThis, nType, pPlayer, cResRef, pCharData, nSize);
+        }, Hooks::Order::Early);
+
+    static Hooks::Hook s_HandleOldServerVaultMigrationHook = Hooks::HookFunction(&CServerExoAppInternal::HandleOldServerVaultMigration,
+        +[](CServerExoAppInternal *pThis, CExoString sClientCDKey, CExoString sLegacyCDKey, CExoString sPlayerName) -> void
+        {
+            s_writer->Wait([](const std::string&, ObjectID) { return true; });
+            s_HandleOldServerVaultMigrationHook->CallOriginal<void>(pThis, sClientCDKey, sLegacyCDKey, sPlayerName);
+        }, Hooks::Order::Early);
+
+    // The server saves every character while shutting down, make sure those make it to disk.
+    MessageBus::Subscribe("NWNX_CORE_SIGNAL",
+        [](const std::vector<std::string>& message)
+        {
+            if (message[0] == "ON_DESTROY_SERVER_AFTER" && s_writer)
+                s_writer->Shutdown();
+        });
+}
+
+}
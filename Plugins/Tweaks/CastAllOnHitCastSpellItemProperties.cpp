@@ -45,10 +45,10 @@ void CastAllOnHitCastSpellItemProperties()
                 {
                     if (pItemProperty->m_nPropertyName == Constants::ItemProperty::OnHitCastSpell)
                     {
-                        int32_t nSpellID;
-                        if (Globals::Rules()->m_p2DArrays->GetOnHitSpellTable()->GetINTEntry(pItemProperty->m_nSubType, CExoString("SpellIndex"), &nSpellID))
+                        static TwoDA::Column s_SpellIndex(Globals::Rules()->m_p2DArrays->GetOnHitSpellTable()->m_cResRef.GetResRefStr(), "SpellIndex");
+                        if (auto nSpellID = s_SpellIndex.GetInt(pItemProperty->m_nSubType))
                         {
-                            if (auto *pSpell = Globals::Rules()->m_pSpellArray->GetSpell(nSpellID))
+                            if (auto *pSpell = Globals::Rules()->m_pSpellArray->GetSpell(*nSpellID))
                             {
                                 auto *pSpellScriptData = new CNWSSpellScriptData;
                                 pSpellScriptData->m_nSpellId = pSpell->m_nSpellId;
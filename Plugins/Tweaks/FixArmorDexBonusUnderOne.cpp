@@ -33,7 +33,8 @@ void FixArmorDexBonusUnderOne()
             int nTempValue = 0;
             if (pArmor && (nTempValue = pArmor->ComputeArmorClass()) > 0)
             {
-                Globals::Rules()->m_p2DArrays->GetArmorTable()->GetINTEntry(nTempValue, CExoString("DEXBONUS"), &nTempValue);
+                static TwoDA::Column s_DexBonus(Globals::Rules()->m_p2DArrays->GetArmorTable()->m_cResRef.GetResRefStr(), "DEXBONUS");
+                nTempValue = s_DexBonus.GetInt(nTempValue).value_or(nTempValue);
                 if (nTempValue < nDexAC)
                     nDexAC = static_cast<char>(nTempValue);
             }
@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <regex>
 #include <cmath>
+#include <algorithm>
 #include <chrono>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -39,6 +40,9 @@ static size_t s_resRefIndex;
 static std::vector<std::string> s_listResRefs;
 static std::unique_ptr<CScriptCompiler> s_scriptCompiler;
 static std::unordered_map<std::string, std::string> s_serverConsoleCommandMap;
+// NWScript 2DA column handles are indices into s_2DAColumns.
+static std::vector<TwoDA::Column> s_2DAColumns;
+static std::unordered_map<std::string, int32_t> s_2DAColumnHandles;
 
 static auto s_id = MessageBus::Subscribe("NWNX_CORE_SIGNAL",
     [](const std::vector<std::string>& message)
@@ -798,3 +802,66 @@ NWNX_EXPORT ArgumentStack GetModuleTlkFile(ArgumentStack&& args)
     CNWSModule *pMod = Utils::GetModule();
     return pMod->m_sModuleAltTLKFile;
 }
+
+static TwoDA::Column* Pop2DAColumn(ArgumentStack& args)
+{
+    const auto handle = args.extract<int32_t>();
+    if (handle < 0 || handle >= static_cast<int32_t>(s_2DAColumns.size()))
+        return nullptr;
+    return &s_2DAColumns[handle];
+}
+
+NWNX_EXPORT ArgumentStack Get2DAColumn(ArgumentStack&& args)
+{
+    const auto twoDA = args.extract<std::string>();
+      ASSERT_OR_THROW(!twoDA.empty());
+    const auto column = args.extract<std::string>();
+      ASSERT_OR_THROW(!column.empty());
+
+    auto key = twoDA + ":" + column;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+    auto it = s_2DAColumnHandles.find(key);
+    if (it != s_2DAColumnHandles.end())
+        return it->second;
+
+    TwoDA::Column handle(twoDA, column);
+    if (!handle.IsValid())
+        return -1;
+
+    s_2DAColumns.emplace_back(std::move(handle));
+    s_2DAColumnHandles.emplace(key, s_2DAColumns.size() - 1);
+    return static_cast<int32_t>(s_2DAColumns.size() - 1);
+}
+
+NWNX_EXPORT ArgumentStack Get2DAInt(ArgumentStack&& args)
+{
+    auto *pColumn = Pop2DAColumn(args);
+    const auto row = args.extract<int32_t>();
+    const auto defaultValue = args.extract<int32_t>();
+
+    if (!pColumn)
+        return defaultValue;
+    return pColumn->GetInt(row).value_or(defaultValue);
+}
+
+NWNX_EXPORT ArgumentStack Get2DAFloat(ArgumentStack&& args)
+{
+    auto *pColumn = Pop2DAColumn(args);
+    const auto row = args.extract<int32_t>();
+    const auto defaultValue = args.extract<float>();
+
+    if (!pColumn)
+        return defaultValue;
+    return pColumn->GetFloat(row).value_or(defaultValue);
+}
+
+NWNX_EXPORT ArgumentStack Get2DAString(ArgumentStack&& args)
+{
+    auto *pColumn = Pop2DAColumn(args);
+    const auto row = args.extract<int32_t>();
+
+    if (!pColumn)
+        return "";
+    return pColumn->GetString(row).value_or("");
+}
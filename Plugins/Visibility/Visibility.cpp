@@ -1,55 +1,159 @@
 #include "nwnx.hpp"
 #include "API/CNWSMessage.hpp"
 #include "API/CNWSObject.hpp"
+#include "API/CNWSArea.hpp"
 #include "API/CNWSCreature.hpp"
 #include "API/CNWSCreatureStats.hpp"
+#include "API/CNWSFaction.hpp"
+#include "API/CFactionManager.hpp"
+#include "API/CAppManager.hpp"
+#include "API/CServerExoApp.hpp"
+#include "API/CServerExoAppInternal.hpp"
+
+extern "C" void _ZN10CNWSObjectD1Ev(CNWSObject*);
 
 using namespace NWNXLib;
 using namespace NWNXLib::API;
 
-NWNX_EXPORT ArgumentStack GetVisibilityOverride(ArgumentStack&& args)
+namespace {
+
+// Open addressing map of target object -> override. Lookups don't allocate and
+// usually touch a single cache line.
+class OverrideTable
 {
-    const auto oidPlayer = args.extract<ObjectID>();
-    const auto oidTarget = args.extract<ObjectID>();
-      ASSERT_OR_THROW(oidTarget != Constants::OBJECT_INVALID);
+public:
+    int32_t Get(ObjectID oid) const
+    {
+        if (m_count == 0)
+            return -1;
 
-    int32_t retVal = -1;
-    if (oidPlayer == Constants::OBJECT_INVALID)
+        for (uint32_t i = Slot(oid);; i = (i + 1) & m_mask)
+        {
+            if (m_keys[i] == oid)
+                return m_values[i];
+            if (m_keys[i] == Constants::OBJECT_INVALID)
+                return -1;
+        }
+    }
+
+    void Set(ObjectID oid, int32_t value)
     {
-        if (auto *pTargetGO = Utils::GetGameObject(oidTarget))
+        if (value < 0)
         {
-            if (auto globalOverride = pTargetGO->nwnxGet<int32_t>("GLOBAL_VISIBILITY_OVERRIDE"))
-                retVal = *globalOverride;
+            Remove(oid);
+            return;
         }
+
+        if ((m_count + 1) * 4 > m_keys.size() * 3)
+            Grow();
+
+        uint32_t i = Slot(oid);
+        while (m_keys[i] != Constants::OBJECT_INVALID && m_keys[i] != oid)
+            i = (i + 1) & m_mask;
+
+        if (m_keys[i] == Constants::OBJECT_INVALID)
+            m_count++;
+        m_keys[i] = oid;
+        m_values[i] = static_cast<int8_t>(value);
     }
-    else
+
+    size_t Size() const { return m_count; }
+
+private:
+    uint32_t Slot(ObjectID oid) const
+    {
+        return (oid * 0x9E3779B1u) & m_mask;
+    }
+
+    void Remove(ObjectID oid)
+    {
+        if (m_count == 0)
+            return;
+
+        uint32_t i = Slot(oid);
+        while (m_keys[i] != oid)
+        {
+            if (m_keys[i] == Constants::OBJECT_INVALID)
+                return;
+            i = (i + 1) & m_mask;
+        }
+
+        // Shift the following entries of the probe sequence back, so no tombstones are needed.
+        for (uint32_t j = (i + 1) & m_mask; m_keys[j] != Constants::OBJECT_INVALID; j = (j + 1) & m_mask)
+        {
+            const uint32_t home = Slot(m_keys[j]);
+            if (((j - home) & m_mask) >= ((j - i) & m_mask))
+            {
+                m_keys[i] = m_keys[j];
+                m_values[i] = m_values[j];
+                i = j;
+            }
+        }
+        m_keys[i] = Constants::OBJECT_INVALID;
+        m_count--;
+    }
+
+    void Grow()
     {
-        if (auto *pPlayerGO = Utils::GetGameObject(oidPlayer))
+        std::vector<ObjectID> keys(std::max<size_t>(16, m_keys.size() * 2), Constants::OBJECT_INVALID);
+        std::vector<int8_t> values(keys.size());
+        std::swap(keys, m_keys);
+        std::swap(values, m_values);
+        m_mask = static_cast<uint32_t>(m_keys.size() - 1);
+        m_count = 0;
+
+        for (size_t i = 0; i < keys.size(); i++)
         {
-            if (auto personalOverride = pPlayerGO->nwnxGet<int32_t>("PERSONAL_VISIBILITY_OVERRIDE_" + std::to_string(oidTarget)))
-                retVal = *personalOverride;
+            if (keys[i] != Constants::OBJECT_INVALID)
+                Set(keys[i], values[i]);
         }
     }
 
-    return retVal;
+    std::vector<ObjectID> m_keys;
+    std::vector<int8_t> m_values;
+    uint32_t m_mask = 0;
+    size_t m_count = 0;
+};
+
 }
 
-NWNX_EXPORT ArgumentStack SetVisibilityOverride(ArgumentStack&& args)
+static OverrideTable s_globalOverrides;
+// Keyed by the observing player's creature.
+static std::unordered_map<ObjectID, OverrideTable> s_personalOverrides;
+// TestObjectVisible is called for every object for one player before moving on to the next.
+static ObjectID s_lastPlayer = Constants::OBJECT_INVALID;
+static const OverrideTable *s_pLastPlayerOverrides;
+
+static const OverrideTable* GetPersonalOverrides(ObjectID oidPlayer)
+{
+    if (oidPlayer != s_lastPlayer)
+    {
+        auto it = s_personalOverrides.find(oidPlayer);
+        s_pLastPlayerOverrides = it == s_personalOverrides.end() ? nullptr : &it->second;
+        s_lastPlayer = oidPlayer;
+    }
+    return s_pLastPlayerOverrides;
+}
+
+static void ForgetLastPlayer()
+{
+    s_lastPlayer = Constants::OBJECT_INVALID;
+    s_pLastPlayerOverrides = nullptr;
+}
+
+static void InitializeHooks()
 {
     static Hooks::Hook s_TestObjectVisibleHook = Hooks::HookFunction(&CNWSMessage::TestObjectVisible,
     +[](CNWSMessage *pThis, CNWSObject *pAreaObject, CNWSObject *pPlayerGameObject) -> int32_t
     {
-        if (pAreaObject->m_idSelf == pPlayerGameObject->m_idSelf)
+        if ((s_globalOverrides.Size() == 0 && s_personalOverrides.empty()) || pAreaObject->m_idSelf == pPlayerGameObject->m_idSelf)
             return s_TestObjectVisibleHook->CallOriginal<int32_t>(pThis, pAreaObject, pPlayerGameObject);
 
         int32_t visibilityOverride = -1;
-        if (auto personalOverride = pPlayerGameObject->nwnxGet<int32_t>("PERSONAL_VISIBILITY_OVERRIDE_" + std::to_string(pAreaObject->m_idSelf)))
-            visibilityOverride = *personalOverride;
+        if (auto *pPersonalOverrides = GetPersonalOverrides(pPlayerGameObject->m_idSelf))
+            visibilityOverride = pPersonalOverrides->Get(pAreaObject->m_idSelf);
         if (visibilityOverride == -1)
-        {
-            if (auto globalOverride = pAreaObject->nwnxGet<int32_t>("GLOBAL_VISIBILITY_OVERRIDE"))
-                visibilityOverride = *globalOverride;
-        }
+            visibilityOverride = s_globalOverrides.Get(pAreaObject->m_idSelf);
 
         switch (visibilityOverride)
         {
@@ -66,32 +170,156 @@ NWNX_EXPORT ArgumentStack SetVisibilityOverride(ArgumentStack&& args)
         }
     }, Hooks::Order::Late);
 
+    // Overrides belong to the objects involved, like local variables.
+    static Hooks::Hook s_ObjectDtorHook = Hooks::HookFunction(&_ZN10CNWSObjectD1Ev,
+    +[](CNWSObject *pThis) -> void
+    {
+        const auto oid = pThis->m_idSelf;
+        s_ObjectDtorHook->CallOriginal<void>(pThis);
+
+        s_globalOverrides.Set(oid, -1);
+        if (s_personalOverrides.erase(oid))
+            ForgetLastPlayer();
+    }, Hooks::Order::Late);
+}
+
+static void SetOverride(ObjectID oidPlayer, ObjectID oidTarget, int32_t override)
+{
+    static bool s_bHooked;
+    if (!s_bHooked)
+    {
+        InitializeHooks();
+        s_bHooked = true;
+    }
+
+    if (oidPlayer == Constants::OBJECT_INVALID)
+    {
+        s_globalOverrides.Set(oidTarget, override);
+        return;
+    }
+
+    if (override < 0)
+    {
+        auto it = s_personalOverrides.find(oidPlayer);
+        if (it != s_personalOverrides.end())
+        {
+            it->second.Set(oidTarget, override);
+            if (it->second.Size() == 0)
+            {
+                s_personalOverrides.erase(it);
+                ForgetLastPlayer();
+            }
+        }
+        return;
+    }
+
+    s_personalOverrides[oidPlayer].Set(oidTarget, override);
+    ForgetLastPlayer();
+}
+
+static bool MatchesObjectFilter(CGameObject *pObject, int32_t objectFilter)
+{
+    for (int32_t bit = 1; bit <= 256; bit <<= 1)
+    {
+        if ((objectFilter & bit) && Utils::NWScriptObjectTypeToEngineObjectType(bit) == pObject->m_nObjectType)
+            return true;
+    }
+    return false;
+}
+
+NWNX_EXPORT ArgumentStack GetVisibilityOverride(ArgumentStack&& args)
+{
+    const auto oidPlayer = args.extract<ObjectID>();
+    const auto oidTarget = args.extract<ObjectID>();
+      ASSERT_OR_THROW(oidTarget != Constants::OBJECT_INVALID);
+
+    if (oidPlayer == Constants::OBJECT_INVALID)
+        return s_globalOverrides.Get(oidTarget);
+
+    auto it = s_personalOverrides.find(oidPlayer);
+    return it == s_personalOverrides.end() ? -1 : it->second.Get(oidTarget);
+}
+
+NWNX_EXPORT ArgumentStack SetVisibilityOverride(ArgumentStack&& args)
+{
     const auto oidPlayer = args.extract<ObjectID>();
     const auto oidTarget = args.extract<ObjectID>();
       ASSERT_OR_THROW(oidTarget != Constants::OBJECT_INVALID);
     const auto override = args.extract<int32_t>();
       ASSERT_OR_THROW(override <= 4);
 
-    if (oidPlayer == Constants::OBJECT_INVALID)
+    if (oidPlayer != Constants::OBJECT_INVALID && !Utils::GetGameObject(oidPlayer))
+        return {};
+    if (!Utils::GetGameObject(oidTarget))
+        return {};
+
+    SetOverride(oidPlayer, oidTarget, override);
+
+    return {};
+}
+
+NWNX_EXPORT ArgumentStack SetVisibilityOverrideForArea(ArgumentStack&& args)
+{
+    const auto oidPlayer = args.extract<ObjectID>();
+    auto *pArea = Utils::PopArea(args);
+    const auto override = args.extract<int32_t>();
+      ASSERT_OR_THROW(override <= 4);
+    const auto objectFilter = args.extract<int32_t>();
+
+    if (!pArea || (oidPlayer != Constants::OBJECT_INVALID && !Utils::GetGameObject(oidPlayer)))
+        return 0;
+
+    int32_t count = 0;
+    for (int32_t i = 0; i < pArea->m_aGameObjects.num; i++)
     {
-        if (auto *pTargetGO = Utils::GetGameObject(oidTarget))
-        {
-            if (override < 0)
-                pTargetGO->nwnxRemove("GLOBAL_VISIBILITY_OVERRIDE");
-            else
-                pTargetGO->nwnxSet("GLOBAL_VISIBILITY_OVERRIDE", override);
-        }
+        const auto oidTarget = pArea->m_aGameObjects[i];
+        auto *pTarget = Utils::GetGameObject(oidTarget);
+        if (!pTarget || oidTarget == oidPlayer || !MatchesObjectFilter(pTarget, objectFilter))
+            continue;
+
+        SetOverride(oidPlayer, oidTarget, override);
+        count++;
     }
-    else
+
+    return count;
+}
+
+NWNX_EXPORT ArgumentStack SetVisibilityOverrideForFaction(ArgumentStack&& args)
+{
+    const auto oidPlayer = args.extract<ObjectID>();
+    auto *pFactionMember = Utils::PopCreature(args);
+    const auto override = args.extract<int32_t>();
+      ASSERT_OR_THROW(override <= 4);
+
+    if (!pFactionMember || (oidPlayer != Constants::OBJECT_INVALID && !Utils::GetGameObject(oidPlayer)))
+        return 0;
+
+    auto *pFaction = Globals::AppManager()->m_pServerExoApp->m_pcExoAppInternal->m_pFactionManager->GetFaction(pFactionMember->m_pStats->m_nFactionId);
+    if (!pFaction)
+        return 0;
+
+    int32_t count = 0;
+    for (int32_t i = 0; i < pFaction->m_listFactionMembers.num; i++)
     {
-        if (auto *pPlayerGO = Utils::GetGameObject(oidPlayer))
-        {
-            if (override < 0)
-                pPlayerGO->nwnxRemove("PERSONAL_VISIBILITY_OVERRIDE_" + std::to_string(oidTarget));
-            else
-                pPlayerGO->nwnxSet("PERSONAL_VISIBILITY_OVERRIDE_" + std::to_string(oidTarget), override);
-        }
+        const auto oidTarget = pFaction->m_listFactionMembers[i];
+        if (oidTarget == oidPlayer || !Utils::GetGameObject(oidTarget))
+            continue;
+
+        SetOverride(oidPlayer, oidTarget, override);
+        count++;
     }
 
+    return count;
+}
+
+NWNX_EXPORT ArgumentStack ClearVisibilityOverrides(ArgumentStack&& args)
+{
+    const auto oidPlayer = args.extract<ObjectID>();
+
+    if (oidPlayer == Constants::OBJECT_INVALID)
+        s_globalOverrides = OverrideTable();
+    else if (s_personalOverrides.erase(oidPlayer))
+        ForgetLastPlayer();
+
     return {};
 }
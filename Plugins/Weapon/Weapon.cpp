@@ -10,6 +10,8 @@
 #include "API/CNWBaseItem.hpp"
 #include "API/CNWRules.hpp"
 
+#include <algorithm>
+
 using namespace NWNXLib;
 using namespace NWNXLib::API;
 
@@ -79,6 +81,53 @@ Weapon::~Weapon()
 {
 }
 
+void Weapon::AddBaseItemFeat(uint32_t nBaseItem, WeaponFeatType type, uint32_t nFeat)
+{
+    if (nBaseItem >= m_BaseItemFeats.size())
+        m_BaseItemFeats.resize(nBaseItem + 1);
+
+    auto& feats = m_BaseItemFeats[nBaseItem].m_Feats[type];
+    if (std::find(feats.begin(), feats.end(), nFeat) == feats.end())
+        feats.push_back(nFeat);
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
+}
+
+const std::vector<uint16_t>* Weapon::GetBaseItemFeats(uint32_t nBaseItem, WeaponFeatType type) const
+{
+    if (nBaseItem >= m_BaseItemFeats.size())
+        return nullptr;
+
+    auto& feats = m_BaseItemFeats[nBaseItem].m_Feats[type];
+    return feats.empty() ? nullptr : &feats;
+}
+
+struct OneHalfStrength
+{
+    bool m_bOneHalfStrength;
+};
+
+static POS::ExtensionId GetOneHalfStrengthExtensionId()
+{
+    static const auto s_extensionId = POS::RegisterExtension([](void *p) { delete static_cast<OneHalfStrength*>(p); });
+    return s_extensionId;
+}
+
+int32_t Weapon::GetOneHalfStrength(CGameObject *pObject)
+{
+    if (!pObject)
+        return 0;
+
+    // The object storage stays the source of truth, it is what's persisted with the item.
+    auto *pExtension = static_cast<OneHalfStrength*>(POS::GetExtension(pObject, GetOneHalfStrengthExtensionId()));
+    if (!pExtension)
+    {
+        auto bStr = pObject->nwnxGet<int32_t>("ONE_HALF_STRENGTH");
+        pExtension = new OneHalfStrength{bStr && bStr.value()};
+        POS::SetExtension(pObject, GetOneHalfStrengthExtensionId(), pExtension);
+    }
+    return pExtension->m_bOneHalfStrength;
+}
+
 ArgumentStack Weapon::SetWeaponFocusFeat(ArgumentStack&& args)
 {
     const auto w_bitem  = ScriptAPI::ExtractArgument<int32_t>(args);
@@ -93,15 +142,7 @@ ArgumentStack Weapon::SetWeaponFocusFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_WeaponFocusMap.find(w_bitem);
-    if ( w != m_WeaponFocusMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_WeaponFocusMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, WEAPON_FOCUS, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Weapon Focus Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -123,15 +164,7 @@ ArgumentStack Weapon::SetGreaterWeaponFocusFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_GreaterWeaponFocusMap.find(w_bitem);
-    if ( w != m_GreaterWeaponFocusMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_GreaterWeaponFocusMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, GREATER_WEAPON_FOCUS, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Greater Weapon Focus Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -153,15 +186,7 @@ ArgumentStack Weapon::SetEpicWeaponFocusFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_EpicWeaponFocusMap.find(w_bitem);
-    if ( w != m_EpicWeaponFocusMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_EpicWeaponFocusMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, EPIC_WEAPON_FOCUS, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Epic Weapon Focus Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -182,6 +207,7 @@ ArgumentStack Weapon::SetWeaponFinesseSize(ArgumentStack&& args)
       ASSERT_OR_THROW(pBaseItem);
 
     pBaseItem->m_nWeaponFinesseMinimumCreatureSize = size;
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Weapon Finesse Size %d added for Base Item Type %d [%s]", size, w_bitem, baseItemName);
 
@@ -210,6 +236,7 @@ ArgumentStack Weapon::SetWeaponUnarmed(ArgumentStack&& args)
       ASSERT_OR_THROW(pBaseItem);
 
     m_WeaponUnarmedSet.insert(w_bitem);
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Base Item Type %d [%s] set as unarmed weapon", w_bitem, baseItemName);
 
@@ -228,6 +255,7 @@ ArgumentStack Weapon::SetWeaponIsMonkWeapon(ArgumentStack&& args)
     LOG_WARNING("NWNX_Weapon_SetWeaponIsMonkWeapon() is deprecated, please use baseitems.2da to set a weapon as monk weapon.");
 
     pBaseItem->m_bIsMonkWeapon = true;
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Base Item Type %d [%s] set as monk weapon", w_bitem, baseItemName);
 
@@ -248,15 +276,7 @@ ArgumentStack Weapon::SetWeaponImprovedCriticalFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_WeaponImprovedCriticalMap.find(w_bitem);
-    if ( w != m_WeaponImprovedCriticalMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_WeaponImprovedCriticalMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, IMPROVED_CRITICAL, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Improved Critical Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -278,15 +298,7 @@ ArgumentStack Weapon::SetWeaponSpecializationFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_WeaponSpecializationMap.find(w_bitem);
-    if ( w != m_WeaponSpecializationMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_WeaponSpecializationMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, WEAPON_SPECIALIZATION, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Weapon Specialization Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -308,15 +320,7 @@ ArgumentStack Weapon::SetGreaterWeaponSpecializationFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_GreaterWeaponSpecializationMap.find(w_bitem);
-    if ( w != m_GreaterWeaponSpecializationMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_GreaterWeaponSpecializationMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, GREATER_WEAPON_SPECIALIZATION, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Greater Weapon Specialization Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -338,15 +342,7 @@ ArgumentStack Weapon::SetEpicWeaponSpecializationFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_EpicWeaponSpecializationMap.find(w_bitem);
-    if ( w != m_EpicWeaponSpecializationMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_EpicWeaponSpecializationMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, EPIC_WEAPON_SPECIALIZATION, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Epic Weapon Specialization Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -368,15 +364,7 @@ ArgumentStack Weapon::SetEpicWeaponOverwhelmingCriticalFeat(ArgumentStack&& args
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_EpicWeaponOverwhelmingCriticalMap.find(w_bitem);
-    if ( w != m_EpicWeaponOverwhelmingCriticalMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_EpicWeaponOverwhelmingCriticalMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, OVERWHELMING_CRITICAL, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Overwhelming Critical Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -398,15 +386,7 @@ ArgumentStack Weapon::SetEpicWeaponDevastatingCriticalFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_EpicWeaponDevastatingCriticalMap.find(w_bitem);
-    if ( w != m_EpicWeaponDevastatingCriticalMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_EpicWeaponDevastatingCriticalMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, DEVASTATING_CRITICAL, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Devastating Critical Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -428,15 +408,7 @@ ArgumentStack Weapon::SetWeaponOfChoiceFeat(ArgumentStack&& args)
     CNWBaseItem *pBaseItem = Globals::Rules()->m_pBaseItemArray->GetBaseItem(w_bitem);
       ASSERT_OR_THROW(pBaseItem);
 
-    auto w = m_WeaponOfChoiceMap.find(w_bitem);
-    if ( w != m_WeaponOfChoiceMap.end())
-    {
-        w->second.emplace((uint32_t)feat);
-    }
-    else
-    {
-        m_WeaponOfChoiceMap.insert({w_bitem, {(uint32_t)feat}});
-    }
+    AddBaseItemFeat(w_bitem, WEAPON_OF_CHOICE, feat);
     auto featName = pFeat->GetNameText();
     auto baseItemName = pBaseItem->GetNameText();
     LOG_INFO("Weapon of Choice Feat %d [%s] added for Base Item Type %d [%s]", feat, featName, w_bitem, baseItemName);
@@ -460,6 +432,7 @@ ArgumentStack Weapon::SetOption(ArgumentStack&& args)
             LOG_INFO("Set NWNX_WEAPON_OPT_GRTSPEC_DAM_BONUS to %d", nVal);
             break;
     }
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
     return ScriptAPI::Arguments();
 }
 
@@ -507,13 +480,13 @@ int32_t Weapon::GetWeaponFocus(CNWSCreatureStats* pStats, CNWSItem* pWeapon)
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_WeaponFocusMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, WEAPON_FOCUS);
 
-    bApplicableFeatExists = w != plugin.m_WeaponFocusMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat) || (feat == Constants::Feat::WeaponFocus_Creature &&
             pStats->HasFeat(Constants::Feat::WeaponFocus_UnarmedStrike)));
@@ -531,13 +504,13 @@ int32_t Weapon::GetEpicWeaponFocus(CNWSCreatureStats* pStats, CNWSItem* pWeapon)
     int32_t bHasApplicableFeat = 0;
     Weapon& plugin = *g_plugin;
 
-    auto w = plugin.m_EpicWeaponFocusMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, EPIC_WEAPON_FOCUS);
 
-    bApplicableFeatExists = w != plugin.m_EpicWeaponFocusMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat) || (feat == Constants::Feat::EpicWeaponFocus_Creature &&
             pStats->HasFeat(Constants::Feat::EpicWeaponFocus_Unarmed)));
@@ -555,13 +528,13 @@ int32_t Weapon::GetWeaponImprovedCritical(CNWSCreatureStats* pStats, CNWSItem* p
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_WeaponImprovedCriticalMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, IMPROVED_CRITICAL);
 
-    bApplicableFeatExists = w != plugin.m_WeaponImprovedCriticalMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -579,13 +552,13 @@ int32_t Weapon::GetWeaponSpecialization(CNWSCreatureStats* pStats, CNWSItem* pWe
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_WeaponSpecializationMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, WEAPON_SPECIALIZATION);
 
-    bApplicableFeatExists = w != plugin.m_WeaponSpecializationMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -603,13 +576,13 @@ int32_t Weapon::GetEpicWeaponSpecialization(CNWSCreatureStats* pStats, CNWSItem*
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_EpicWeaponSpecializationMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, EPIC_WEAPON_SPECIALIZATION);
 
-    bApplicableFeatExists = w != plugin.m_EpicWeaponSpecializationMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -627,13 +600,13 @@ int32_t Weapon::GetEpicWeaponOverwhelmingCritical(CNWSCreatureStats* pStats, CNW
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_EpicWeaponOverwhelmingCriticalMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, OVERWHELMING_CRITICAL);
 
-    bApplicableFeatExists = w != plugin.m_EpicWeaponOverwhelmingCriticalMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -651,13 +624,13 @@ int32_t Weapon::GetEpicWeaponDevastatingCritical(CNWSCreatureStats* pStats, CNWS
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_EpicWeaponDevastatingCriticalMap.find(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(pWeapon == nullptr ? (uint32_t)Constants::BaseItem::Gloves : pWeapon->m_nBaseItem, DEVASTATING_CRITICAL);
 
-    bApplicableFeatExists = w != plugin.m_EpicWeaponDevastatingCriticalMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -697,13 +670,13 @@ int32_t Weapon::GetIsWeaponOfChoice(CNWSCreatureStats* pStats, uint32_t nBaseIte
     Weapon& plugin = *g_plugin;
 
 
-    auto w = plugin.m_WeaponOfChoiceMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, WEAPON_OF_CHOICE);
 
-    bApplicableFeatExists = w != plugin.m_WeaponOfChoiceMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -758,19 +731,18 @@ int32_t Weapon::GetMeleeDamageBonus(CNWSCreatureStats* pStats, int32_t bOffHand,
     else
     {
         nBaseItem = pWeapon->m_nBaseItem;
-        auto bStr = pWeapon->nwnxGet<int32_t>("ONE_HALF_STRENGTH");
-        if(bStr && bStr.value())
+        if (plugin.GetOneHalfStrength(pWeapon))
             nBonus += pStats->m_nStrengthModifier/2;
     }
 
 
-    auto w = plugin.m_GreaterWeaponSpecializationMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_SPECIALIZATION);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponSpecializationMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -827,19 +799,18 @@ int32_t Weapon::GetDamageBonus(CNWSCreatureStats* pStats, CNWSCreature *pCreatur
     else
     {
         nBaseItem = pWeapon->m_nBaseItem;
-        auto bStr = pWeapon->nwnxGet<int32_t>("ONE_HALF_STRENGTH");
-        if(bStr && bStr.value())
+        if (plugin.GetOneHalfStrength(pWeapon))
             nBonus += pStats->m_nStrengthModifier/2;
     }
 
 
-    auto w = plugin.m_GreaterWeaponSpecializationMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_SPECIALIZATION);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponSpecializationMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -898,13 +869,13 @@ int32_t Weapon::GetRangedDamageBonus(CNWSCreatureStats* pStats)
         nBaseItem = pWeapon->m_nBaseItem;
     }
 
-    auto w = plugin.m_GreaterWeaponSpecializationMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_SPECIALIZATION);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponSpecializationMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -947,13 +918,13 @@ int32_t Weapon::GetAttackModifierVersus(CNWSCreatureStats* pStats, CNWSCreature*
         nBaseItem = pWeapon->m_nBaseItem;
     }
 
-    auto w = plugin.m_GreaterWeaponFocusMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_FOCUS);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponFocusMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -1040,13 +1011,13 @@ int32_t Weapon::GetMeleeAttackBonus(CNWSCreatureStats* pStats, int32_t bOffHand,
         nBaseItem = pWeapon->m_nBaseItem;
     }
 
-    auto w = plugin.m_GreaterWeaponFocusMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_FOCUS);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponFocusMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -1087,13 +1058,13 @@ int32_t Weapon::GetRangedAttackBonus(CNWSCreatureStats* pStats, int32_t bInclude
 
     nBaseItem = pWeapon->m_nBaseItem;
 
-    auto w = plugin.m_GreaterWeaponFocusMap.find(nBaseItem);
+    auto *pFeats = plugin.GetBaseItemFeats(nBaseItem, GREATER_WEAPON_FOCUS);
 
-    bApplicableFeatExists = w != plugin.m_GreaterWeaponFocusMap.end();
+    bApplicableFeatExists = pFeats != nullptr;
 
     if (bApplicableFeatExists)
     {
-        for (auto feat : w->second)
+        for (auto feat : *pFeats)
         {
             bHasApplicableFeat = (pStats->HasFeat(feat));
 
@@ -1127,10 +1098,15 @@ ArgumentStack Weapon::SetOneHalfStrength(ArgumentStack&& args)
     bool bPersist = !!ScriptAPI::ExtractArgument<int32_t>(args);
 
     auto obj = Utils::GetGameObject(objectId);
+    if (!obj)
+        return ScriptAPI::Arguments();
     if(bMulti)
         obj->nwnxSet("ONE_HALF_STRENGTH", 1, bPersist);
     else
         obj->nwnxRemove("ONE_HALF_STRENGTH");
+    if (auto *pExtension = static_cast<OneHalfStrength*>(POS::GetExtension(obj, GetOneHalfStrengthExtensionId())))
+        pExtension->m_bOneHalfStrength = !!bMulti;
+    MessageBus::Broadcast("NWNX_COMBAT_SIGNAL_MODIFIERS_CHANGED", {});
 
     return ScriptAPI::Arguments();
 }
@@ -1141,10 +1117,7 @@ ArgumentStack Weapon::GetOneHalfStrength(ArgumentStack&& args)
     int32_t retVal = 0;
     if(objectId != Constants::OBJECT_INVALID)
     {
-        auto obj = Utils::GetGameObject(objectId);
-        auto exist = obj->nwnxGet<int32_t>("ONE_HALF_STRENGTH");
-        if(exist)
-            retVal = exist.value();
+        retVal = GetOneHalfStrength(Utils::GetGameObject(objectId));
     }
 
     return ScriptAPI::Arguments(retVal);
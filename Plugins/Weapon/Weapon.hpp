@@ -91,16 +91,35 @@ private:
     static int32_t GetRangedAttackBonus             (CNWSCreatureStats *pStats, int32_t bIncludeBase, int32_t bTouchAttack);
     static int32_t GetAttackModifierVersus          (CNWSCreatureStats *pStats, CNWSCreature* pCreature);
 
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_WeaponFocusMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_EpicWeaponFocusMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_WeaponImprovedCriticalMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_WeaponSpecializationMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_EpicWeaponSpecializationMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_EpicWeaponOverwhelmingCriticalMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_EpicWeaponDevastatingCriticalMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_WeaponOfChoiceMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_GreaterWeaponSpecializationMap;
-    std::map<std::uint32_t, std::set<std::uint32_t>> m_GreaterWeaponFocusMap;
+    enum WeaponFeatType
+    {
+        WEAPON_FOCUS,
+        GREATER_WEAPON_FOCUS,
+        EPIC_WEAPON_FOCUS,
+        IMPROVED_CRITICAL,
+        WEAPON_SPECIALIZATION,
+        GREATER_WEAPON_SPECIALIZATION,
+        EPIC_WEAPON_SPECIALIZATION,
+        OVERWHELMING_CRITICAL,
+        DEVASTATING_CRITICAL,
+        WEAPON_OF_CHOICE,
+        WEAPON_FEAT_TYPE_COUNT
+    };
+
+    struct BaseItemFeats
+    {
+        std::vector<uint16_t> m_Feats[WEAPON_FEAT_TYPE_COUNT];
+    };
+
+    // Indexed by base item.
+    std::vector<BaseItemFeats> m_BaseItemFeats;
+
+    void AddBaseItemFeat(uint32_t nBaseItem, WeaponFeatType type, uint32_t nFeat);
+    // Null if no feats of the type are set for the base item.
+    const std::vector<uint16_t>* GetBaseItemFeats(uint32_t nBaseItem, WeaponFeatType type) const;
+
+    // ONE_HALF_STRENGTH, cached in an object storage extension so it goes away with the item.
+    int32_t GetOneHalfStrength(CGameObject *pObject);
 
     std::set<std::uint32_t>  m_WeaponUnarmedSet;
 
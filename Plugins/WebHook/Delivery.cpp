@@ -0,0 +1,280 @@
+#include "nwnx.hpp"
+#include "Delivery.hpp"
+
+#include <cstdlib>
+
+using namespace NWNXLib;
+using namespace std::chrono;
+
+namespace WebHook {
+
+Delivery::Delivery(const Configuration& config, ResultCallback&& callback)
+    : m_config(config), m_callback(std::move(callback))
+{
+    for (size_t i = 0; i < m_config.m_workers; i++)
+        m_workers.emplace_back(&Delivery::Worker, this);
+}
+
+Delivery::~Delivery()
+{
+    size_t undelivered = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+        for (auto& endpoint : m_endpoints)
+            undelivered += endpoint.second.m_queue.size();
+    }
+    m_cv.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+
+    if (undelivered)
+        LOG_WARNING("Dropping %d webhook messages that were still queued.", undelivered);
+}
+
+void Delivery::Enqueue(Message&& message)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        auto& endpoint = m_endpoints[message.m_host + message.m_path];
+        if (endpoint.m_host.empty())
+        {
+            endpoint.m_host = message.m_host;
+            endpoint.m_path = message.m_path;
+        }
+        endpoint.m_queue.emplace_back(std::move(message));
+    }
+    m_cv.notify_one();
+}
+
+Result Delivery::SendNow(const Message& message)
+{
+    auto client = MakeClient(message.m_host);
+    return MakeResult(message, Post(*client, message.m_path, message.m_body), 1);
+}
+
+void Delivery::Worker()
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+
+    while (!m_stop)
+    {
+        auto wakeAt = Clock::time_point::max();
+        auto* endpoint = NextReadyLocked(Clock::now(), wakeAt);
+        if (!endpoint)
+        {
+            if (wakeAt == Clock::time_point::max())
+                m_cv.wait(lock);
+            else
+                m_cv.wait_until(lock, wakeAt);
+            continue;
+        }
+
+        auto& host = m_hosts[endpoint->m_host];
+        auto client = TakeClientLocked(host, endpoint->m_host);
+        auto batch = TakeBatchLocked(*endpoint);
+        endpoint->m_inFlight = true;
+        endpoint->m_attempts++;
+
+        lock.unlock();
+        const auto body = batch.size() == 1 ? batch.front().m_body : BuildBatchBody(batch);
+        auto res = Post(*client, endpoint->m_path, body);
+        lock.lock();
+
+        host.m_idle.emplace_back(std::move(client));
+        endpoint->m_inFlight = false;
+
+        const auto now = Clock::now();
+        if (res && res->status == 429 && endpoint->m_attempts <= m_config.m_maxRateLimitRetries)
+        {
+            // Rate limited: put everything back where it was and try again once allowed.
+            const auto delay = GetRetryDelay(*res);
+            for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+                endpoint->m_queue.emplace_front(std::move(*it));
+            endpoint->m_blockedUntil = now + delay;
+
+            if (res->get_header_value("X-RateLimit-Global") == "true")
+                host.m_blockedUntil = now + delay;
+
+            LOG_DEBUG("Rate limited on '%s%s', retrying in %dms.", endpoint->m_host, endpoint->m_path, delay.count());
+            m_cv.notify_all();
+            continue;
+        }
+
+        // Don't wait for a 429 if we've already been told the bucket is empty.
+        if (res && res->get_header_value("X-RateLimit-Remaining") == "0")
+            endpoint->m_blockedUntil = now + GetRetryDelay(*res);
+
+        const auto attempts = endpoint->m_attempts;
+        endpoint->m_attempts = 0;
+        m_cv.notify_all();
+
+        lock.unlock();
+        for (auto& message : batch)
+            m_callback(MakeResult(message, res, attempts));
+        lock.lock();
+    }
+}
+
+Delivery::Endpoint* Delivery::NextReadyLocked(Clock::time_point now, Clock::time_point& wakeAt)
+{
+    for (auto& it : m_endpoints)
+    {
+        auto& endpoint = it.second;
+        if (endpoint.m_queue.empty() || endpoint.m_inFlight)
+            continue;
+
+        auto& host = m_hosts[endpoint.m_host];
+        const auto blockedUntil = std::max(endpoint.m_blockedUntil, host.m_blockedUntil);
+        if (blockedUntil > now)
+        {
+            wakeAt = std::min(wakeAt, blockedUntil);
+            continue;
+        }
+
+        if (host.m_idle.empty() && host.m_open >= m_config.m_connectionsPerHost)
+            continue;
+
+        return &endpoint;
+    }
+    return nullptr;
+}
+
+std::vector<Message> Delivery::TakeBatchLocked(Endpoint& endpoint)
+{
+    std::vector<Message> batch;
+    batch.emplace_back(std::move(endpoint.m_queue.front()));
+    endpoint.m_queue.pop_front();
+
+    if (!m_config.m_batch || !batch.front().m_text)
+        return batch;
+
+    // Merge following plain text messages sent as the same user into one post.
+    size_t length = batch.front().m_text->size();
+    while (!endpoint.m_queue.empty())
+    {
+        const auto& next = endpoint.m_queue.front();
+        if (!next.m_text || next.m_username != batch.front().m_username || next.m_mrkdwn != batch.front().m_mrkdwn)
+            break;
+        if (length + 2 + next.m_text->size() > m_config.m_batchMaxLength)
+            break;
+
+        length += 2 + next.m_text->size();
+        batch.emplace_back(std::move(endpoint.m_queue.front()));
+        endpoint.m_queue.pop_front();
+    }
+
+    return batch;
+}
+
+std::unique_ptr<httplib::Client> Delivery::TakeClientLocked(Host& host, const std::string& hostName)
+{
+    if (!host.m_idle.empty())
+    {
+        auto client = std::move(host.m_idle.back());
+        host.m_idle.pop_back();
+        return client;
+    }
+
+    LOG_DEBUG("Opening new connection to host %s.", hostName);
+    host.m_open++;
+    return MakeClient(hostName);
+}
+
+Result Delivery::MakeResult(const Message& message, const httplib::Result& res, uint32_t attempts)
+{
+    Result result;
+    result.m_message = message;
+    result.m_attempts = attempts;
+
+    if (!res)
+    {
+        result.m_failInfo = "Failed to post to server. Is the url correct?";
+        return result;
+    }
+
+    result.m_status = res->status;
+    result.m_success = res->status == 200 || res->status == 201 || res->status == 204;
+
+    if (result.m_success || res->status == 429)
+    {
+        // Discord sends your rate limit information even on success so you can stagger calls if you want.
+        // This header also lets us know it's Discord not Slack, important because Discord sends RETRY_AFTER
+        // in milliseconds and Slack sends it as seconds.
+        if (!res->get_header_value("X-RateLimit-Limit").empty())
+        {
+            result.m_rateLimitLimit = res->get_header_value("X-RateLimit-Limit");
+            result.m_rateLimitRemaining = res->get_header_value("X-RateLimit-Remaining");
+            result.m_rateLimitReset = res->get_header_value("X-RateLimit-Reset");
+            result.m_retryAfter = res->get_header_value("Retry-After");
+        }
+        else if (!res->get_header_value("Retry-After").empty())
+        {
+            const float fSlackRetry = std::strtof(res->get_header_value("Retry-After").c_str(), nullptr) * 1000.0f;
+            result.m_retryAfter = std::to_string(fSlackRetry);
+        }
+    }
+    else
+    {
+        result.m_failInfo = res->body;
+    }
+
+    return result;
+}
+
+std::unique_ptr<httplib::Client> Delivery::MakeClient(const std::string& host)
+{
+    // Plain hosts are https. A scheme can be given explicitly, e.g. http://localhost:8080 for testing.
+    auto client = std::make_unique<httplib::Client>(host.find("://") == std::string::npos ? "https://" + host : host);
+    client->set_keep_alive(true);
+    client->set_connection_timeout(10);
+    client->set_read_timeout(30);
+    client->set_write_timeout(30);
+    return client;
+}
+
+httplib::Result Delivery::Post(httplib::Client& client, const std::string& path, const std::string& body)
+{
+    // For Discord, will wait for a response
+    return client.Post(path + "?wait=true", body, "application/json");
+}
+
+std::string Delivery::BuildBatchBody(const std::vector<Message>& batch)
+{
+    const auto& first = batch.front();
+
+    std::string text = *first.m_text;
+    for (size_t i = 1; i < batch.size(); i++)
+        text += "\\n" + *batch[i].m_text;
+
+    std::string body = R"({"text": ")" + text + "\"";
+    if (!first.m_username.empty())
+        body += R"(, "username": ")" + first.m_username + "\"";
+    if (!first.m_mrkdwn)
+        body += R"(, "mrkdwn": false)";
+    body += "}";
+
+    return String::ToUTF8(body);
+}
+
+milliseconds Delivery::GetRetryDelay(const httplib::Response& res)
+{
+    // Discord: seconds (with fractions) until the bucket resets.
+    const auto resetAfter = res.get_header_value("X-RateLimit-Reset-After");
+    if (!resetAfter.empty())
+        return milliseconds(static_cast<int64_t>(std::strtof(resetAfter.c_str(), nullptr) * 1000.0f));
+
+    const auto retryAfter = res.get_header_value("Retry-After");
+    if (!retryAfter.empty())
+    {
+        const float value = std::strtof(retryAfter.c_str(), nullptr);
+        const bool isDiscord = !res.get_header_value("X-RateLimit-Limit").empty();
+        return milliseconds(static_cast<int64_t>(isDiscord ? value : value * 1000.0f));
+    }
+
+    return seconds(1);
+}
+
+}
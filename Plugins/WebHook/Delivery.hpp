@@ -0,0 +1,123 @@
+#pragma once
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include "External/httplib.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WebHook {
+
+struct Message
+{
+    std::string m_host;
+    std::string m_path;
+    // The JSON that is posted.
+    std::string m_body;
+
+    // Set for plain text messages, which can be batched together.
+    std::optional<std::string> m_text;
+    std::string m_username;
+    bool m_mrkdwn = true;
+};
+
+struct Result
+{
+    Message m_message;
+    // 0 if the server could not be reached at all.
+    int32_t m_status = 0;
+    bool m_success = false;
+    uint32_t m_attempts = 0;
+
+    std::string m_rateLimitLimit;
+    std::string m_rateLimitRemaining;
+    std::string m_rateLimitReset;
+    // In milliseconds.
+    std::string m_retryAfter;
+    std::string m_failInfo;
+};
+
+// Delivers webhook messages on its own worker threads.
+//
+// Messages are queued per endpoint (host + path) and sent in order, one at a
+// time per endpoint, over keep-alive connections pooled per host. When an
+// endpoint gets rate limited the message is put back and the endpoint is
+// parked until the server says it may retry; other endpoints keep going.
+class Delivery
+{
+public:
+    struct Configuration
+    {
+        size_t m_workers;
+        size_t m_connectionsPerHost;
+        bool m_batch;
+        size_t m_batchMaxLength;
+        uint32_t m_maxRateLimitRetries;
+    };
+
+    using ResultCallback = std::function<void(Result&&)>;
+
+    // The callback is called on a worker thread, once per message.
+    Delivery(const Configuration& config, ResultCallback&& callback);
+    ~Delivery();
+
+    void Enqueue(Message&& message);
+
+    // Posts on the calling thread, bypassing the queues. Meant for shutdown.
+    Result SendNow(const Message& message);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Endpoint
+    {
+        std::string m_host;
+        std::string m_path;
+        std::deque<Message> m_queue;
+        Clock::time_point m_blockedUntil;
+        bool m_inFlight = false;
+        uint32_t m_attempts = 0;
+    };
+
+    struct Host
+    {
+        std::vector<std::unique_ptr<httplib::Client>> m_idle;
+        size_t m_open = 0;
+        Clock::time_point m_blockedUntil;
+    };
+
+    void Worker();
+    Endpoint* NextReadyLocked(Clock::time_point now, Clock::time_point& wakeAt);
+    std::vector<Message> TakeBatchLocked(Endpoint& endpoint);
+    std::unique_ptr<httplib::Client> TakeClientLocked(Host& host, const std::string& hostName);
+    Result MakeResult(const Message& message, const httplib::Result& res, uint32_t attempts);
+
+    static std::unique_ptr<httplib::Client> MakeClient(const std::string& host);
+    static httplib::Result Post(httplib::Client& client, const std::string& path, const std::string& body);
+    static std::string BuildBatchBody(const std::vector<Message>& batch);
+    static std::chrono::milliseconds GetRetryDelay(const httplib::Response& res);
+
+    Configuration m_config;
+    ResultCallback m_callback;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+
+    // Keyed by host + path. Never erased, so pointers stay valid.
+    std::unordered_map<std::string, Endpoint> m_endpoints;
+    std::unordered_map<std::string, Host> m_hosts;
+    std::vector<std::thread> m_workers;
+};
+
+}
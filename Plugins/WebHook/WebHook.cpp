@@ -1,9 +1,7 @@
 #include "nwnx.hpp"
 #include "API/CNWSModule.hpp"
-#include "External/httplib.h"
-#include <cmath>
-#include <sstream>
-#include <iomanip>
+#include "Delivery.hpp"
+#include <algorithm>
 
 using namespace NWNXLib;
 
@@ -11,129 +9,115 @@ namespace Core {
 extern bool g_CoreShuttingDown;
 }
 
-static std::string escape_json(const std::string &s) {
-    std::ostringstream o;
-    for (auto c = s.cbegin(); c != s.cend(); c++) {
-        if (*c == '"' || *c == '\\' || ('\x00' <= *c && *c <= '\x1f')) {
-            o << "\\u"
-              << std::hex << std::setw(4) << std::setfill('0') << (int)*c;
-        } else {
-            o << *c;
+static void OnResult(WebHook::Result&& result)
+{
+    Tasks::QueueOnMainThread([result = std::move(result)]()
+    {
+        if (Core::g_CoreShuttingDown)
+            return;
+
+        const auto& message = result.m_message;
+        const auto event = result.m_success ? "NWNX_ON_WEBHOOK_SUCCESS" : "NWNX_ON_WEBHOOK_FAILED";
+        auto moduleOid = NWNXLib::Utils::ObjectIDToString(Utils::GetModule()->m_idSelf);
+
+        // Event name and target, followed by the event data as tag/value pairs.
+        std::vector<std::string> signal = {
+            event, moduleOid,
+            "STATUS", std::to_string(result.m_status),
+            "MESSAGE", message.m_body,
+            "HOST", message.m_host,
+            "PATH", message.m_path,
+        };
+        if (!result.m_rateLimitLimit.empty())
+        {
+            signal.insert(signal.end(), {
+                "RATELIMIT_LIMIT", result.m_rateLimitLimit,
+                "RATELIMIT_REMAINING", result.m_rateLimitRemaining,
+                "RATELIMIT_RESET", result.m_rateLimitReset,
+            });
         }
-    }
-    return o.str();
+        if (!result.m_retryAfter.empty())
+            signal.insert(signal.end(), {"RETRY_AFTER", result.m_retryAfter});
+        if (!result.m_failInfo.empty())
+            signal.insert(signal.end(), {"FAIL_INFO", result.m_failInfo});
+
+        MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", signal);
+
+        if (result.m_success)
+        {
+            LOG_INFO("Sent webhook '%s' to '%s%s'.", message.m_body, message.m_host, message.m_path);
+        }
+        else if (result.m_status == 429)
+        {
+            LOG_WARNING("Failed to send WebHook (HTTPS) message '%s' to '%s%s'. Rate Limited after %d attempts.",
+                        message.m_body, message.m_host, message.m_path, result.m_attempts);
+        }
+        else if (result.m_status)
+        {
+            LOG_WARNING("Failed to send WebHook (HTTPS) message '%s' to '%s%s', status code '%d'.",
+                        message.m_body, message.m_host, message.m_path, result.m_status);
+        }
+        else
+        {
+            LOG_WARNING("Failed to send WebHook (HTTPS) to '%s%s'.", message.m_host, message.m_path);
+        }
+    });
+}
+
+static WebHook::Delivery& GetDelivery()
+{
+    static WebHook::Delivery s_delivery(
+        {
+            static_cast<size_t>(std::max(1, Config::Get<int>("WORKERS", 2))),
+            static_cast<size_t>(std::max(1, Config::Get<int>("CONNECTIONS_PER_HOST", 2))),
+            Config::Get<bool>("BATCH", false),
+            static_cast<size_t>(Config::Get<int>("BATCH_MAX_LENGTH", 2000)),
+            static_cast<uint32_t>(Config::Get<int>("MAX_RATE_LIMIT_RETRIES", 5)),
+        },
+        &OnResult);
+    return s_delivery;
 }
 
 NWNX_EXPORT ArgumentStack SendWebHookHTTPS(ArgumentStack&& args)
 {
-    auto host = args.extract<std::string>();
-    auto origPath = args.extract<std::string>();
+    WebHook::Message msg;
+    msg.m_host = args.extract<std::string>();
+    msg.m_path = args.extract<std::string>();
     auto message = args.extract<std::string>();
-    auto username = args.extract<std::string>();
-    auto mrkdwn = args.extract<int32_t>();
+    msg.m_username = args.extract<std::string>();
+    msg.m_mrkdwn = args.extract<int32_t>();
 
     // If it's just a simple text string, construct the JSON
     if (message.find("\"text\":") == std::string::npos)
     {
+        msg.m_text = message;
         message = R"({"text": ")" + message + "\"";
-        if (!username.empty())
-            message = message + R"(, "username": ")" + username + "\"";
-        if (!mrkdwn)
+        if (!msg.m_username.empty())
+            message = message + R"(, "username": ")" + msg.m_username + "\"";
+        if (!msg.m_mrkdwn)
             message = message +  R"(, "mrkdwn": false)";
         message = message + "}";
     }
 
-    // For Discord, will wait for a response
-    auto path = origPath + "?wait=true";
-
-    message = String::ToUTF8(message);
-    escape_json(message);
-
-    static std::unordered_map<std::string, std::unique_ptr<httplib::SSLClient>> s_ClientCache;
-    auto cli = s_ClientCache.find(host);
-
-    if (cli == std::end(s_ClientCache))
-    {
-        LOG_DEBUG("Creating new SSL client for host %s.", host);
-        cli = s_ClientCache.insert(std::make_pair(host, std::make_unique<httplib::SSLClient>(host.c_str(), 443))).first;
-    }
+    msg.m_body = String::ToUTF8(message);
 
     if (Core::g_CoreShuttingDown)
     {
-        auto res = cli->second->post(path.c_str(), message, "application/json");
+        auto result = GetDelivery().SendNow(msg);
 
-        if (res->status == 200)
+        if (result.m_success)
         {
-            LOG_INFO("Sent webhook '%s' to '%s%s'.", message, host, path);
+            LOG_INFO("Sent webhook '%s' to '%s%s'.", msg.m_body, msg.m_host, msg.m_path);
         }
         else
         {
             LOG_WARNING("Failed to send WebHook (HTTPS) message '%s' to '%s%s', status code '%d'.",
-                        message.c_str(), host.c_str(), path.c_str(), res->status);
+                        msg.m_body, msg.m_host, msg.m_path, result.m_status);
         }
     }
     else
     {
-        Tasks::QueueOnAsyncThread([cli, message, host, path, origPath]()
-        {
-            auto res = cli->second->post(path.c_str(), message, "application/json");
-            Tasks::QueueOnMainThread([message, host, path, origPath, res]()
-            {
-                if (Core::g_CoreShuttingDown)
-                    return;
-
-                auto moduleOid = NWNXLib::Utils::ObjectIDToString(Utils::GetModule()->m_idSelf);
-                if (res)
-                {
-                    MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"STATUS", std::to_string(res->status)});
-                    MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"MESSAGE", message});
-                    MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"HOST", host});
-                    MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"PATH", origPath});
-                    if (res->status == 200 || res->status == 201 || res->status == 204 || res->status == 429)
-                    {
-                        // Discord sends your rate limit information even on success so you can stagger calls if you want
-                        // This header also lets us know it's Discord not Slack, important because Discord sends RETRY_AFTER
-                        // in milliseconds and Slack sends it as seconds.
-                        if (!res->get_header_value("X-RateLimit-Limit").empty())
-                        {
-                            MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"RATELIMIT_LIMIT", res->get_header_value("X-RateLimit-Limit")});
-                            MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"RATELIMIT_REMAINING", res->get_header_value("X-RateLimit-Remaining")});
-                            MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"RATELIMIT_RESET", res->get_header_value("X-RateLimit-Reset")});
-                            if (!res->get_header_value("Retry-After").empty())
-                                MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"RETRY_AFTER", res->get_header_value("Retry-After")});
-                        }
-                            // Slack rate limited
-                        else if (!res->get_header_value("Retry-After").empty())
-                        {
-                            float fSlackRetry = stof(res->get_header_value("Retry-After")) * 1000.0f;
-                            MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"RETRY_AFTER", std::to_string(fSlackRetry)});
-                        }
-                        if (res->status != 429)
-                        {
-                            MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_WEBHOOK_SUCCESS", moduleOid});
-                            LOG_INFO("Sent webhook '%s' to '%s%s'.", message, host, path);
-                        }
-                        else
-                        {
-                            MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_WEBHOOK_FAILED", moduleOid});
-                            LOG_WARNING("Failed to send WebHook (HTTPS) message '%s' to '%s%s'. Rate Limited.", message, host, path);
-                        }
-                    }
-                    else
-                    {
-                        MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"FAIL_INFO", res->body});
-                        MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_WEBHOOK_FAILED", moduleOid});
-                        LOG_WARNING("Failed to send WebHook (HTTPS) message '%s' to '%s%s', status code '%d'.", message, host, path, res->status);
-                    }
-                }
-                else
-                {
-                    MessageBus::Broadcast("NWNX_EVENT_PUSH_EVENT_DATA", {"FAIL_INFO", "Failed to post to server. Is the url correct?"});
-                    MessageBus::Broadcast("NWNX_EVENT_SIGNAL_EVENT", {"NWNX_ON_WEBHOOK_FAILED", moduleOid});
-                    LOG_WARNING("Failed to send WebHook (HTTPS) to '%s%s'.", host, path);
-                }
-            });
-        });
+        GetDelivery().Enqueue(std::move(msg));
     }
     return {};
 }